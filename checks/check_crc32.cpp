@@ -0,0 +1,117 @@
+/* check_crc32.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/CRC32.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Bitwise MPEG-2 CRC32, the reference for the other versions
+static uint32_t calculateBitwise(const unsigned char *data, std::size_t len) {
+	uint32_t crc = mpegts::CRC32::INITIAL;
+	for (std::size_t i = 0; i < len; ++i) {
+		crc ^= static_cast<uint32_t>(data[i]) << 24;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc & 0x80000000) ? (crc << 1) ^ mpegts::CRC32::POLYNOMIAL : (crc << 1);
+		}
+	}
+	return crc;
+}
+
+static int _errors = 0;
+static volatile uint32_t _sink = 0;
+
+static void check(const bool ok, const char *what, const std::size_t len, const std::size_t offset) {
+	if (!ok) {
+		std::printf("FAILED: %s (length %zu offset %zu)\n", what, len, offset);
+		++_errors;
+	}
+}
+
+// Time the CRC of many sections of this length and return MB/s
+template<typename FUNC>
+static double benchmark(FUNC func, const std::vector<unsigned char> &data, const std::size_t len) {
+	const std::size_t rounds = (16 * 1024 * 1024) / len;
+	uint32_t sum = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < rounds; ++i) {
+		sum += func(data.data() + (i % 16), len);
+	}
+	const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+	// Use the sum, so the calls are not optimized away
+	_sink = sum;
+	return (rounds * len) / (time.count() * 1024.0 * 1024.0);
+}
+
+int main() {
+	std::printf("CRC32 check, using %s\n", mpegts::CRC32::getImplementationName());
+
+	// Known value of the MPEG-2 CRC32
+	const unsigned char known[] = "123456789";
+	check(mpegts::CRC32::calculate(known, 9) == 0x0376E6E7, "known value", 9, 0);
+
+	// Every length of a PSI section (up to 4096 bytes) at every alignment of
+	// 16 bytes, with random data, all zeros and all ones
+	std::mt19937 random(188);
+	std::vector<unsigned char> data(4096 + 16);
+	for (const int fill : {-1, 0x00, 0xFF}) {
+		for (unsigned char &byte : data) {
+			byte = (fill == -1) ? static_cast<unsigned char>(random()) : static_cast<unsigned char>(fill);
+		}
+		for (std::size_t offset = 0; offset < 16; ++offset) {
+			for (std::size_t len = 0; len <= 4096; ++len) {
+				const unsigned char *ptr = data.data() + offset;
+				const uint32_t crc = calculateBitwise(ptr, len);
+				check(mpegts::CRC32::calculate(ptr, len) == crc, "selected version", len, offset);
+				check(mpegts::CRC32::calculateSliceBy8(mpegts::CRC32::INITIAL, ptr, len) == crc,
+					"slice-by-8", len, offset);
+			}
+		}
+	}
+
+	// A section with its CRC appended should give a CRC of 0
+	for (std::size_t len = 0; len <= 1021; ++len) {
+		std::vector<unsigned char> section(data.begin(), data.begin() + len);
+		const uint32_t crc = mpegts::CRC32::calculate(section.data(), len);
+		section.push_back(crc >> 24);
+		section.push_back(crc >> 16);
+		section.push_back(crc >> 8);
+		section.push_back(crc);
+		check(mpegts::CRC32::calculate(section.data(), section.size()) == 0, "section with CRC", len, 0);
+	}
+
+	if (_errors != 0) {
+		std::printf("CRC32 check FAILED with %d errors\n", _errors);
+		return 1;
+	}
+	std::printf("CRC32 check OK\n");
+
+	// Benchmark for typical section sizes
+	const auto sliceBy8 = [](const unsigned char *ptr, const std::size_t len) {
+		return mpegts::CRC32::calculateSliceBy8(mpegts::CRC32::INITIAL, ptr, len);
+	};
+	for (const std::size_t len : {32, 184, 1024, 4096}) {
+		std::printf("  %4zu bytes: bitwise %8.1f MB/s  slice-by-8 %8.1f MB/s  %s %8.1f MB/s\n", len,
+			benchmark(calculateBitwise, data, len), benchmark(sliceBy8, data, len),
+			mpegts::CRC32::getImplementationName(), benchmark(mpegts::CRC32::calculate, data, len));
+	}
+	return 0;
+}
@@ -0,0 +1,128 @@
+/* check_dvrreadbuffer.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/dvb/DVRReadBuffer.h>
+#include <mpegts/PacketBuffer.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static constexpr std::size_t TS_PACKET_SIZE = mpegts::PacketBuffer::TS_PACKET_SIZE;
+/// TS packets written into the pipe at once, like a DVR that has data queued
+static constexpr std::size_t PACKETS_QUEUED = 300;
+
+static int _errors = 0;
+
+static void check(const bool ok, const char *what) {
+	std::printf("%s: %s\n", ok ? "OK    " : "FAILED", what);
+	if (!ok) {
+		++_errors;
+	}
+}
+
+/// Write TS packets with a running counter in the payload into the pipe
+static bool writePackets(const int fd, const std::size_t first, const std::size_t count) {
+	std::vector<unsigned char> data(count * TS_PACKET_SIZE, 0xFF);
+	for (std::size_t i = 0; i < count; ++i) {
+		unsigned char *ts = &data[i * TS_PACKET_SIZE];
+		ts[0] = 0x47;
+		const std::size_t n = first + i;
+		std::memcpy(ts + 4, &n, sizeof(n));
+	}
+	return ::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+}
+
+/// Check the TS packets in the buffer carry the counter starting at first
+static bool checkPackets(const mpegts::PacketBuffer &buffer, const std::size_t first) {
+	for (std::size_t i = 0; i < buffer.getNumberOfCompletedPackets(); ++i) {
+		const unsigned char *ts = buffer.getTSPacketPtr(i);
+		std::size_t n;
+		std::memcpy(&n, ts + 4, sizeof(n));
+		if (ts[0] != 0x47 || n != first + i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main() {
+	int fds[2];
+	if (::pipe2(fds, O_NONBLOCK) != 0) {
+		std::printf("DVR read buffer check FAILED, no pipe\n");
+		return 1;
+	}
+	input::dvb::DVRReadBuffer readBuffer;
+	readBuffer.setSize(256 * 1024);
+	mpegts::PacketBuffer buffer;
+	buffer.initialize(0, 0);
+	const std::size_t bufferPackets = buffer.getMaxNumberOfTSPackets();
+
+	// Nothing queued, so nothing is read
+	check(readBuffer.refill(fds[0]) < 0 && errno == EAGAIN && readBuffer.available() == 0,
+		"Empty DVR gives nothing");
+
+	// With data queued one read takes all of it, not one PacketBuffer
+	check(writePackets(fds[1], 0, PACKETS_QUEUED), "Packets written");
+	check(readBuffer.refill(fds[0]) == PACKETS_QUEUED * TS_PACKET_SIZE,
+		"One read drains all the queued data");
+	check(readBuffer.getBytesPerRead() > buffer.getMaxBufferSize(),
+		"Bytes per read is more then one PacketBuffer");
+
+	// The PacketBuffers are filled from the read buffer without reading again
+	std::size_t next = 0;
+	bool ordered = true;
+	while (readBuffer.available() >= buffer.getAmountOfBytesToWrite()) {
+		readBuffer.fill(buffer);
+		ordered = ordered && buffer.full() && checkPackets(buffer, next);
+		next += bufferPackets;
+		buffer.reset();
+	}
+	check(ordered, "PacketBuffers are filled in order");
+	check(readBuffer.getReadCalls() == 1, "PacketBuffers are filled without reading again");
+
+	// The partial rest is kept in front of the next read
+	const std::size_t rest = readBuffer.available();
+	check(rest == (PACKETS_QUEUED % bufferPackets) * TS_PACKET_SIZE, "Partial rest is kept");
+	check(writePackets(fds[1], PACKETS_QUEUED, PACKETS_QUEUED), "Packets written again");
+	readBuffer.setSize(512 * 1024);
+	check(readBuffer.refill(fds[0]) == PACKETS_QUEUED * TS_PACKET_SIZE &&
+		readBuffer.available() == rest + PACKETS_QUEUED * TS_PACKET_SIZE,
+		"Refill reads behind the partial rest");
+	readBuffer.fill(buffer);
+	check(buffer.full() && checkPackets(buffer, next), "Partial rest continues in the next PacketBuffer");
+	std::printf("Bytes per read: %llu\n", static_cast<unsigned long long>(readBuffer.getBytesPerRead()));
+
+	// Clear drops the data read ahead
+	readBuffer.clear();
+	check(readBuffer.available() == 0, "Clear drops the data read ahead");
+
+	::close(fds[0]);
+	::close(fds[1]);
+	if (_errors != 0) {
+		std::printf("DVR read buffer check FAILED with %d errors\n", _errors);
+		return 1;
+	}
+	std::printf("DVR read buffer check OK\n");
+	return 0;
+}
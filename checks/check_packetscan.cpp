@@ -0,0 +1,183 @@
+/* check_packetscan.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/PacketBuffer.h>
+#include <mpegts/PacketScan.h>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using mpegts::PacketScan;
+
+static constexpr std::size_t TS_SIZE = mpegts::PacketBuffer::TS_PACKET_SIZE;
+static constexpr std::size_t MAX_PACKETS = mpegts::PacketBuffer::MAX_NUMBER_OF_TS_PACKETS;
+
+static int _errors = 0;
+
+static void check(const bool ok, const char *what, const std::size_t size, const std::size_t offset) {
+	if (!ok) {
+		std::printf("FAILED: %s (size %zu offset %zu)\n", what, size, offset);
+		++_errors;
+	}
+}
+
+static bool sameMasks(const PacketScan::HeaderMasks &a, const PacketScan::HeaderMasks &b) {
+	return a.scrambled == b.scrambled && a.marked == b.marked;
+}
+
+/// Check the selected findSync against the scalar one for every size and
+/// alignment of the data
+static void checkFindSync(const std::vector<unsigned char> &data, const std::size_t maxSize,
+		const char *what) {
+	for (std::size_t offset = 0; offset < 32; ++offset) {
+		for (std::size_t size = 0; size <= maxSize && offset + size <= data.size(); ++size) {
+			const unsigned char *ptr = data.data() + offset;
+			check(PacketScan::findSync(ptr, size) == PacketScan::findSyncScalar(ptr, size),
+				what, size, offset);
+		}
+	}
+}
+
+/// Check the selected getHeaderMasks against the scalar one for every
+/// amount of packets and alignment of the data
+static void checkHeaderMasks(const std::vector<unsigned char> &data, const char *what) {
+	for (std::size_t offset = 0; offset < 32; ++offset) {
+		for (std::size_t packets = 0; packets <= MAX_PACKETS; ++packets) {
+			const unsigned char *ptr = data.data() + offset;
+			check(sameMasks(PacketScan::getHeaderMasks(ptr, packets),
+				PacketScan::getHeaderMasksScalar(ptr, packets)), what, packets, offset);
+		}
+	}
+}
+
+int main() {
+	std::printf("Packet scan check, using %s\n", PacketScan::getImplementationName());
+	std::mt19937 random(188);
+	std::vector<unsigned char> data((MAX_PACKETS + 1) * TS_SIZE + 32);
+
+	// Random data, and data where every other byte is a sync byte so there
+	// are many false candidates that fail on the second or third sync byte
+	for (unsigned char &byte : data) {
+		byte = static_cast<unsigned char>(random());
+	}
+	checkFindSync(data, 4 * TS_SIZE, "findSync random data");
+	for (unsigned char &byte : data) {
+		byte = (random() % 2 == 0) ? 0x47 : static_cast<unsigned char>(random());
+	}
+	checkFindSync(data, 4 * TS_SIZE, "findSync many sync bytes");
+
+	// A TS stream that starts at a random offset, with false sync bytes in
+	// the payload before it that are only one TS packet apart
+	for (int round = 0; round < 64; ++round) {
+		for (unsigned char &byte : data) {
+			byte = static_cast<unsigned char>(random() % 0x47);
+		}
+		const std::size_t start = random() % (2 * TS_SIZE);
+		for (std::size_t i = start; i < data.size(); i += TS_SIZE) {
+			data[i] = 0x47;
+		}
+		for (std::size_t i = 0; i < TS_SIZE && i < start; i += 7) {
+			if (i % TS_SIZE != start % TS_SIZE) {
+				data[i] = 0x47;
+				data[i + TS_SIZE] = 0x47;
+			}
+		}
+		check(PacketScan::findSync(data.data(), data.size()) == start, "findSync finds the TS stream",
+			data.size(), start);
+		checkFindSync(data, 4 * TS_SIZE, "findSync false sync bytes");
+	}
+
+	// Partial tails, the last sync byte of the three is just in or out of the data
+	std::vector<unsigned char> tail(3 * TS_SIZE + 64, 0x00);
+	for (std::size_t start = 0; start < 64; ++start) {
+		std::fill(tail.begin(), tail.end(), 0x00);
+		tail[start] = tail[start + TS_SIZE] = tail[start + 2 * TS_SIZE] = 0x47;
+		for (const std::size_t size : {start + 2 * TS_SIZE, start + 2 * TS_SIZE + 1, tail.size()}) {
+			check(PacketScan::findSync(tail.data(), size) == PacketScan::findSyncScalar(tail.data(), size),
+				"findSync partial tail", size, start);
+		}
+	}
+
+	// Headers with the scramble bits and purge marks mixed
+	for (int round = 0; round < 16; ++round) {
+		for (unsigned char &byte : data) {
+			byte = static_cast<unsigned char>(random());
+		}
+		for (std::size_t i = 0; i + 4 <= data.size(); ++i) {
+			// Set sync bytes and marks at every possible alignment
+			if (random() % 4 == 0) {
+				data[i] = 0x47;
+			}
+			if (random() % 3 == 0) {
+				data[i] = 0xFF;
+			}
+		}
+		checkHeaderMasks(data, "getHeaderMasks scrambled and marked mix");
+	}
+	std::fill(data.begin(), data.end(), 0xFF);
+	checkHeaderMasks(data, "getHeaderMasks all marked and scrambled");
+	std::fill(data.begin(), data.end(), 0x00);
+	checkHeaderMasks(data, "getHeaderMasks nothing marked");
+
+	// Purge keeps the order of the packets that stay and the partial packet at the end
+	for (int round = 0; round < 256; ++round) {
+		mpegts::PacketBuffer buffer;
+		buffer.initialize(0, 0);
+		buffer.setNumberOfTSPackets(MAX_PACKETS);
+		const std::size_t packets = 1 + (random() % MAX_PACKETS);
+		const std::size_t partial = (packets < MAX_PACKETS) ? (random() % TS_SIZE) : 0;
+		for (std::size_t i = 0; i < packets; ++i) {
+			unsigned char *ts = buffer.getWriteBufferPtr();
+			std::memset(ts, static_cast<int>(i), TS_SIZE);
+			ts[0] = 0x47;
+			ts[1] = 0x00;
+			buffer.addAmountOfBytesWritten(TS_SIZE);
+		}
+		std::memset(buffer.getWriteBufferPtr(), 0xAA, partial);
+		buffer.addAmountOfBytesWritten(partial);
+		std::vector<std::size_t> kept;
+		for (std::size_t i = 0; i < packets; ++i) {
+			if (random() % 3 == 0) {
+				buffer.markTSForPurging(i);
+			} else {
+				kept.push_back(i);
+			}
+		}
+		buffer.purge();
+		bool ok = buffer.getCurrentBufferSize() == kept.size() * TS_SIZE + partial;
+		for (std::size_t i = 0; ok && i < kept.size(); ++i) {
+			const unsigned char *ts = buffer.getTSPacketPtr(i);
+			ok = ts[0] == 0x47 && ts[1] == 0x00 && ts[2] == kept[i] && ts[TS_SIZE - 1] == kept[i];
+		}
+		const unsigned char *end = buffer.getTSPacketPtr(0) + kept.size() * TS_SIZE;
+		for (std::size_t i = 0; ok && i < partial; ++i) {
+			ok = end[i] == 0xAA;
+		}
+		check(ok, "purge compaction", packets, partial);
+	}
+
+	if (_errors != 0) {
+		std::printf("Packet scan check FAILED with %d errors\n", _errors);
+		return 1;
+	}
+	std::printf("Packet scan check OK\n");
+	return 0;
+}
@@ -0,0 +1,166 @@
+/* check_pcr.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/PacketBuffer.h>
+#include <mpegts/PCR.h>
+#include <mpegts/PCRTracker.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using Clock = mpegts::PCR::Clock;
+using TSPacket = std::vector<unsigned char>;
+
+/// PCR interval of the synthetic streams, 40ms in 27MHz ticks
+static constexpr std::uint64_t PCR_INTERVAL = mpegts::PCR::CLOCK_FREQUENCY / 25;
+static constexpr Clock::duration INTERVAL = std::chrono::milliseconds(40);
+
+static int _errors = 0;
+
+static void check(const bool ok, const char *what) {
+	std::printf("%s: %s\n", ok ? "OK    " : "FAILED", what);
+	if (!ok) {
+		++_errors;
+	}
+}
+
+/// Check the deadline is within 1us of the expected time
+static bool isNear(const Clock::time_point deadline, const Clock::time_point expected) {
+	return std::abs(std::chrono::duration_cast<std::chrono::microseconds>(deadline - expected).count()) <= 1;
+}
+
+/// Make a TS packet with only an adaptation field carrying this PCR
+static TSPacket makePCRPacket(const int pid, const std::uint64_t pcr, const bool discontinuity) {
+	TSPacket ts(mpegts::PacketBuffer::TS_PACKET_SIZE, 0xFF);
+	const std::uint64_t base = pcr / 300;
+	const std::uint64_t ext = pcr % 300;
+	ts[0] = 0x47;
+	ts[1] = (pid >> 8) & 0x1F;
+	ts[2] = pid & 0xFF;
+	ts[3] = 0x20;
+	ts[4] = 183;
+	ts[5] = 0x10 | (discontinuity ? 0x80 : 0x00);
+	ts[6] = (base >> 25) & 0xFF;
+	ts[7] = (base >> 17) & 0xFF;
+	ts[8] = (base >>  9) & 0xFF;
+	ts[9] = (base >>  1) & 0xFF;
+	ts[10] = ((base & 0x01) << 7) | 0x7E | ((ext >> 8) & 0x01);
+	ts[11] = ext & 0xFF;
+	return ts;
+}
+
+int main() {
+	mpegts::PCR pcr;
+	Clock::time_point deadline;
+	const Clock::time_point start = Clock::now();
+
+	// Steady PCRs that wrap around halfway, the deadlines should follow the PCRs
+	std::uint64_t value = mpegts::PCR::WRAP_AROUND - 10 * PCR_INTERVAL;
+	Clock::time_point arrival = start;
+	bool steady = true;
+	for (int i = 0; i < 20; ++i) {
+		pcr.addPCR(0x100, value, false, arrival);
+		steady = steady && pcr.getNextDeadline(deadline) && isNear(deadline, start + i * INTERVAL);
+		value = (value + PCR_INTERVAL) % mpegts::PCR::WRAP_AROUND;
+		arrival += INTERVAL;
+	}
+	check(steady, "Deadlines follow the PCRs over the wrap around");
+	check(pcr.getDiscontinuities() == 0, "Wrap around is no discontinuity");
+	check(!pcr.getNextDeadline(deadline), "Deadline is only returned once");
+
+	// Arrival jitter should not change the deadlines
+	bool jitter = true;
+	for (int i = 20; i < 40; ++i) {
+		const Clock::duration offset = std::chrono::milliseconds((i % 2 == 0) ? 5 : -5);
+		pcr.addPCR(0x100, value, false, arrival + offset);
+		jitter = jitter && pcr.getNextDeadline(deadline) && isNear(deadline, start + i * INTERVAL);
+		value = (value + PCR_INTERVAL) % mpegts::PCR::WRAP_AROUND;
+		arrival += INTERVAL;
+	}
+	check(jitter, "Arrival jitter does not change the deadlines");
+
+	// An other PCR PID is ignored while the locked one is there
+	pcr.addPCR(0x200, 12345, false, arrival);
+	check(!pcr.getNextDeadline(deadline) && pcr.getPCRPID() == 0x100, "PCRs of an other PID are ignored");
+
+	// Reading stalled for 2s, so the deadline is anchored again to the arrival
+	arrival += std::chrono::seconds(2);
+	pcr.addPCR(0x100, value, false, arrival);
+	check(pcr.getNextDeadline(deadline) && isNear(deadline, arrival), "Stalled reading anchors again");
+	check(pcr.getDiscontinuities() == 0, "Stalled reading is no discontinuity");
+	value = (value + PCR_INTERVAL) % mpegts::PCR::WRAP_AROUND;
+
+	// Discontinuity indicator with a PCR jump, the time line continues
+	arrival += INTERVAL;
+	pcr.addPCR(0x100, 1000000, true, arrival);
+	check(pcr.getNextDeadline(deadline) && isNear(deadline, arrival), "Discontinuity keeps the deadline at the arrival");
+	check(pcr.getDiscontinuities() == 1, "Discontinuity indicator is counted");
+	arrival += INTERVAL;
+	pcr.addPCR(0x100, 1000000 + PCR_INTERVAL, false, arrival);
+	check(pcr.getNextDeadline(deadline) && isNear(deadline, arrival), "Deadlines continue after the discontinuity");
+
+	// PCR gap of 1s without the discontinuity indicator
+	arrival += INTERVAL;
+	pcr.addPCR(0x100, 1000000 + PCR_INTERVAL + mpegts::PCR::CLOCK_FREQUENCY, false, arrival);
+	check(pcr.getDiscontinuities() == 2, "PCR gap of more then 500ms is a discontinuity");
+
+	// Locked PID gone for more then 1s, lock onto the other PCR PID
+	arrival += std::chrono::milliseconds(1500);
+	pcr.addPCR(0x200, 5000000, false, arrival);
+	check(pcr.getPCRPID() == 0x200, "Lost PCR PID is replaced by the next one");
+	check(pcr.getNextDeadline(deadline) && isNear(deadline, arrival), "New PCR PID anchors at the arrival");
+	check(pcr.getDiscontinuities() == 3, "Changing the PCR PID is a discontinuity");
+	arrival += INTERVAL;
+	pcr.addPCR(0x200, 5000000 + PCR_INTERVAL, false, arrival);
+	check(pcr.getNextDeadline(deadline) && isNear(deadline, arrival), "Deadlines follow the new PCR PID");
+
+	// TS packets with the PCR in the adaptation field
+	const std::uint64_t tsPCR = (UINT64_C(1) << 32) * 300 + 299;
+	const TSPacket ts = makePCRPacket(0x300, tsPCR, true);
+	check(mpegts::PCR::isPCRTableData(ts.data()) && mpegts::PCR::getPCRValue(ts.data()) == tsPCR,
+		"PCR is read from the adaptation field");
+	check(mpegts::PCR::isDiscontinuity(ts.data()), "Discontinuity indicator is read from the adaptation field");
+	pcr.reset();
+	check(pcr.getPCRPID() == -1 && pcr.getDiscontinuities() == 0, "Reset forgets the PCR PID");
+	pcr.collectData(FeID(), ts.data());
+	check(pcr.getPCRPID() == 0x300 && pcr.getNextDeadline(deadline), "Collected PCR locks the PID");
+
+	// The shared PCR PID lock of the clock, pacer and RTP timestamps
+	mpegts::PCRTracker tracker;
+	using Result = mpegts::PCRTracker::Result;
+	check(tracker.addPCR(0x100, mpegts::PCR::WRAP_AROUND - PCR_INTERVAL, false, start) == Result::Locked,
+		"Tracker locks onto the first PCR PID");
+	check(tracker.addPCR(0x200, 0, false, start + INTERVAL) == Result::Ignored, "Tracker ignores an other PID");
+	check(tracker.addPCR(0x100, PCR_INTERVAL, false, start + INTERVAL) == Result::Continuous &&
+		tracker.getDelta() == 2 * PCR_INTERVAL, "Tracker gives the delta over the wrap around");
+	check(tracker.addPCR(0x100, 2 * PCR_INTERVAL, true, start + 2 * INTERVAL) == Result::Discontinuous,
+		"Tracker reports the discontinuity indicator");
+	check(!tracker.checkTimeout(start + std::chrono::seconds(1)) &&
+		tracker.checkTimeout(start + std::chrono::seconds(2)) && tracker.getPID() == -1,
+		"Tracker unlocks the PID after the timeout");
+
+	if (_errors != 0) {
+		std::printf("PCR check FAILED with %d errors\n", _errors);
+		return 1;
+	}
+	std::printf("PCR check OK\n");
+	return 0;
+}
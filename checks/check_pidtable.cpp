@@ -0,0 +1,169 @@
+/* check_pidtable.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/PidTable.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using mpegts::PidTable;
+
+/// Reference of the PID states, the way the demux sees them
+enum class State {
+	Closed,
+	ShouldOpen,
+	Opened,
+	ShouldClose,
+	ShouldCloseReopen
+};
+
+static int _errors = 0;
+static volatile std::size_t _sink = 0;
+
+static void check(const bool ok, const char *what) {
+	std::printf("%s: %s\n", ok ? "OK    " : "FAILED", what);
+	if (!ok) {
+		++_errors;
+	}
+}
+
+/// Check the PID in the table is in this state
+static bool isState(const PidTable &table, const int pid, const State state) {
+	return table.isPIDOpened(pid) == (state == State::Opened) &&
+		table.shouldPIDOpen(pid) == (state == State::ShouldOpen) &&
+		table.shouldPIDClose(pid) == (state == State::ShouldClose || state == State::ShouldCloseReopen) &&
+		table.isPIDRequested(pid) == (state == State::Opened || state == State::ShouldOpen);
+}
+
+/// Reference of PidTable::setPID
+static State setPID(const State state, const bool use) {
+	switch (state) {
+		case State::Closed:
+			return use ? State::ShouldOpen : state;
+		case State::ShouldClose:
+			return use ? State::ShouldCloseReopen : state;
+		case State::Opened:
+			return use ? state : State::ShouldClose;
+		default:
+			return state;
+	}
+}
+
+int main() {
+	PidTable table;
+	const int pid = 0x100;
+
+	// One PID through all transitions
+	check(isState(table, pid, State::Closed) && table.getNumberOfRequestedPIDs() == 0, "PID starts closed");
+	table.setPID(pid, true);
+	check(isState(table, pid, State::ShouldOpen) && table.hasPIDTableChanged(), "Closed -> ShouldOpen");
+	table.setPIDOpened(pid);
+	check(isState(table, pid, State::Opened) && table.getNumberOfRequestedPIDs() == 1, "ShouldOpen -> Opened");
+	table.setPID(pid, false);
+	check(isState(table, pid, State::ShouldClose) && table.getNumberOfRequestedPIDs() == 0, "Opened -> ShouldClose");
+	table.setPID(pid, true);
+	check(isState(table, pid, State::ShouldCloseReopen), "ShouldClose -> ShouldCloseReopen");
+	table.setPIDClosed(pid);
+	check(isState(table, pid, State::ShouldOpen), "ShouldCloseReopen -> ShouldOpen when closed");
+	table.setPIDOpened(pid);
+	table.setPID(pid, false);
+	table.setPIDClosed(pid);
+	check(isState(table, pid, State::Closed), "ShouldClose -> Closed when closed");
+
+	// Clear closes the opened PIDs later and forgets the ones not opened yet
+	table.setPID(pid, true);
+	table.setPIDOpened(pid);
+	table.setPID(pid + 1, true);
+	table.clear();
+	check(isState(table, pid, State::ShouldClose) && isState(table, pid + 1, State::Closed),
+		"Clear marks the opened PID to close and forgets the other");
+	table.setPIDClosed(pid);
+
+	// Reopen opens the opened PIDs again, on a new demux
+	table.setPID(pid, true);
+	table.setPIDOpened(pid);
+	table.resetPIDTableChanged();
+	table.reopenPIDs();
+	check(isState(table, pid, State::ShouldOpen) && table.hasPIDTableChanged(), "Reopen Opened -> ShouldOpen");
+
+	// Random operations against the reference, the bitsets of the table
+	// should stay in sync with its states
+	std::vector<State> states(PidTable::MAX_PIDS, State::Closed);
+	PidTable fuzz;
+	std::mt19937 random(188);
+	bool inSync = true;
+	for (int i = 0; i < 200000 && inSync; ++i) {
+		const int p = random() % PidTable::MAX_PIDS;
+		State &state = states[p];
+		switch (random() % 4) {
+			case 0:
+				fuzz.setPID(p, true);
+				state = setPID(state, true);
+				break;
+			case 1:
+				fuzz.setPID(p, false);
+				state = setPID(state, false);
+				break;
+			case 2:
+				if (fuzz.shouldPIDOpen(p)) {
+					fuzz.setPIDOpened(p);
+					state = State::Opened;
+				}
+				break;
+			default:
+				if (fuzz.shouldPIDClose(p)) {
+					fuzz.setPIDClosed(p);
+					state = (state == State::ShouldCloseReopen) ? State::ShouldOpen : State::Closed;
+				}
+				break;
+		}
+		inSync = isState(fuzz, p, state);
+	}
+	std::size_t requested = 0;
+	for (int p = 0; p < PidTable::MAX_PIDS; ++p) {
+		inSync = inSync && isState(fuzz, p, states[p]);
+		requested += (states[p] == State::Opened || states[p] == State::ShouldOpen) ? 1 : 0;
+	}
+	check(inSync, "Bitsets stay in sync with the states");
+	check(fuzz.getNumberOfRequestedPIDs() == requested, "Number of requested PIDs follows the states");
+
+	if (_errors != 0) {
+		std::printf("PidTable check FAILED with %d errors\n", _errors);
+		return 1;
+	}
+	std::printf("PidTable check OK\n");
+
+	// Benchmark of the lookup done for every TS packet
+	const std::size_t rounds = 4096;
+	std::size_t opened = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < rounds; ++i) {
+		for (int p = 0; p < PidTable::ALL_PIDS; ++p) {
+			opened += fuzz.isPIDOpened(p) ? 1 : 0;
+		}
+	}
+	const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+	// Use the sum, so the lookups are not optimized away
+	_sink = opened;
+	std::printf("  isPIDOpened %8.1f M lookups/s\n",
+		(rounds * PidTable::ALL_PIDS) / (time.count() * 1000.0 * 1000.0));
+	return 0;
+}
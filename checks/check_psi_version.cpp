@@ -0,0 +1,163 @@
+/* check_psi_version.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/CRC32.h>
+#include <mpegts/Filter.h>
+#include <mpegts/PacketBuffer.h>
+#include <mpegts/PAT.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using TSPacket = std::vector<unsigned char>;
+
+static int _errors = 0;
+
+static void check(const bool ok, const char *what) {
+	std::printf("%s: %s\n", ok ? "OK    " : "FAILED", what);
+	if (!ok) {
+		++_errors;
+	}
+}
+
+/// Make a TS packet with one PSI section that starts directly after the pointer field
+static TSPacket makeSection(const int pid, const int cc, const int tableID, const int tableIDExt,
+		const int version, const std::vector<unsigned char> &body) {
+	TSPacket ts(mpegts::PacketBuffer::TS_PACKET_SIZE, 0xFF);
+	const std::size_t sectionLength = 5 + body.size() + 4;
+	ts[0] = 0x47;
+	ts[1] = 0x40 | ((pid >> 8) & 0x1F);
+	ts[2] = pid & 0xFF;
+	ts[3] = 0x10 | (cc & 0x0F);
+	ts[4] = 0x00;
+	ts[5] = tableID;
+	ts[6] = 0xB0 | ((sectionLength >> 8) & 0x0F);
+	ts[7] = sectionLength & 0xFF;
+	ts[8] = (tableIDExt >> 8) & 0xFF;
+	ts[9] = tableIDExt & 0xFF;
+	ts[10] = 0xC1 | ((version & 0x1F) << 1);
+	ts[11] = 0x00;
+	ts[12] = 0x00;
+	std::memcpy(&ts[13], body.data(), body.size());
+	const std::size_t crcIndex = 13 + body.size();
+	const uint32_t crc = mpegts::CRC32::calculate(&ts[5], crcIndex - 5);
+	ts[crcIndex + 0] = (crc >> 24) & 0xFF;
+	ts[crcIndex + 1] = (crc >> 16) & 0xFF;
+	ts[crcIndex + 2] = (crc >>  8) & 0xFF;
+	ts[crcIndex + 3] = crc & 0xFF;
+	return ts;
+}
+
+static TSPacket makePAT(const int cc, const int version, const mpegts::PAT::ProgramMap &programs) {
+	const mpegts::TSData pat = mpegts::PAT::generatePacket(1, version, cc, programs);
+	return TSPacket(pat.begin(), pat.end());
+}
+
+static TSPacket makePMT(const int pid, const int cc, const int programNumber, const int version,
+		const int pcrPID, const int esPID) {
+	return makeSection(pid, cc, mpegts::TableData::PMT_ID, programNumber, version, {
+		static_cast<unsigned char>(0xE0 | (pcrPID >> 8)), static_cast<unsigned char>(pcrPID & 0xFF),
+		0xF0, 0x00,
+		0x02, static_cast<unsigned char>(0xE0 | (esPID >> 8)), static_cast<unsigned char>(esPID & 0xFF),
+		0xF0, 0x00});
+}
+
+/// Feed the packets to the filter, as one buffer
+static void feed(mpegts::Filter &filter, const std::vector<TSPacket> &packets) {
+	mpegts::PacketBuffer buffer;
+	buffer.initialize(0, 0);
+	buffer.setNumberOfTSPackets(packets.size());
+	for (const TSPacket &ts : packets) {
+		std::memcpy(buffer.getWriteBufferPtr(), ts.data(), ts.size());
+		buffer.addAmountOfBytesWritten(ts.size());
+	}
+	filter.filterData(FeID(0), buffer, false);
+}
+
+/// Get the version of the collected table on this PID or -1
+static int getVersion(const mpegts::Filter &filter, const int pid) {
+	mpegts::PSICache::Tables tables;
+	filter.getPSITables(tables);
+	const auto table = tables.find(pid);
+	if (table == tables.end() || table->second.size() < 11) {
+		return -1;
+	}
+	return (table->second[10] >> 1) & 0x1F;
+}
+
+/// Get the elementary PID of the collected PMT on this PID or -1
+static int getESPID(const mpegts::Filter &filter, const int pid) {
+	mpegts::PSICache::Tables tables;
+	filter.getPSITables(tables);
+	const auto table = tables.find(pid);
+	if (table == tables.end() || table->second.size() < 20) {
+		return -1;
+	}
+	return ((table->second[18] & 0x1F) << 8) | table->second[19];
+}
+
+int main() {
+	mpegts::Filter filter;
+	for (const int pid : {0, 0x100, 0x200}) {
+		filter.setPID(pid, true);
+	}
+	filter.updatePIDFilters(FeID(0), [](int) { return true; }, [](int) { return true; });
+
+	// Program 1 on PMT PID 0x100 and program 2 on PMT PID 0x200
+	feed(filter, {
+		makePAT(0, 0, {{1, 0x100}, {2, 0x200}}),
+		makePMT(0x100, 0, 1, 0, 0x101, 0x101),
+		makePMT(0x200, 0, 2, 0, 0x201, 0x201)});
+	check(getVersion(filter, 0) == 0, "PAT version 0 collected");
+	check(getVersion(filter, 0x100) == 0 && getVersion(filter, 0x200) == 0, "PMT of both programs collected");
+
+	// The same versions again should not change anything
+	feed(filter, {
+		makePAT(1, 0, {{1, 0x100}, {2, 0x200}}),
+		makePMT(0x100, 1, 1, 0, 0x101, 0x101)});
+	check(getVersion(filter, 0) == 0 && getVersion(filter, 0x100) == 0 &&
+		getESPID(filter, 0x100) == 0x101, "Same versions are kept");
+
+	// PMT version bump with an other elementary PID
+	feed(filter, {makePMT(0x100, 2, 1, 1, 0x101, 0x102)});
+	check(getVersion(filter, 0x100) == 1 && getESPID(filter, 0x100) == 0x102, "PMT version 1 replaces version 0");
+
+	// PAT version bump without program 2, so its PMT should go
+	feed(filter, {
+		makePAT(2, 1, {{1, 0x100}}),
+		makePMT(0x200, 1, 2, 0, 0x201, 0x201)});
+	check(getVersion(filter, 0) == 1, "PAT version 1 replaces version 0");
+	check(getVersion(filter, 0x100) == 1, "PMT of program 1 is kept");
+	check(getVersion(filter, 0x200) == -1, "PMT of program 2 is removed and not collected again");
+
+	// PAT version bump (wrapping version) bringing program 2 back
+	feed(filter, {
+		makePAT(3, 31, {{1, 0x100}, {2, 0x200}}),
+		makePMT(0x200, 2, 2, 3, 0x201, 0x202)});
+	check(getVersion(filter, 0) == 31, "PAT version 31 replaces version 1");
+	check(getVersion(filter, 0x200) == 3 && getESPID(filter, 0x200) == 0x202, "PMT of program 2 is collected again");
+
+	if (_errors != 0) {
+		std::printf("PSI version check FAILED with %d errors\n", _errors);
+		return 1;
+	}
+	std::printf("PSI version check OK\n");
+	return 0;
+}
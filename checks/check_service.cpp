@@ -0,0 +1,187 @@
+/* check_service.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/CRC32.h>
+#include <mpegts/Filter.h>
+#include <mpegts/PacketBuffer.h>
+#include <mpegts/PAT.h>
+
+#include <algorithm>
+#include <bitset>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using TSPacket = std::vector<unsigned char>;
+
+static int _errors = 0;
+
+static void check(const bool ok, const char *what) {
+	std::printf("%s: %s\n", ok ? "OK    " : "FAILED", what);
+	if (!ok) {
+		++_errors;
+	}
+}
+
+/// Make a TS packet with one PSI section that starts directly after the pointer field
+static TSPacket makeSection(const int pid, const int cc, const int tableID, const int tableIDExt,
+		const int version, const std::vector<unsigned char> &body) {
+	TSPacket ts(mpegts::PacketBuffer::TS_PACKET_SIZE, 0xFF);
+	const std::size_t sectionLength = 5 + body.size() + 4;
+	ts[0] = 0x47;
+	ts[1] = 0x40 | ((pid >> 8) & 0x1F);
+	ts[2] = pid & 0xFF;
+	ts[3] = 0x10 | (cc & 0x0F);
+	ts[4] = 0x00;
+	ts[5] = tableID;
+	ts[6] = 0xB0 | ((sectionLength >> 8) & 0x0F);
+	ts[7] = sectionLength & 0xFF;
+	ts[8] = (tableIDExt >> 8) & 0xFF;
+	ts[9] = tableIDExt & 0xFF;
+	ts[10] = 0xC1 | ((version & 0x1F) << 1);
+	ts[11] = 0x00;
+	ts[12] = 0x00;
+	std::memcpy(&ts[13], body.data(), body.size());
+	const std::size_t crcIndex = 13 + body.size();
+	const uint32_t crc = mpegts::CRC32::calculate(&ts[5], crcIndex - 5);
+	ts[crcIndex + 0] = (crc >> 24) & 0xFF;
+	ts[crcIndex + 1] = (crc >> 16) & 0xFF;
+	ts[crcIndex + 2] = (crc >>  8) & 0xFF;
+	ts[crcIndex + 3] = crc & 0xFF;
+	return ts;
+}
+
+static TSPacket makePAT(const int cc, const int version, const mpegts::PAT::ProgramMap &programs) {
+	const mpegts::TSData pat = mpegts::PAT::generatePacket(1, version, cc, programs);
+	return TSPacket(pat.begin(), pat.end());
+}
+
+static TSPacket makePMT(const int pid, const int cc, const int programNumber, const int version,
+		const int pcrPID, const int esPID) {
+	return makeSection(pid, cc, mpegts::TableData::PMT_ID, programNumber, version, {
+		static_cast<unsigned char>(0xE0 | (pcrPID >> 8)), static_cast<unsigned char>(pcrPID & 0xFF),
+		0xF0, 0x00,
+		0x02, static_cast<unsigned char>(0xE0 | (esPID >> 8)), static_cast<unsigned char>(esPID & 0xFF),
+		0xF0, 0x00});
+}
+
+/// Feed the packets to the filter, as one buffer, and get the packets that are left
+static std::vector<TSPacket> feed(mpegts::Filter &filter, const std::vector<TSPacket> &packets) {
+	mpegts::PacketBuffer buffer;
+	buffer.initialize(0, 0);
+	buffer.setNumberOfTSPackets(packets.size());
+	for (const TSPacket &ts : packets) {
+		std::memcpy(buffer.getWriteBufferPtr(), ts.data(), ts.size());
+		buffer.addAmountOfBytesWritten(ts.size());
+	}
+	filter.filterData(FeID(0), buffer, false);
+	std::vector<TSPacket> left;
+	for (std::size_t i = 0; i < buffer.getNumberOfCompletedPackets(); ++i) {
+		const unsigned char *ptr = buffer.getTSPacketPtr(i);
+		left.emplace_back(ptr, ptr + mpegts::PacketBuffer::TS_PACKET_SIZE);
+	}
+	return left;
+}
+
+static void openPIDs(mpegts::Filter &filter) {
+	filter.updatePIDFilters(FeID(0), [](int) { return true; }, [](int) { return true; });
+}
+
+/// Get the program number of the PMT section at the start of this packet or -1
+static int getProgramNumber(const TSPacket &ts) {
+	const int pid = ((ts[1] & 0x1F) << 8) | ts[2];
+	return (pid == 0x100 && ts[5] == mpegts::TableData::PMT_ID) ? ((ts[8] << 8) | ts[9]) : -1;
+}
+
+/// Check if the PID is in the CSV of the filter
+static bool hasPID(const std::string &csv, const int pid) {
+	return ("," + csv + ",").find("," + std::to_string(pid) + ",") != std::string::npos;
+}
+
+static std::size_t countPIDs(const std::string &csv) {
+	return csv.empty() ? 0 : std::count(csv.begin(), csv.end(), ',') + 1;
+}
+
+int main() {
+	mpegts::Filter filter;
+	filter.setService(FeID(0), 1);
+	openPIDs(filter);
+
+	// Program 1 and 2 share PMT PID 0x100
+	feed(filter, {makePAT(0, 0, {{1, 0x100}, {2, 0x100}})});
+	openPIDs(filter);
+	std::vector<TSPacket> left = feed(filter, {
+		makePMT(0x100, 0, 2, 0, 0x201, 0x201),
+		makePMT(0x100, 1, 1, 0, 0x101, 0x101),
+		makePMT(0x100, 2, 2, 0, 0x201, 0x201),
+		makePMT(0x100, 3, 1, 0, 0x101, 0x101)});
+	check(left.size() == 2 && getProgramNumber(left[0]) == 1 && getProgramNumber(left[1]) == 1,
+		"Only the PMT of the selected service is send");
+	check(left.size() == 2 && (left[0][3] & 0x0F) == 0 && (left[1][3] & 0x0F) == 1,
+		"CC of the PMT PID is continuous");
+
+	// The PMT of the service followed by an other one in the same packet
+	TSPacket both = makePMT(0x100, 4, 1, 0, 0x101, 0x101);
+	const TSPacket other = makePMT(0x100, 4, 2, 0, 0x201, 0x201);
+	const std::size_t end = 5 + 3 + (((both[6] & 0x0F) << 8) | both[7]);
+	const std::size_t otherSize = 3 + (((other[6] & 0x0F) << 8) | other[7]);
+	std::memcpy(&both[end], &other[5], otherSize);
+	left = feed(filter, {both});
+	bool stuffed = left.size() == 1 && std::memcmp(&left[0][4], &both[4], end - 4) == 0;
+	for (std::size_t i = end; stuffed && i < left[0].size(); ++i) {
+		stuffed = left[0][i] == 0xFF;
+	}
+	check(stuffed, "Section of an other program after the service is stuffed");
+
+	// Sharing the transponder keeps the PIDs of the service, the user PIDs and PID 20
+	std::bitset<mpegts::PidTable::ALL_PIDS> shared;
+	shared.set(0x300);
+	filter.setSharedPIDs(shared, false);
+	openPIDs(filter);
+	std::string csv = filter.getPidCSV();
+	check(hasPID(csv, 0) && hasPID(csv, 16) && hasPID(csv, 0x100) && hasPID(csv, 0x300),
+		"Shared PIDs are added to the service PIDs and user PIDs");
+	check(!hasPID(csv, 20) && filter.getNumberOfRequestedPIDs() == countPIDs(csv) + 1,
+		"PID 20 stays opened for the clock without showing it");
+	shared.reset();
+	shared.set(20);
+	filter.setSharedPIDs(shared, false);
+	openPIDs(filter);
+	csv = filter.getPidCSV();
+	check(!hasPID(csv, 0x300) && hasPID(csv, 0x100), "Shared PIDs are closed again");
+	check(hasPID(csv, 20), "PID 20 is shown when a session selected it");
+
+	// Without a service the requested PIDs are send again, all PMT sections
+	filter.clearService(FeID(0));
+	filter.parsePIDString(FeID(0), "0,256", true);
+	openPIDs(filter);
+	left = feed(filter, {
+		makePMT(0x100, 5, 2, 0, 0x201, 0x201),
+		makePMT(0x100, 6, 1, 0, 0x101, 0x101)});
+	check(left.size() == 2 && getProgramNumber(left[0]) == 2 && getProgramNumber(left[1]) == 1,
+		"Clearing the service sends all PMT sections again");
+
+	if (_errors != 0) {
+		std::printf("Service check FAILED with %d errors\n", _errors);
+		return 1;
+	}
+	std::printf("Service check OK\n");
+	return 0;
+}
@@ -28,6 +28,7 @@
 #include <socket/SocketClient.h>
 #include <StringConverter.h>
 
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -144,6 +145,39 @@ bool HttpServer::methodGet(SocketClient &client, bool headOnly) {
 				docType = Log::makeJSON();
 				docTypeSize = docType.size();
 				getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_JSON, docTypeSize, 0);
+			} else if (file.compare(0, 13, "pidstats.json") == 0) {
+				// Optional '?fe=<n>' to get only one frontend
+				int feID = -1;
+				const std::string::size_type fe = file.find("fe=");
+				if (fe != std::string::npos) {
+					feID = std::atoi(file.c_str() + fe + 3);
+				}
+				docType = _streamManager.getPIDStatisticsJSON(feID);
+				docTypeSize = docType.size();
+				getHtmlBodyWithContent(htmlBody, HTML_OK, "pidstats.json", CONTENT_TYPE_JSON, docTypeSize, 0);
+			} else if (file.compare(0, 8, "epg.json") == 0 || file.compare(0, 7, "epg.xml") == 0) {
+				// Optional '?fe=<n>&sid=<n>&nownext' to get only one frontend,
+				// one service or only the present and following event
+				int feID = -1;
+				int serviceID = -1;
+				const std::string::size_type fe = file.find("fe=");
+				if (fe != std::string::npos) {
+					feID = std::atoi(file.c_str() + fe + 3);
+				}
+				const std::string::size_type sid = file.find("sid=");
+				if (sid != std::string::npos) {
+					serviceID = std::atoi(file.c_str() + sid + 4);
+				}
+				const bool nowNext = file.find("nownext") != std::string::npos;
+				if (file.compare(0, 8, "epg.json") == 0) {
+					docType = _streamManager.getEPGJSON(feID, serviceID, nowNext);
+					docTypeSize = docType.size();
+					getHtmlBodyWithContent(htmlBody, HTML_OK, "epg.json", CONTENT_TYPE_JSON, docTypeSize, 0);
+				} else {
+					docType = _streamManager.getEPGXMLTV(feID, serviceID, nowNext);
+					docTypeSize = docType.size();
+					getHtmlBodyWithContent(htmlBody, HTML_OK, "epg.xml", CONTENT_TYPE_XML, docTypeSize, 0);
+				}
 			} else if (file == "STOP") {
 				exitRequest = true;
 				getHtmlBodyWithContent(htmlBody, HTML_NO_RESPONSE, "", CONTENT_TYPE_HTML, 0, 0);
@@ -57,7 +57,7 @@ void RtspServer::threadEntry() {
 
 void RtspServer::methodSetup(const Stream &stream, const int clientID, std::string &htmlBody) {
 	StreamClient &client = stream.getStreamClient(clientID);
-	switch (stream.getStreamingType()) {
+	switch (stream.getStreamingType(clientID)) {
 		case Stream::StreamingType::RTP_TCP: {
 			static const char *RTSP_SETUP_OK =
 				"RTSP/1.0 200 OK\r\n" \
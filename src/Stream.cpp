@@ -22,15 +22,20 @@
 #include <Log.h>
 #include <StringConverter.h>
 #include <Utils.h>
+#include <base/JSONSerializer.h>
 #include <input/dvb/Frontend.h>
 #include <input/dvb/FrontendData.h>
 #include <input/dvb/delivery/DVBS.h>
+#include <mpegts/PacketBuffer.h>
 #include <output/StreamThreadHttp.h>
 #include <output/StreamThreadRtp.h>
 #include <output/StreamThreadRtpTcp.h>
 #include <output/StreamThreadTSWriter.h>
 #include <socket/SocketClient.h>
 
+#include <algorithm>
+#include <bitset>
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -47,6 +52,7 @@ Stream::Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt) :
 	_streamInUse(false),
 	_streamActive(false),
 	_client(new StreamClient[MAX_CLIENTS]),
+	_ownerID(0),
 	_streaming(nullptr),
 	_decrypt(decrypt),
 	_device(device),
@@ -55,7 +61,24 @@ Stream::Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt) :
 	_soc(0),
 	_timestamp(0),
 	_rtp_payload(0.0),
-	_rtcpSignalUpdate(1) {
+	_rtcpSignalUpdate(1),
+	_rtpBatchSize(16),
+	_rtpBatchAge(10),
+	_rtpGSO(false),
+	_rtpPacing(false),
+	_rtpTxTime(false),
+	_rtpPCRTimestamp(true),
+	_rtpPacingBitrate(0.0),
+	_rtpBurstiness(0.0),
+	_tsPackets(mpegts::PacketBuffer::NUMBER_OF_TS_PACKETS),
+	_rtpMTU(DEFAULT_RTP_MTU),
+	_pipeline(false),
+	_pipelineCPU{-1, -1, -1},
+	_rtpSendCalls(0),
+	_rtpSendPackets(0),
+	_transponderSharing(false),
+	_consumer(MAX_CLIENTS),
+	_consumerCount(0) {
 	ASSERT(device);
 }
 
@@ -133,6 +156,100 @@ double Stream::getRtpPayload() const {
 	return _rtp_payload;
 }
 
+unsigned int Stream::getRtpBatchSize() const {
+	return _rtpBatchSize;
+}
+
+unsigned int Stream::getRtpBatchAge() const {
+	return _rtpBatchAge;
+}
+
+bool Stream::isRtpGSOEnabled() const {
+	return _rtpGSO;
+}
+
+bool Stream::isRtpPacingEnabled() const {
+	return _rtpPacing;
+}
+
+bool Stream::isRtpTxTimeEnabled() const {
+	return _rtpTxTime;
+}
+
+bool Stream::isRtpPCRTimestampEnabled() const {
+	return _rtpPCRTimestamp;
+}
+
+void Stream::setRtpPacingStats(const double bitrate, const double burstiness) {
+	_rtpPacingBitrate = bitrate;
+	_rtpBurstiness = burstiness;
+}
+
+unsigned int Stream::getTSPacketsPerDatagram(const int clientID) const {
+	const unsigned int requested = _client[clientID].getTSPacketsPerDatagram();
+	const unsigned int packets = (requested == 0) ? _tsPackets : requested;
+	switch (getStreamingType(clientID)) {
+		case StreamingType::RTSP_UNICAST:
+		case StreamingType::RTSP_MULTICAST: {
+				// One RTP/UDP datagram should fit in one frame of the network
+				const unsigned int mtuPackets = mpegts::PacketBuffer::getNumberOfTSPacketsForMTU(_rtpMTU);
+				return std::min(packets, mtuPackets);
+			}
+		default:
+			// HTTP and RTP/TCP are a byte stream, so up to MAX_NUMBER_OF_TS_PACKETS
+			return packets;
+	}
+}
+
+bool Stream::isPipelineEnabled() const {
+	return _pipeline;
+}
+
+int Stream::getPipelineCPU(const PipelineStage stage) const {
+	return _pipelineCPU[static_cast<int>(stage)];
+}
+
+void Stream::addRtpSendCall(uint32_t packets) {
+	++_rtpSendCalls;
+	_rtpSendPackets += packets;
+}
+
+bool Stream::hasConsumers() const {
+	return _consumerCount != 0;
+}
+
+void Stream::shareWithConsumers(mpegts::PacketBuffer &buffer) {
+	base::MutexLock lock(_consumerMutex);
+	for (Consumer &consumer : _consumer) {
+		if (consumer.streaming) {
+			consumer.streaming->writeConsumerData(buffer);
+		}
+	}
+	// The device has the PIDs of all sessions open, so the owner should only
+	// get the ones it did select itself
+	const StreamClient &owner = _client[_ownerID];
+	if (owner.hasPIDSelection()) {
+		const std::size_t size = buffer.getNumberOfCompletedPackets();
+		for (std::size_t i = 0; i < size; ++i) {
+			const unsigned char *ts = buffer.getTSPacketPtr(i);
+			const int pid = ((ts[1] & 0x1f) << 8) | ts[2];
+			if (!owner.isPIDSelected(pid)) {
+				buffer.markTSForPurging(i);
+			}
+		}
+		buffer.purge();
+	}
+}
+
+void Stream::flushConsumers() {
+	base::MutexLock lock(_consumerMutex);
+	for (Consumer &consumer : _consumer) {
+		if (consumer.streaming) {
+			consumer.streaming->flushConsumerData();
+		}
+	}
+}
+
 std::string Stream::attributeDescribeString() const {
 	return _device->attributeDescribeString();
 }
@@ -149,8 +266,29 @@ void Stream::doAddToXML(std::string &xml) const {
 	ADD_XML_NUMBER_INPUT(xml, "rtcpSignalUpdate", _rtcpSignalUpdate, 1, 5);
 	ADD_XML_ELEMENT(xml, "spc", _spc.load());
 	ADD_XML_ELEMENT(xml, "payload", _rtp_payload.load() / (1024.0 * 1024.0));
-
-	_client[0].addToXML(xml);
+	ADD_XML_NUMBER_INPUT(xml, "rtpBatchSize", _rtpBatchSize, 1, output::StreamThreadBase::MAX_BATCH_SIZE);
+	ADD_XML_NUMBER_INPUT(xml, "rtpBatchAge", _rtpBatchAge, 0, 50);
+	ADD_XML_CHECKBOX(xml, "rtpGSO", (_rtpGSO ? "true" : "false"));
+	ADD_XML_CHECKBOX(xml, "rtpPacing", (_rtpPacing ? "true" : "false"));
+	ADD_XML_CHECKBOX(xml, "rtpTxTime", (_rtpTxTime ? "true" : "false"));
+	ADD_XML_CHECKBOX(xml, "rtpPCRTimestamp", (_rtpPCRTimestamp ? "true" : "false"));
+	ADD_XML_NUMBER_INPUT(xml, "tsPacketsPerDatagram", _tsPackets,
+		mpegts::PacketBuffer::NUMBER_OF_TS_PACKETS, mpegts::PacketBuffer::MAX_NUMBER_OF_TS_PACKETS);
+	ADD_XML_NUMBER_INPUT(xml, "rtpMTU", _rtpMTU, MIN_RTP_MTU, MAX_RTP_MTU);
+	const int maxCPU = base::ThreadBase::getNumberOfProcessorsOnline() - 1;
+	ADD_XML_CHECKBOX(xml, "pipelinedStreaming", (_pipeline ? "true" : "false"));
+	ADD_XML_NUMBER_INPUT(xml, "pipelineReadCPU", _pipelineCPU[0], -1, maxCPU);
+	ADD_XML_NUMBER_INPUT(xml, "pipelineDecryptCPU", _pipelineCPU[1], -1, maxCPU);
+	ADD_XML_NUMBER_INPUT(xml, "pipelineSendCPU", _pipelineCPU[2], -1, maxCPU);
+	ADD_XML_CHECKBOX(xml, "transponderSharing", (_transponderSharing ? "true" : "false"));
+	ADD_XML_ELEMENT(xml, "sharedSessions", _consumerCount.load());
+	const uint32_t sendCalls = _rtpSendCalls.load();
+	ADD_XML_ELEMENT(xml, "rtpPacketsPerSyscall",
+		(sendCalls == 0) ? 0.0 : (_rtpSendPackets.load() / static_cast<double>(sendCalls)));
+	ADD_XML_ELEMENT(xml, "rtpPacingBitrate", _rtpPacingBitrate.load() / (1000.0 * 1000.0));
+	ADD_XML_ELEMENT(xml, "rtpBurstiness", _rtpBurstiness.load());
+
+	_client[_ownerID].addToXML(xml);
 	_device->addToXML(xml);
 }
 
@@ -162,6 +300,49 @@ void Stream::doFromXML(const std::string &xml) {
 	if (findXMLElement(xml, "rtcpSignalUpdate.value", element)) {
 		_rtcpSignalUpdate = std::stoi(element);
 	}
+	if (findXMLElement(xml, "rtpBatchSize.value", element)) {
+		_rtpBatchSize = std::clamp(std::stoi(element), 1,
+			static_cast<int>(output::StreamThreadBase::MAX_BATCH_SIZE));
+	}
+	if (findXMLElement(xml, "rtpBatchAge.value", element)) {
+		_rtpBatchAge = std::clamp(std::stoi(element), 0, 50);
+	}
+	if (findXMLElement(xml, "rtpGSO.value", element)) {
+		_rtpGSO = (element == "true") ? true : false;
+	}
+	if (findXMLElement(xml, "rtpPacing.value", element)) {
+		_rtpPacing = (element == "true") ? true : false;
+	}
+	if (findXMLElement(xml, "rtpTxTime.value", element)) {
+		_rtpTxTime = (element == "true") ? true : false;
+	}
+	if (findXMLElement(xml, "rtpPCRTimestamp.value", element)) {
+		_rtpPCRTimestamp = (element == "true") ? true : false;
+	}
+	if (findXMLElement(xml, "tsPacketsPerDatagram.value", element)) {
+		_tsPackets = std::clamp(std::stoi(element),
+			static_cast<int>(mpegts::PacketBuffer::NUMBER_OF_TS_PACKETS),
+			static_cast<int>(mpegts::PacketBuffer::MAX_NUMBER_OF_TS_PACKETS));
+	}
+	if (findXMLElement(xml, "rtpMTU.value", element)) {
+		_rtpMTU = std::clamp(std::stoi(element), static_cast<int>(MIN_RTP_MTU), static_cast<int>(MAX_RTP_MTU));
+	}
+	if (findXMLElement(xml, "pipelinedStreaming.value", element)) {
+		_pipeline = (element == "true") ? true : false;
+	}
+	const int maxCPU = base::ThreadBase::getNumberOfProcessorsOnline() - 1;
+	if (findXMLElement(xml, "pipelineReadCPU.value", element)) {
+		_pipelineCPU[0] = std::clamp(std::stoi(element), -1, maxCPU);
+	}
+	if (findXMLElement(xml, "pipelineDecryptCPU.value", element)) {
+		_pipelineCPU[1] = std::clamp(std::stoi(element), -1, maxCPU);
+	}
+	if (findXMLElement(xml, "pipelineSendCPU.value", element)) {
+		_pipelineCPU[2] = std::clamp(std::stoi(element), -1, maxCPU);
+	}
+	if (findXMLElement(xml, "transponderSharing.value", element)) {
+		_transponderSharing = (element == "true") ? true : false;
+	}
 	_device->fromXML(xml);
 }
 
@@ -174,6 +355,27 @@ input::dvb::SpFrontendDecryptInterface Stream::getFrontendDecryptInterface() {
 }
 #endif
 
+void Stream::addPIDStatisticsToJSON(base::JSONSerializer &json) const {
+	json.startObject();
+	json.addValueNumber("feID", StringConverter::stringFormat("@#1", _device->getFeID().getID()));
+	_device->getFilter().addPIDStatisticsToJSON(json);
+	_device->getFilter().addClockToJSON(json);
+	_device->getFilter().addTR101290ToJSON(json);
+	json.endObject();
+}
+
+void Stream::addEPGToJSON(base::JSONSerializer &json, const int serviceID, const bool nowNext) const {
+	json.startObject();
+	json.addValueNumber("feID", StringConverter::stringFormat("@#1", _device->getFeID().getID()));
+	_device->getFilter().addEPGToJSON(json, serviceID, nowNext);
+	json.endObject();
+}
+
+void Stream::addEPGToXMLTV(std::string &channels, std::string &programmes,
+		std::set<uint64_t> &added, const int serviceID, const bool nowNext) const {
+	_device->getFilter().addEPGToXMLTV(channels, programmes, added, serviceID, nowNext);
+}
+
 bool Stream::findClientIDFor(SocketClient &socketClient,
 		const bool newSession, const std::string sessionID, int &clientID) {
 	base::MutexLock lock(_mutex);
@@ -189,13 +391,17 @@ bool Stream::findClientIDFor(SocketClient &socketClient,
 	}
 
 	// Do we have a new session then check some things
+	bool shareTransponder = false;
 	if (newSession) {
 		if (!_enabled) {
 			SI_LOG_INFO("Frontend: @#1, New session but this stream is not enabled, skipping...", id);
 			return false;
 		} else if (_streamInUse) {
-			SI_LOG_INFO("Frontend: @#1, New session but this stream is in use, skipping...", id);
-			return false;
+			if (!canShareTransponder(params)) {
+				SI_LOG_INFO("Frontend: @#1, New session but this stream is in use, skipping...", id);
+				return false;
+			}
+			shareTransponder = true;
 		} else if (!_device->capableOf(msys)) {
 			if (_device->capableToTransform(params)) {
 				SI_LOG_INFO("Frontend: @#1, Capable of transforming msys=@#2 with freq=@#3",
@@ -219,6 +425,15 @@ bool Stream::findClientIDFor(SocketClient &socketClient,
 				SI_LOG_INFO("Frontend: @#1, StreamClient[@#2] with SessionID @#3",
 					id, i, sessionID);
 			}
+			if (shareTransponder) {
+				SI_LOG_INFO("Frontend: @#1, StreamClient[@#2] shares the transponder of this stream", id, i);
+				base::MutexLock lockConsumer(_consumerMutex);
+				_consumer[i].attached = true;
+			} else if (newSession) {
+				// This client takes the stream and owns the device
+				base::MutexLock lockConsumer(_consumerMutex);
+				_ownerID = i;
+			}
 			_client[i].setSocketClient(socketClient);
 			_streamInUse = true;
 			clientID = i;
@@ -253,38 +468,28 @@ void Stream::checkForSessionTimeout() {
 
 bool Stream::update(int clientID) {
 	base::MutexLock lock(_mutex);
-	const FeID id = _device->getFeID();
+	// A consumer only needs its output, the owner keeps the device tuned
+	if (isConsumer(clientID)) {
+		Consumer &consumer = _consumer[clientID];
+		if (!consumer.streaming) {
+			output::UpStreamThreadBase streaming;
+			makeStreamThread(consumer.streamingType, streaming);
+			if (!streaming) {
+				return false;
+			}
+			if (!streaming->startConsumer(clientID)) {
+				return false;
+			}
+			base::MutexLock lockConsumer(_consumerMutex);
+			consumer.streaming = std::move(streaming);
+			++_consumerCount;
+		}
+		updateSharedPIDs();
+		return _device->update();
+	}
 	// first time streaming?
 	if (!_streaming) {
-		switch (_streamingType) {
-			case StreamingType::NONE:
-				_streaming.reset(nullptr);
-				SI_LOG_ERROR("Frontend: @#1, No streaming type found!!", id);
-				break;
-			case StreamingType::HTTP:
-				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: HTTP", id);
-				_streaming.reset(new output::StreamThreadHttp(*this));
-				break;
-			case StreamingType::RTSP_UNICAST:
-				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: RTSP Unicast", id);
-				_streaming.reset(new output::StreamThreadRtp(*this));
-				break;
-			case StreamingType::RTSP_MULTICAST:
-				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: RTSP Multicast", id);
-				_streaming.reset(new output::StreamThreadRtp(*this));
-				break;
-			case StreamingType::RTP_TCP:
-				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: RTP/TCP", id);
-				_streaming.reset(new output::StreamThreadRtpTcp(*this));
-				break;
-			case StreamingType::FILE_SRC:
-				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: FILE", id);
-				_streaming.reset(new output::StreamThreadTSWriter(*this, "test.ts"));
-				break;
-			default:
-				_streaming.reset(nullptr);
-				SI_LOG_ERROR("Frontend: @#1, Unknown streaming type!", id);
-		};
+		makeStreamThread(_streamingType, _streaming);
 		if (!_streaming) {
 			return false;
 		}
@@ -292,6 +497,10 @@ bool Stream::update(int clientID) {
 	// Get changed flag, before device update, because it resets it
 	const bool changed = _device->hasDeviceDataChanged();
 
+	if (_consumerCount != 0) {
+		updateSharedPIDs();
+	}
+
 	if (!_device->update()) {
 		return false;
 	}
@@ -313,10 +522,24 @@ bool Stream::teardown(int clientID) {
 	SI_LOG_INFO("Frontend: @#1, Teardown StreamClient[@#2] with SessionID @#3",
 		_device->getFeID(), clientID, _client[clientID].getSessionID());
 
+	// A consumer leaves, the owner and other consumers keep streaming
+	if (isConsumer(clientID)) {
+		teardownConsumer(clientID);
+		_client[clientID].teardown();
+		updateSharedPIDs();
+		_device->update();
+		return true;
+	}
+
 	// Stop streaming by deleting object
 	if (_streaming) {
 		_streaming.reset(nullptr);
 	}
+	for (std::size_t i = 0; i < MAX_CLIENTS; ++i) {
+		if (isConsumer(i)) {
+			teardownConsumer(i);
+		}
+	}
 
 	_device->teardown();
 
@@ -324,8 +547,8 @@ bool Stream::teardown(int clientID) {
 	_client[clientID].teardown();
 
 	// @TODO Are all other StreamClients stopped??
-	if (clientID == 0) {
-		for (std::size_t i = 1; i < MAX_CLIENTS; ++i) {
+	if (clientID == _ownerID) {
+		for (std::size_t i = 0; i < MAX_CLIENTS; ++i) {
 			_client[i].teardown();
 		}
 		_streamActive = false;
@@ -353,22 +576,51 @@ bool Stream::processStreamingRequest(const SocketClient &client, const int clien
 		_client[clientID].setUserAgent(userAgent);
 	}
 
+	const bool consumer = isConsumer(clientID);
 	TransportParamVector params = client.getTransportParameters();
 	const std::string method = client.getMethod();
 	if ((method == "SETUP" || method == "PLAY"  || method == "GET") &&
 			client.hasTransportParameters()) {
-		_device->parseStreamString(params);
+		if (!consumer) {
+			_device->parseStreamString(params);
+		} else if (params.getDoubleParameter("freq") != -1.0 && !_device->isSameTransponder(params)) {
+			SI_LOG_INFO("Frontend: @#1, StreamClient[@#2] requests an other transponder, only updating its PIDs",
+				_device->getFeID(), clientID);
+		}
+		base::MutexLock lockConsumer(_consumerMutex);
+		_client[clientID].parsePIDSelection(params, _device->getFilter().getUserPIDs());
 	}
 
 	// Channel changed?.. stop/pause Stream
-	if (_device->hasDeviceDataChanged()) {
+	if (!consumer && _device->hasDeviceDataChanged()) {
 		if (_streaming) {
 			_streaming->pauseStreaming(clientID);
 		}
+		// The clients sharing this stream can not follow the owner
+		for (std::size_t i = 0; i < MAX_CLIENTS; ++i) {
+			if (isConsumer(i)) {
+				SI_LOG_INFO("Frontend: @#1, Owner changed channel, detaching StreamClient[@#2]",
+					_device->getFeID(), i);
+				teardownConsumer(i);
+				_client[i].teardown();
+			}
+		}
+	}
+
+	// TS packets per datagram, as query 'tspackets=' or Transport 'tspackets='
+	int tsPackets = params.getIntParameter("tspackets");
+	if (tsPackets == -1) {
+		tsPackets = headers.getIntFieldParameter("Transport", "tspackets");
+	}
+	if (tsPackets != -1) {
+		_client[clientID].setTSPacketsPerDatagram(std::clamp(tsPackets,
+			static_cast<int>(mpegts::PacketBuffer::NUMBER_OF_TS_PACKETS),
+			static_cast<int>(mpegts::PacketBuffer::MAX_NUMBER_OF_TS_PACKETS)));
 	}
 
 	// Get transport type from request, and maybe ports
-	if (_streamingType == StreamingType::NONE) {
+	StreamingType &streamingType = consumer ? _consumer[clientID].streamingType : _streamingType;
+	if (streamingType == StreamingType::NONE) {
 		if (method == "GET") {
 			const std::string multicast = params.getParameter("multicast");
 			if (!multicast.empty()) {
@@ -381,11 +633,11 @@ bool Stream::processStreamingRequest(const SocketClient &client, const int clien
 					headers = client.getHeaders();
 					SI_LOG_INFO("Frontend: @#1, Setup Multicast (@#2) for StreamClient[@#3]",
 						_device->getFeID(), multicast, clientID);
-					_streamingType = StreamingType::RTSP_MULTICAST;
+					streamingType = StreamingType::RTSP_MULTICAST;
 					_client[clientID].setSessionTimeoutCheck(StreamClient::SessionTimeoutCheck::TEARDOWN);
 				}
 			} else {
-				_streamingType = StreamingType::HTTP;
+				streamingType = StreamingType::HTTP;
 				_client[clientID].setSessionTimeoutCheck(StreamClient::SessionTimeoutCheck::FILE_DESCRIPTOR);
 			}
 			_client[clientID].setIPAddressOfStream(_client[clientID].getIPAddressOfSocket());
@@ -393,20 +645,20 @@ bool Stream::processStreamingRequest(const SocketClient &client, const int clien
 			const std::string transport = headers.getFieldParameter("Transport");
 			if (transport.find("unicast") != std::string::npos) {
 				if (transport.find("RTP/AVP") != std::string::npos) {
-					_streamingType = StreamingType::RTSP_UNICAST;
+					streamingType = StreamingType::RTSP_UNICAST;
 				}
 				_client[clientID].setSessionTimeoutCheck(StreamClient::SessionTimeoutCheck::WATCHDOG);
 			} else if (transport.find("multicast") != std::string::npos) {
-				_streamingType = StreamingType::RTSP_MULTICAST;
+				streamingType = StreamingType::RTSP_MULTICAST;
 				_client[clientID].setSessionTimeoutCheck(StreamClient::SessionTimeoutCheck::TEARDOWN);
 			} else if (transport.find("RTP/AVP/TCP") != std::string::npos) {
-				_streamingType = StreamingType::RTP_TCP;
+				streamingType = StreamingType::RTP_TCP;
 				_client[clientID].setSessionTimeoutCheck(StreamClient::SessionTimeoutCheck::WATCHDOG);
 			}
 		}
 	}
 
-	switch (_streamingType) {
+	switch (streamingType) {
 		case StreamingType::RTP_TCP: {
 				const int interleaved = headers.getIntFieldParameter("Transport", "interleaved");
 				if (interleaved != -1) {
@@ -460,8 +712,8 @@ std::string Stream::getDescribeMediaLevelString() const {
 	if (desc_attr.size() > 5) {
 		if (_streamingType == StreamingType::RTSP_MULTICAST) {
 			return StringConverter::stringFormat(RTSP_DESCRIBE_MEDIA_LEVEL,
-				_client[0].getRtpSocketAttr().getSocketPort(),
-				_client[0].getIPAddressOfStream() + "/0",
+				_client[_ownerID].getRtpSocketAttr().getSocketPort(),
+				_client[_ownerID].getIPAddressOfStream() + "/0",
 				_device->getStreamID().getID(), desc_attr,
 				(_streamActive) ? "sendonly" : "inactive");
 		} else {
@@ -472,3 +724,77 @@ std::string Stream::getDescribeMediaLevelString() const {
 	}
 	return "";
 }
+
+// ===========================================================================
+// -- Transponder sharing ----------------------------------------------------
+// ===========================================================================
+
+void Stream::makeStreamThread(const StreamingType streamingType,
+		output::UpStreamThreadBase &streaming) {
+	const FeID id = _device->getFeID();
+	switch (streamingType) {
+		case StreamingType::NONE:
+			streaming.reset(nullptr);
+			SI_LOG_ERROR("Frontend: @#1, No streaming type found!!", id);
+			break;
+		case StreamingType::HTTP:
+			SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: HTTP", id);
+			streaming.reset(new output::StreamThreadHttp(*this));
+			break;
+		case StreamingType::RTSP_UNICAST:
+			SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: RTSP Unicast", id);
+			streaming.reset(new output::StreamThreadRtp(*this));
+			break;
+		case StreamingType::RTSP_MULTICAST:
+			SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: RTSP Multicast", id);
+			streaming.reset(new output::StreamThreadRtp(*this));
+			break;
+		case StreamingType::RTP_TCP:
+			SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: RTP/TCP", id);
+			streaming.reset(new output::StreamThreadRtpTcp(*this));
+			break;
+		case StreamingType::FILE_SRC:
+			SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: FILE", id);
+			streaming.reset(new output::StreamThreadTSWriter(*this, "test.ts"));
+			break;
+		default:
+			streaming.reset(nullptr);
+			SI_LOG_ERROR("Frontend: @#1, Unknown streaming type!", id);
+	};
+}
+
+bool Stream::canShareTransponder(const TransportParamVector &params) const {
+	return _transponderSharing && _streamActive && _device->isSameTransponder(params);
+}
+
+void Stream::teardownConsumer(const int clientID) {
+	output::UpStreamThreadBase streaming;
+	{
+		base::MutexLock lock(_consumerMutex);
+		Consumer &consumer = _consumer[clientID];
+		if (consumer.streaming) {
+			streaming = std::move(consumer.streaming);
+			--_consumerCount;
+		}
+		consumer.attached = false;
+		consumer.streamingType = StreamingType::NONE;
+		_client[clientID].clearPIDSelection();
+	}
+	// The owner does not see it anymore, so stop it outside the lock
+	streaming.reset(nullptr);
+}
+
+void Stream::updateSharedPIDs() {
+	std::bitset<mpegts::PidTable::ALL_PIDS> pids;
+	bool all = false;
+	{
+		base::MutexLock lock(_consumerMutex);
+		_client[_ownerID].addPIDSelectionTo(pids, all);
+		for (std::size_t i = 0; i < MAX_CLIENTS; ++i) {
+			if (isConsumer(i)) {
+				_client[i].addPIDSelectionTo(pids, all);
+			}
+		}
+	}
+	_device->getFilter().setSharedPIDs(pids, all);
+}
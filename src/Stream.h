@@ -30,12 +30,14 @@
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 FW_DECL_NS0(SocketClient);
 FW_DECL_NS1(output, StreamThreadBase);
 FW_DECL_NS1(input, DeviceData);
+FW_DECL_NS1(mpegts, PacketBuffer);
 
 FW_DECL_UP_NS1(output, StreamThreadBase);
 FW_DECL_SP_NS2(decrypt, dvbapi, Client);
@@ -120,6 +122,34 @@ class Stream :
 
 		virtual double getRtpPayload() const final;
 
+		virtual unsigned int getRtpBatchSize() const final;
+
+		virtual unsigned int getRtpBatchAge() const final;
+
+		virtual bool isRtpGSOEnabled() const final;
+
+		virtual bool isRtpPacingEnabled() const final;
+
+		virtual bool isRtpTxTimeEnabled() const final;
+
+		virtual bool isRtpPCRTimestampEnabled() const final;
+
+		virtual void setRtpPacingStats(double bitrate, double burstiness) final;
+
+		virtual unsigned int getTSPacketsPerDatagram(int clientID) const final;
+
+		virtual bool isPipelineEnabled() const final;
+
+		virtual int getPipelineCPU(PipelineStage stage) const final;
+
+		virtual void addRtpSendCall(uint32_t packets) final;
+
+		virtual bool hasConsumers() const final;
+
+		virtual void shareWithConsumers(mpegts::PacketBuffer &buffer) final;
+
+		virtual void flushConsumers() final;
+
 		virtual std::string attributeDescribeString() const final;
 
 		// =========================================================================
@@ -144,6 +174,19 @@ class Stream :
 			}
 		}
 
+		/// Add the per PID statistics and broadcast clock of this frontend as JSON object
+		void addPIDStatisticsToJSON(base::JSONSerializer &json) const;
+
+		/// Add the EPG index of this frontend as JSON object
+		/// @param serviceID specifies the service or -1 for all of them
+		/// @param nowNext specifies if only the present and following event should be added
+		void addEPGToJSON(base::JSONSerializer &json, int serviceID, bool nowNext) const;
+
+		/// Add the EPG index of this frontend as XMLTV elements
+		/// @param added specifies the services that are already added by an other frontend
+		void addEPGToXMLTV(std::string &channels, std::string &programmes,
+			std::set<uint64_t> &added, int serviceID, bool nowNext) const;
+
 		/// Find the clientID for the requested parameters
 		bool findClientIDFor(SocketClient &socketClient,
 				bool newSession, std::string sessionID, int &clientID);
@@ -160,10 +203,10 @@ class Stream :
 			return _enabled;
 		}
 
-		/// Get the stream type of this stream
-		StreamingType getStreamingType() const {
+		/// Get the stream type of this stream for the specified client
+		StreamingType getStreamingType(int clientID) const {
 			base::MutexLock lock(_mutex);
-			return _streamingType;
+			return isConsumer(clientID) ? _consumer[clientID].streamingType : _streamingType;
 		}
 
 		/// Teardown the stream client with clientID
@@ -187,11 +230,45 @@ class Stream :
 		///
 		std::string getDescribeMediaLevelString() const;
 
+		// =========================================================================
+		// -- Transponder sharing --------------------------------------------------
+		// =========================================================================
+	private:
+
+		/// Make the streaming thread for the requested streaming type
+		void makeStreamThread(StreamingType streamingType,
+			output::UpStreamThreadBase &streaming);
+
+		/// Check if the client is sharing the transponder of the owner
+		bool isConsumer(int clientID) const {
+			return clientID != _ownerID && _consumer[clientID].attached;
+		}
+
+		/// Check if a new session with these parameters can share this stream
+		bool canShareTransponder(const TransportParamVector &params) const;
+
+		/// Stop and detach the client that is sharing this stream
+		void teardownConsumer(int clientID);
+
+		/// Set the PID filter of the device to the PIDs of all clients
+		void updateSharedPIDs();
+
 		// =========================================================================
 		// -- Data members ---------------------------------------------------------
 		// =========================================================================
 	private:
 
+		/// A session that shares the transponder (and the read path) of the owner
+		struct Consumer {
+			bool attached = false;
+			StreamingType streamingType = StreamingType::NONE;
+			output::UpStreamThreadBase streaming;
+		};
+
+		static constexpr unsigned int DEFAULT_RTP_MTU = 1500;
+		static constexpr unsigned int MIN_RTP_MTU = 1280;
+		static constexpr unsigned int MAX_RTP_MTU = 9216;
+
 		base::Mutex _mutex;
 
 		StreamingType     _streamingType; ///
@@ -200,7 +277,7 @@ class Stream :
 		bool              _streamActive;  ///
 
 		StreamClient     *_client;        /// defines the participants of this stream
-		                                  /// index 0 is the owner of this stream
+		int               _ownerID;       /// clientID that took this stream and tunes the device
 		output::UpStreamThreadBase _streaming; ///
 		decrypt::dvbapi::SpClient _decrypt;///
 		input::SpDevice _device;          ///
@@ -210,6 +287,24 @@ class Stream :
 		std::atomic<long> _timestamp;     ///
 		std::atomic<double> _rtp_payload; ///
 		unsigned int _rtcpSignalUpdate;   ///
+		unsigned int _rtpBatchSize;       /// max RTP packets per send system call
+		unsigned int _rtpBatchAge;        /// max time in ms to wait on a full batch
+		bool _rtpGSO;                     /// try UDP GSO (UDP_SEGMENT) for RTP/UDP
+		bool _rtpPacing;                  /// pace RTP/UDP at the bitrate of the PCR
+		bool _rtpTxTime;                  /// use SO_TXTIME launch times for pacing
+		bool _rtpPCRTimestamp;            /// RTP timestamps from the PCR media time
+		std::atomic<double> _rtpPacingBitrate; /// measured bitrate in bits/s
+		std::atomic<double> _rtpBurstiness;    /// peak 1ms send rate / mean send rate
+		unsigned int _tsPackets;          /// default TS packets per RTP packet (datagram)
+		unsigned int _rtpMTU;             /// MTU of the network, limits the TS packets per RTP/UDP datagram
+		bool _pipeline;                   /// read, decrypt and send in separate threads
+		int _pipelineCPU[3];              /// CPU of each pipeline stage or -1
+		std::atomic<uint32_t> _rtpSendCalls;   /// send system calls
+		std::atomic<uint32_t> _rtpSendPackets; /// RTP packets send with these calls
+		bool _transponderSharing;         /// let new sessions share a tuned transponder
+		base::Mutex _consumerMutex;       /// guards the consumers and the PID selections
+		std::vector<Consumer> _consumer;  /// clients sharing this stream, the owner is not used
+		std::atomic<unsigned int> _consumerCount; ///
 
 };
 
@@ -22,6 +22,7 @@
 #include <Log.h>
 #include <socket/SocketClient.h>
 #include <Stream.h>
+#include <StringConverter.h>
 
 // ============================================================================
 //  -- Constructors and destructor --------------------------------------------
@@ -35,7 +36,9 @@ StreamClient::StreamClient() :
 		_sessionTimeout(60),
 		_sessionID("-1"),
 		_userAgent("None"),
-		_cseq(0) {}
+		_cseq(0),
+		_tsPackets(0),
+		_allPIDs(false) {}
 
 StreamClient::~StreamClient() {}
 
@@ -66,11 +69,51 @@ void StreamClient::teardown() {
 	_ipAddress = "0.0.0.0";
 	_userAgent = "None";
 	_sessionTimeoutCheck = SessionTimeoutCheck::WATCHDOG;
+	_tsPackets = 0;
+	clearPIDSelection();
 
 	// Do not delete
 	_socketClient = nullptr;
 }
 
+void StreamClient::parsePIDSelection(const TransportParamVector &params,
+		const std::bitset<mpegts::PidTable::ALL_PIDS> &userPIDs) {
+	const auto parse = [this, &userPIDs](const std::string &reqPids, const bool add) {
+		if (reqPids.find("all") != std::string::npos ||
+			reqPids.find("none") != std::string::npos) {
+			clearPIDSelection();
+			_allPIDs = add && reqPids.find("all") != std::string::npos;
+			return;
+		}
+		const StringVector reqPidList = StringConverter::split(reqPids, ",");
+		for (const std::string &pid : reqPidList) {
+			try {
+				if (const auto p = std::stoi(pid); p >= 0 && p < mpegts::PidTable::ALL_PIDS) {
+					_pidSelection.set(p, add);
+				}
+			} catch (const std::invalid_argument &) {
+				SI_LOG_ERROR("StreamClient: Error, skipping PID: @#1", pid);
+			}
+		}
+		// The user PIDs can not be deleted, they stay selected like the
+		// filter keeps them opened
+		_pidSelection |= userPIDs;
+	};
+	const std::string pids = params.getParameter("pids");
+	if (!pids.empty()) {
+		clearPIDSelection();
+		parse(pids, true);
+	}
+	const std::string addpids = params.getParameter("addpids");
+	if (!addpids.empty()) {
+		parse(addpids, true);
+	}
+	const std::string delpids = params.getParameter("delpids");
+	if (!delpids.empty()) {
+		parse(delpids, false);
+	}
+}
+
 void StreamClient::restartWatchDog() {
 	base::MutexLock lock(_mutex);
 
@@ -134,6 +177,11 @@ int StreamClient::getHttpSocketPort() const {
 	return (_socketClient == nullptr) ? 0 : _socketClient->getSocketPort();
 }
 
+int StreamClient::getHttpSocketFD() const {
+	base::MutexLock lock(_mutex);
+	return (_socketClient == nullptr) ? -1 : _socketClient->getFD();
+}
+
 int StreamClient::getHttpNetworkSendBufferSize() const {
 	base::MutexLock lock(_mutex);
 	return (_socketClient == nullptr) ? 0 : _socketClient->getNetworkSendBufferSize();
@@ -25,7 +25,9 @@
 #include <socket/SocketClient.h>
 #include <base/Mutex.h>
 #include <base/XMLSupport.h>
+#include <mpegts/PidTable.h>
 
+#include <bitset>
 #include <ctime>
 #include <string>
 
@@ -156,6 +158,53 @@ class StreamClient : public base::XMLSupport {
 			return _sessionTimeout;
 		}
 
+		/// Set the TS packets per datagram requested by this client
+		/// @param packets specifies the amount or 0 for the stream default
+		void setTSPacketsPerDatagram(unsigned int packets) {
+			base::MutexLock lock(_mutex);
+			_tsPackets = packets;
+		}
+
+		/// Get the TS packets per datagram requested by this client or 0
+		unsigned int getTSPacketsPerDatagram() const {
+			base::MutexLock lock(_mutex);
+			return _tsPackets;
+		}
+
+		// =====================================================================
+		//  -- PID selection (Transponder sharing) -----------------------------
+		// =====================================================================
+
+		/// Update the PID selection of this client with the 'pids=', 'addpids='
+		/// and 'delpids=' of the request. The caller (Stream) guards the selection
+		/// @param params specifies the request parameters
+		/// @param userPIDs specifies the user PIDs of the filter, they are always
+		/// selected like the filter opens them with every request
+		void parsePIDSelection(const TransportParamVector &params,
+			const std::bitset<mpegts::PidTable::ALL_PIDS> &userPIDs);
+
+		/// Check if this client did select any PID
+		bool hasPIDSelection() const {
+			return _allPIDs || _pidSelection.any();
+		}
+
+		/// Check if this client did select the PID
+		bool isPIDSelected(int pid) const {
+			return _allPIDs || _pidSelection.test(pid);
+		}
+
+		/// Add the PID selection of this client to the pids and all flag
+		void addPIDSelectionTo(std::bitset<mpegts::PidTable::ALL_PIDS> &pids, bool &all) const {
+			pids |= _pidSelection;
+			all |= _allPIDs;
+		}
+
+		/// Clear the PID selection of this client
+		void clearPIDSelection() {
+			_pidSelection.reset();
+			_allPIDs = false;
+		}
+
 		// =====================================================================
 		//  -- HTTP member functions -------------------------------------------
 		// =====================================================================
@@ -169,6 +218,9 @@ class StreamClient : public base::XMLSupport {
 		/// Get the HTTP/RTP_TCP port of the connected client
 		int getHttpSocketPort() const;
 
+		/// Get the HTTP/RTP_TCP socket file descriptor of the connected client
+		int getHttpSocketFD() const;
+
 		/// Get the HTTP/RTP_TCP network send buffer size for this Socket
 		int getHttpNetworkSendBufferSize() const;
 
@@ -189,8 +241,11 @@ class StreamClient : public base::XMLSupport {
 		std::string  _sessionID;
 		std::string  _userAgent;
 		int          _cseq;
+		unsigned int _tsPackets;
 		SocketAttr   _rtp;
 		SocketAttr   _rtcp;
+		std::bitset<mpegts::PidTable::ALL_PIDS> _pidSelection;
+		bool         _allPIDs;
 };
 
 #endif // STREAM_CLIENT_H_INCLUDE
@@ -24,11 +24,21 @@
 #include <FwDecl.h>
 
 FW_DECL_NS0(StreamClient);
+FW_DECL_NS1(mpegts, PacketBuffer);
 FW_DECL_SP_NS1(input, Device);
 FW_DECL_SP_NS2(decrypt, dvbapi, Client);
 
 /// The class @c StreamInterface is an interface to an @c Stream
 class StreamInterface {
+	public:
+
+		/// The stages of the pipelined streaming mode
+		enum class PipelineStage {
+			Read,
+			Decrypt,
+			Send
+		};
+
 		// =======================================================================
 		// -- Constructors and destructor ----------------------------------------
 		// =======================================================================
@@ -83,6 +93,53 @@ class StreamInterface {
 		///
 		virtual double getRtpPayload() const = 0;
 
+		/// The maximum amount of RTP packets to send with one system call
+		virtual unsigned int getRtpBatchSize() const = 0;
+
+		/// The maximum time in ms a ready RTP packet may wait for its batch to fill
+		virtual unsigned int getRtpBatchAge() const = 0;
+
+		/// Should RTP/UDP try to use UDP GSO (UDP_SEGMENT) to send a batch
+		virtual bool isRtpGSOEnabled() const = 0;
+
+		/// Should RTP/UDP be paced at the bitrate derived from the PCR
+		virtual bool isRtpPacingEnabled() const = 0;
+
+		/// Should paced RTP/UDP hand the launch time of each packet to the
+		/// kernel with SO_TXTIME (needs the ETF qdisc on the outgoing device)
+		virtual bool isRtpTxTimeEnabled() const = 0;
+
+		/// Should the RTP timestamps be the media time interpolated from the PCR,
+		/// else they are taken from the wall clock
+		virtual bool isRtpPCRTimestampEnabled() const = 0;
+
+		/// Set the measured pacing bitrate (bits/s) and burstiness (peak 1ms
+		/// send rate divided by the mean send rate) of the RTP output
+		virtual void setRtpPacingStats(double bitrate, double burstiness) = 0;
+
+		/// The amount of TS packets to send in one RTP packet (datagram) or
+		/// HTTP chunk for the specified client
+		virtual unsigned int getTSPacketsPerDatagram(int clientID) const = 0;
+
+		/// Should the output read, decrypt and send in separate threads
+		virtual bool isPipelineEnabled() const = 0;
+
+		/// Get the CPU the pipeline stage should be pinned to or -1 for none
+		virtual int getPipelineCPU(PipelineStage stage) const = 0;
+
+		/// Add the amount of RTP packets that where send with one system call
+		virtual void addRtpSendCall(uint32_t packets) = 0;
+
+		/// Check if there are other sessions sharing the transponder of this stream
+		virtual bool hasConsumers() const = 0;
+
+		/// Hand a ready TS buffer of the owner to the sessions sharing it, then
+		/// the PIDs the owner did not select are purged from it
+		virtual void shareWithConsumers(mpegts::PacketBuffer &buffer) = 0;
+
+		/// Send the pending TS packets of the sessions sharing this stream
+		virtual void flushConsumers() = 0;
+
 		/// Get the stream Description string for RTCP and DESCRIBE command
 		virtual std::string attributeDescribeString() const = 0;
 
@@ -24,6 +24,7 @@
 #include <StreamClient.h>
 #include <socket/SocketClient.h>
 #include <StringConverter.h>
+#include <base/JSONSerializer.h>
 #include <input/childpipe/TSReader.h>
 #include <input/dvb/Frontend.h>
 #include <input/file/TSReader.h>
@@ -34,6 +35,7 @@
 #endif
 
 #include <random>
+#include <set>
 #include <cmath>
 
 #include <assert.h>
@@ -76,6 +78,49 @@ void StreamManager::enumerateDevices(
 	}
 }
 
+std::string StreamManager::getPIDStatisticsJSON(const int feID) const {
+	base::JSONSerializer json;
+	json.startObject();
+	json.startArrayWithName("frontends");
+	for (SpStream stream : _streamVector) {
+		if (feID == -1 || stream->getFeID().getID() == feID) {
+			stream->addPIDStatisticsToJSON(json);
+		}
+	}
+	json.endArray();
+	json.endObject();
+	return json.getString();
+}
+
+std::string StreamManager::getEPGJSON(const int feID, const int serviceID, const bool nowNext) const {
+	base::JSONSerializer json;
+	json.startObject();
+	json.startArrayWithName("frontends");
+	for (SpStream stream : _streamVector) {
+		if (feID == -1 || stream->getFeID().getID() == feID) {
+			stream->addEPGToJSON(json, serviceID, nowNext);
+		}
+	}
+	json.endArray();
+	json.endObject();
+	return json.getString();
+}
+
+std::string StreamManager::getEPGXMLTV(const int feID, const int serviceID, const bool nowNext) const {
+	std::string channels;
+	std::string programmes;
+	// The same service can be in the EPG of more frontends, add it once
+	std::set<uint64_t> added;
+	for (SpStream stream : _streamVector) {
+		if (feID == -1 || stream->getFeID().getID() == feID) {
+			stream->addEPGToXMLTV(channels, programmes, added, serviceID, nowNext);
+		}
+	}
+	return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+		"<!DOCTYPE tv SYSTEM \"xmltv.dtd\">\r\n"
+		"<tv generator-info-name=\"SatPI\">\r\n" + channels + programmes + "</tv>\r\n";
+}
+
 std::string StreamManager::getXMLDeliveryString() const {
 	std::size_t dvb_s2 = 0u;
 	std::size_t dvb_t = 0u;
@@ -183,6 +228,16 @@ SpStream StreamManager::findStreamAndClientIDFor(SocketClient &socketClient, int
 	// if no index, then we have to find a suitable one
 	if (feIndex == -1) {
 		SI_LOG_INFO("Found FrondtendID: x (fe=x)  StreamID: x  SessionID: @#1", sessionID);
+		// Prefer sharing a stream that is already tuned to this transponder
+		if (newSession) {
+			for (SpStream stream : _streamVector) {
+				if (stream->streamInUse() &&
+						stream->findClientIDFor(socketClient, newSession, sessionID, clientID)) {
+					stream->getStreamClient(clientID).setSessionID(sessionID);
+					return stream;
+				}
+			}
+		}
 		for (SpStream stream : _streamVector) {
 			if (stream->findClientIDFor(socketClient, newSession, sessionID, clientID)) {
 				stream->getStreamClient(clientID).setSessionID(sessionID);
@@ -90,6 +90,20 @@ class StreamManager :
 		///
 		std::string getXMLDeliveryString() const;
 
+		/// Get the rolling per PID statistics as JSON
+		/// @param feID specifies the frontend or -1 for all of them
+		std::string getPIDStatisticsJSON(int feID) const;
+
+		/// Get the EPG index collected from the EIT as JSON
+		/// @param feID specifies the frontend or -1 for all of them
+		/// @param serviceID specifies the service or -1 for all of them
+		/// @param nowNext specifies if only the present and following event should be added
+		std::string getEPGJSON(int feID, int serviceID, bool nowNext) const;
+
+		/// Get the EPG index collected from the EIT as XMLTV document
+		/// @see getEPGJSON
+		std::string getEPGXMLTV(int feID, int serviceID, bool nowNext) const;
+
 		///
 		std::string getRTSPDescribeString() const;
 
@@ -65,6 +65,10 @@ class ChildPIPEReader {
 			return _open;
 		}
 
+		int getFD() const {
+			return _stdout;
+		}
+
 		std::size_t read(unsigned char *buffer, std::size_t size) {
 			return ::read(_stdout, buffer, size);
 		}
@@ -0,0 +1,92 @@
+/* Event.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <base/Event.h>
+
+#include <Log.h>
+#include <Utils.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <thread>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace base {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+Event::Event() :
+	_fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+	_signaled(false) {
+	// Without eventfd we fall back to sleeping for the timeout
+	if (_fd == -1) {
+		SI_LOG_PERROR("eventfd");
+	}
+}
+
+Event::~Event() {
+	CLOSE_FD(_fd);
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void Event::notify() {
+	// Only one write is needed until the waiter did consume it
+	if (_signaled.exchange(true)) {
+		return;
+	}
+	if (_fd != -1) {
+		const uint64_t one = 1;
+		if (::write(_fd, &one, sizeof(one)) == -1 && errno != EAGAIN) {
+			SI_LOG_PERROR("eventfd write");
+		}
+	}
+}
+
+bool Event::wait(const std::chrono::microseconds timeout) {
+	if (!_signaled) {
+		if (_fd == -1) {
+			std::this_thread::sleep_for(timeout);
+		} else {
+			// Round up, so a short timeout does not become a busy loop
+			pollfd pfd{_fd, POLLIN, 0};
+			const int timeoutMS = static_cast<int>((timeout.count() + 999) / 1000);
+			if (::poll(&pfd, 1, timeoutMS) == -1 && errno != EINTR) {
+				SI_LOG_PERROR("poll eventfd");
+			}
+		}
+	}
+	if (!_signaled.exchange(false)) {
+		return false;
+	}
+	if (_fd != -1) {
+		uint64_t count;
+		while (::read(_fd, &count, sizeof(count)) > 0) {}
+	}
+	return true;
+}
+
+} // namespace base
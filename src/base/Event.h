@@ -0,0 +1,69 @@
+/* Event.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef BASE_EVENT_H_INCLUDE
+#define BASE_EVENT_H_INCLUDE BASE_EVENT_H_INCLUDE
+
+#include <atomic>
+#include <chrono>
+
+namespace base {
+
+/// The class @c Event wraps an eventfd, so a thread can sleep until another
+/// thread signals that there is work instead of polling for it. Signals that
+/// are given while nobody is waiting are kept until the next @see wait
+class Event {
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	public:
+
+		Event();
+
+		virtual ~Event();
+
+		Event(const Event&) = delete;
+
+		Event &operator=(const Event&) = delete;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Wake up the thread that waits (or will wait next) on this event
+		void notify();
+
+		/// Wait until the event is signaled or the timeout elapsed
+		/// @param timeout specifies the maximum time to wait
+		/// @return true if the event was signaled else false
+		bool wait(std::chrono::microseconds timeout);
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		int _fd;
+		std::atomic_bool _signaled;
+};
+
+} // namespace base
+
+#endif // BASE_EVENT_H_INCLUDE
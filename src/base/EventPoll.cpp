@@ -0,0 +1,167 @@
+/* EventPoll.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <base/EventPoll.h>
+
+#include <Log.h>
+#include <Utils.h>
+
+#include <cerrno>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace base {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+EventPoll::EventPoll() :
+	_fdEPoll(-1),
+	_fdTimer(-1),
+	_fdWakeUp(-1),
+	_numberOfEvents(0),
+	_timerExpired(false) {}
+
+EventPoll::~EventPoll() {
+	close();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+bool EventPoll::open() {
+	if (isOpen()) {
+		return true;
+	}
+	_fdEPoll = ::epoll_create1(EPOLL_CLOEXEC);
+	if (_fdEPoll == -1) {
+		SI_LOG_PERROR("epoll_create1");
+		return false;
+	}
+	_fdTimer = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (_fdTimer == -1) {
+		SI_LOG_PERROR("timerfd_create");
+		close();
+		return false;
+	}
+	_fdWakeUp = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (_fdWakeUp == -1) {
+		SI_LOG_PERROR("timerfd_create");
+		close();
+		return false;
+	}
+	if (!addFD(_fdTimer, EPOLLIN) || !addFD(_fdWakeUp, EPOLLIN)) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void EventPoll::close() {
+	CLOSE_FD(_fdWakeUp);
+	CLOSE_FD(_fdTimer);
+	CLOSE_FD(_fdEPoll);
+	_numberOfEvents = 0;
+	_timerExpired = false;
+}
+
+bool EventPoll::addFD(const int fd, const uint32_t events) {
+	epoll_event ev{};
+	ev.events = events;
+	ev.data.fd = fd;
+	if (::epoll_ctl(_fdEPoll, EPOLL_CTL_ADD, fd, &ev) == 0) {
+		return true;
+	}
+	if (errno == EEXIST) {
+		return ::epoll_ctl(_fdEPoll, EPOLL_CTL_MOD, fd, &ev) == 0;
+	}
+	SI_LOG_PERROR("epoll_ctl add");
+	return false;
+}
+
+void EventPoll::removeFD(const int fd) {
+	// A closed fd is removed by the kernel already, so ignore errors here
+	::epoll_ctl(_fdEPoll, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+bool EventPoll::setTimerInterval(const std::chrono::microseconds interval) {
+	const long sec  = interval.count() / 1000000;
+	const long nsec = (interval.count() % 1000000) * 1000;
+	itimerspec spec{};
+	spec.it_interval.tv_sec  = sec;
+	spec.it_interval.tv_nsec = nsec;
+	spec.it_value = spec.it_interval;
+	if (::timerfd_settime(_fdTimer, 0, &spec, nullptr) == -1) {
+		SI_LOG_PERROR("timerfd_settime");
+		return false;
+	}
+	return true;
+}
+
+bool EventPoll::setWakeUpTime(const std::chrono::steady_clock::time_point time) {
+	// std::chrono::steady_clock uses CLOCK_MONOTONIC, so use it as absolute time.
+	// Zero would disarm the timer, so use at least 1 ns
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		time.time_since_epoch()).count();
+	itimerspec spec{};
+	spec.it_value.tv_sec  = ns / 1000000000;
+	spec.it_value.tv_nsec = (ns > 0) ? (ns % 1000000000) : 1;
+	if (::timerfd_settime(_fdWakeUp, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) {
+		SI_LOG_PERROR("timerfd_settime");
+		return false;
+	}
+	return true;
+}
+
+int EventPoll::wait(const int timeoutMS) {
+	_timerExpired = false;
+	_numberOfEvents = ::epoll_wait(_fdEPoll, _events, MAX_EVENTS, timeoutMS);
+	if (_numberOfEvents == -1) {
+		_numberOfEvents = 0;
+		if (errno != EINTR) {
+			SI_LOG_PERROR("epoll_wait");
+		}
+		return -1;
+	}
+	for (int i = 0; i < _numberOfEvents; ++i) {
+		if (_events[i].data.fd == _fdTimer) {
+			uint64_t expirations;
+			while (::read(_fdTimer, &expirations, sizeof(expirations)) > 0) {}
+			_timerExpired = true;
+		} else if (_events[i].data.fd == _fdWakeUp) {
+			uint64_t expirations;
+			while (::read(_fdWakeUp, &expirations, sizeof(expirations)) > 0) {}
+		}
+	}
+	return _numberOfEvents;
+}
+
+uint32_t EventPoll::getEvents(const int fd) const {
+	for (int i = 0; i < _numberOfEvents; ++i) {
+		if (_events[i].data.fd == fd) {
+			return _events[i].events;
+		}
+	}
+	return 0;
+}
+
+} // namespace base
@@ -0,0 +1,118 @@
+/* EventPoll.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef BASE_EVENTPOLL_H_INCLUDE
+#define BASE_EVENTPOLL_H_INCLUDE BASE_EVENTPOLL_H_INCLUDE
+
+#include <chrono>
+#include <cstdint>
+
+#include <sys/epoll.h>
+
+namespace base {
+
+/// The class @c EventPoll wraps an epoll instance together with a timerfd,
+/// so a thread can sleep until one of the registered file descriptors is
+/// ready, until the (periodic) deadline timer expires or until the one-shot
+/// wake up time is reached
+class EventPoll {
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	public:
+
+		EventPoll();
+
+		virtual ~EventPoll();
+
+		EventPoll(const EventPoll&) = delete;
+
+		EventPoll &operator=(const EventPoll&) = delete;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Open the epoll instance, the deadline and the wake up timer
+		/// @return true if successful else false
+		bool open();
+
+		/// Close the epoll instance, the deadline and the wake up timer
+		void close();
+
+		/// Check if the epoll instance is open and usable
+		bool isOpen() const {
+			return _fdEPoll != -1;
+		}
+
+		/// Add the file descriptor to the interest list
+		/// @param fd specifies the file descriptor to add
+		/// @param events specifies the epoll events like EPOLLIN
+		/// @return true if successful or if fd was already registered
+		bool addFD(int fd, uint32_t events);
+
+		/// Remove the file descriptor from the interest list
+		/// @param fd specifies the file descriptor to remove
+		void removeFD(int fd);
+
+		/// Arm the deadline timer to expire periodically
+		/// @param interval specifies the period, zero will disarm the timer
+		/// @return true if successful else false
+		bool setTimerInterval(std::chrono::microseconds interval);
+
+		/// Arm the one-shot wake up timer, so @see wait returns at this time
+		/// with nanosecond precision. A time in the past wakes up immediately
+		/// @param time specifies the absolute time to wake up
+		/// @return true if successful else false
+		bool setWakeUpTime(std::chrono::steady_clock::time_point time);
+
+		/// Wait until one of the registered file descriptors is ready, the
+		/// deadline timer expired or the timeout elapsed
+		/// @param timeoutMS specifies the maximum time to wait in ms
+		/// @return the number of events or -1 on error
+		int wait(int timeoutMS);
+
+		/// Get the events of the last @see wait for the requested file descriptor
+		/// @param fd specifies the file descriptor to check
+		/// @return the events or 0 if there where no events for this fd
+		uint32_t getEvents(int fd) const;
+
+		/// Check if the deadline timer expired during the last @see wait
+		bool hasTimerExpired() const {
+			return _timerExpired;
+		}
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		static constexpr int MAX_EVENTS = 8;
+		int _fdEPoll;
+		int _fdTimer;
+		int _fdWakeUp;
+		epoll_event _events[MAX_EVENTS];
+		int _numberOfEvents;
+		bool _timerExpired;
+};
+
+} // namespace base
+
+#endif // BASE_EVENTPOLL_H_INCLUDE
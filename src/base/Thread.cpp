@@ -20,7 +20,6 @@
 #include <base/Thread.h>
 
 #include <Log.h>
-#include <Unused.h>
 
 #include <chrono>
 #include <thread>
@@ -112,14 +111,17 @@ namespace base {
 		(void) pthread_join(_thread, nullptr);
 	}
 
-	void Thread::setAffinity(int UNUSED(cpu)) {
-//		if (cpu > 0 && cpu < getNumberOfProcessorsOnline()) {
-//			cpu_set_t cpus;
-//			CPU_ZERO(&cpus);
-//			CPU_SET(cpu, &cpus);
-////			pthread_setaffinity_np(_thread, sizeof(cpu_set_t), &cpus);
-//			sched_setaffinity(_thread, sizeof(cpu_set_t), &cpus);
-//		}
+	void Thread::setAffinity(int cpu) {
+		if (cpu >= 0 && cpu < sysconf(_SC_NPROCESSORS_ONLN)) {
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			CPU_SET(cpu, &cpus);
+#ifdef HAS_NP_FUNCTIONS
+			if (pthread_setaffinity_np(_thread, sizeof(cpu_set_t), &cpus) != 0) {
+				SI_LOG_ERROR("@#1: Unable to set affinity to CPU @#2", _name, cpu);
+			}
+#endif
+		}
 	}
 
 	int Thread::getScheduledAffinity() const {
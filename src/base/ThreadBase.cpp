@@ -93,12 +93,15 @@ namespace base {
 	}
 
 	void ThreadBase::setAffinity(int cpu) {
-		if (cpu > 0 && cpu < getNumberOfProcessorsOnline()) {
+		if (cpu >= 0 && cpu < getNumberOfProcessorsOnline()) {
 			cpu_set_t cpus;
 			CPU_ZERO(&cpus);
 			CPU_SET(cpu, &cpus);
-//			pthread_setaffinity_np(_thread, sizeof(cpu_set_t), &cpus);
-			sched_setaffinity(_thread, sizeof(cpu_set_t), &cpus);
+#ifdef HAS_NP_FUNCTIONS
+			if (pthread_setaffinity_np(_thread, sizeof(cpu_set_t), &cpus) != 0) {
+				SI_LOG_ERROR("@#1: Unable to set affinity to CPU @#2", _name, cpu);
+			}
+#endif
 		}
 	}
 
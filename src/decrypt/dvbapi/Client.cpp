@@ -96,6 +96,17 @@ namespace decrypt::dvbapi {
 			const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(index);
 			const int maxBatchSize = frontend->getMaximumBatchSize();
 			const std::size_t size = buffer.getNumberOfCompletedPackets();
+			// Take the active PMTs once for this buffer, the stream may replace them meanwhile
+			mpegts::PMTVector activePMTs;
+			frontend->getActivePMTs(activePMTs);
+			const auto getActivePMT = [&activePMTs](const int pid) -> mpegts::SpPMT {
+				for (const auto &[pmtPID, pmt] : activePMTs) {
+					if (pmtPID == pid) {
+						return pmt;
+					}
+				}
+				return nullptr;
+			};
 			for (std::size_t i = 0; i < size; ++i) {
 				// Get TS packet from the buffer
 				unsigned char *data = buffer.getTSPacketPtr(i);
@@ -153,7 +164,7 @@ namespace decrypt::dvbapi {
 						mpegts::TSData filterData;
 						if (frontend->findOSCamFilterData(pid, data, tableID, filter, demux, filterData)) {
 							// Don't send PAT or PMT before we have an active
-							if (pid == 0 || frontend->isMarkedAsActivePMT(pid)) {
+							if (pid == 0 || getActivePMT(pid) != nullptr) {
 							} else {
 								const unsigned char *tableData = filterData.c_str();
 								const int sectionLength = (((tableData[6] & 0x0F) << 8) | tableData[7]) + 3; // 3 = tableID + length field
@@ -182,8 +193,8 @@ namespace decrypt::dvbapi {
 							}
 						}
 
-						if (frontend->isMarkedAsActivePMT(pid)) {
-							sendPMT(index, id, *frontend->getSDTData(), *frontend->getPMTData(pid));
+						if (const mpegts::SpPMT pmt = getActivePMT(pid); pmt != nullptr) {
+							sendPMT(index, id, *frontend->getSDTData(), *pmt);
 							if (_rewritePMT) {
 								mpegts::PMT::cleanPI(data);
 							}
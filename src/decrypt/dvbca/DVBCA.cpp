@@ -164,7 +164,7 @@ static char fileFIFO[] = "/tmp/fifo";
 		mpegts::PMT::Data tableData;
 		pmt.getDataForSectionNumber(0, tableData);
 		const int programNumber = pmt.getProgramNumber();
-		const unsigned char *data = tableData.data.c_str();
+		const unsigned char *data = tableData.data;
 		const std::size_t tableSize = (data[6] & 0x0F) | data[7];
 		const mpegts::TSData progInfo = pmt.getProgramInfo();
 		const std::size_t progSize = progInfo.size();
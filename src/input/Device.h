@@ -22,6 +22,7 @@
 
 #include <Defs.h>
 #include <FwDecl.h>
+#include <Unused.h>
 #include <base/XMLSupport.h>
 #include <input/InputSystem.h>
 #include <mpegts/Filter.h>
@@ -66,6 +67,27 @@ class Device :
 		/// Check if there is data to be red from this device
 		virtual bool isDataAvailable() = 0;
 
+		/// Get the file descriptor that can be used to poll (epoll) this device
+		/// for readable data
+		/// @return the file descriptor or -1 if this device should be polled
+		/// with @see isDataAvailable, for example when it paces itself
+		virtual int getPollFD() const {
+			return -1;
+		}
+
+		/// Get a counter that changes when the poll fd is closed and opened again
+		/// without a restart of the stream, so it is registered again also when
+		/// the same fd number is given back
+		virtual uint32_t getPollFDGeneration() const {
+			return 0;
+		}
+
+		/// Check if this device has data read ahead from its poll fd, that is
+		/// not handed out with @see readTSPackets yet
+		virtual bool hasBufferedData() const {
+			return false;
+		}
+
 		/// Read the available data from this device
 		/// @param buffer this is the buffer were to wirite to
 		/// @param finalCall this should be the last try and should return as soon as possible
@@ -80,6 +102,13 @@ class Device :
 		/// @param params
 		virtual bool capableToTransform(const TransportParamVector& params) const = 0;
 
+		/// Check if this device is tuned to the transponder of the request, so
+		/// the request could share the data of this device
+		/// @param params
+		virtual bool isSameTransponder(const TransportParamVector& UNUSED(params)) const {
+			return false;
+		}
+
 		/// Monitor signal of this device
 		/// @return true meaning there is a Signal Lock
 		virtual bool monitorSignal(bool showStatus) = 0;
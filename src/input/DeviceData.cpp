@@ -150,6 +150,14 @@ bool DeviceData::hasDeviceDataChanged() const {
 }
 
 void DeviceData::parseAndUpdatePidsTable(FeID id, const TransportParamVector& params) {
+	const int serviceID = params.getIntParameter("service");
+	if (serviceID > 0 && serviceID <= 0xFFFF) {
+		SI_LOG_DEBUG("Frontend: @#1, Parsing service parameter: service=@#2", id, serviceID);
+		_filter.setService(id, serviceID);
+	} else {
+		// Without 'service=' the requested PIDs are streamed
+		_filter.clearService(id);
+	}
 	const std::string pidsList = params.getParameter("pids");
 	if (!pidsList.empty()) {
 		SI_LOG_DEBUG("Frontend: @#1, Parsing PID parameter: pids=@#2", id, pidsList);
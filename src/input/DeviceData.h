@@ -127,7 +127,8 @@ class DeviceData :
 		fe_delivery_system convertDeliverySystem() const;
 
 		/// General function to parse and update the pid list.
-		/// Using the request parameters "pids","addpids","delpids"
+		/// Using the request parameters "pids","addpids","delpids" and "service"
+		/// to select the PIDs of one service
 		/// @param id
 		/// @param params
 		void parseAndUpdatePidsTable(FeID id, const TransportParamVector& params);
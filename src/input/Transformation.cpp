@@ -209,6 +209,10 @@ TransportParamVector Transformation::transformStreamString(
 	if (!delpidsList.empty()) {
 		transParams.replaceParameter("delpids", delpidsList);
 	}
+	const std::string service = params.getParameter("service");
+	if (!service.empty()) {
+		transParams.replaceParameter("service", service);
+	}
 	SI_LOG_INFO("Frontend: @#1, Request Transformed to: @#2", id, uriTransform);
 	return transParams;
 }
@@ -101,23 +101,26 @@ void TSReader::addDeliverySystemCount(
 
 bool TSReader::isDataAvailable() {
 	const int pcrTimer = _deviceData.getPCRTimer();
-	const std::int64_t pcrDelta = _deviceData.getFilter().getPCRData()->getPCRDelta();
-	if (pcrDelta != 0 && pcrTimer == 0) {
-		_t2 = _t1;
-		_t1 = std::chrono::steady_clock::now();
-
-		const long interval = pcrDelta - std::chrono::duration_cast<std::chrono::microseconds>(_t1 - _t2).count();
-		if (interval > 0) {
-			std::this_thread::sleep_for(std::chrono::microseconds(interval));
-		}
-		_t1 = std::chrono::steady_clock::now();
-		_deviceData.getFilter().getPCRData()->clearPCRDelta();
+	mpegts::PCR::Clock::time_point deadline;
+	if (pcrTimer == 0 && _deviceData.getFilter().getPCRData()->getNextDeadline(deadline)) {
+		// Play the stream at the rate of its PCR
+		std::this_thread::sleep_until(deadline);
 	} else {
 		std::this_thread::sleep_for(std::chrono::microseconds(WAIT_TIMER + pcrTimer));
 	}
 	return true;
 }
 
+int TSReader::getPollFD() const {
+	// Only the 'live' pipe is polled, generated PSI and PCR/Timer pacing
+	// should keep using isDataAvailable()
+	if (_deviceData.generatePSI() || _deviceData.getPCRTimer() != 0 ||
+		_deviceData.getFilter().isPCRFilteringEnabled()) {
+		return -1;
+	}
+	return _exec.isOpen() ? _exec.getFD() : -1;
+}
+
 bool TSReader::readTSPackets(mpegts::PacketBuffer &buffer, const bool finalCall) {
 ///////////////////////
 	if (_deviceData.generatePSI()) {
@@ -194,8 +197,7 @@ bool TSReader::update() {
 		_exec.open(execPath);
 		if (_exec.isOpen()) {
 			SI_LOG_INFO("Frontend: @#1, Child PIPE - TS Reader using exec: @#2", _feID, execPath);
-			_t1 = std::chrono::steady_clock::now();
-			_t2 = _t1;
+			_deviceData.getFilter().getPCRData()->reset();
 		} else {
 			SI_LOG_ERROR("Frontend: @#1, Child PIPE - TS Reader unable to use exec: @#2", _feID, execPath);
 		}
@@ -27,7 +27,6 @@
 #include <input/childpipe/TSReaderData.h>
 
 #include <string>
-#include <chrono>
 
 FW_DECL_SP_NS2(input, childpipe, TSReader);
 
@@ -89,6 +88,8 @@ class TSReader :
 
 		virtual bool isDataAvailable() final;
 
+		virtual int getPollFD() const final;
+
 		virtual bool readTSPackets(mpegts::PacketBuffer &buffer, bool finalCall) final;
 
 		virtual bool capableOf(input::InputSystem msys) const final;
@@ -125,9 +126,6 @@ class TSReader :
 		TSReaderData _deviceData;
 		input::Transformation _transform;
 		const bool _enableUnsecureFrontends;
-
-		std::chrono::steady_clock::time_point _t1;
-		std::chrono::steady_clock::time_point _t2;
 };
 
 }
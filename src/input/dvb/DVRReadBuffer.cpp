@@ -0,0 +1,84 @@
+/* DVRReadBuffer.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/dvb/DVRReadBuffer.h>
+
+#include <mpegts/PacketBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <unistd.h>
+
+namespace input::dvb {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+DVRReadBuffer::DVRReadBuffer() :
+	_size(0),
+	_requestedSize(0),
+	_begin(0),
+	_end(0),
+	_readCalls(0),
+	_readBytes(0) {}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+ssize_t DVRReadBuffer::refill(const int fd) {
+	const std::size_t left = available();
+	// (Re)allocate the read buffer when empty and the size did change
+	if (left == 0 && _requestedSize != _size) {
+		_buffer.reset(new unsigned char[_requestedSize]);
+		_size = _requestedSize;
+	}
+	// Move the remaining part (less then one PacketBuffer) to the front, so
+	// the whole read buffer is free for the next read
+	if (left > 0 && _begin > 0) {
+		std::memmove(_buffer.get(), _buffer.get() + _begin, left);
+	}
+	_begin = 0;
+	_end = left;
+	if (_end == _size) {
+		return 0;
+	}
+	const ssize_t readSize = ::read(fd, _buffer.get() + _end, _size - _end);
+	if (readSize > 0) {
+		_end += readSize;
+		++_readCalls;
+		_readBytes += readSize;
+	}
+	return readSize;
+}
+
+std::size_t DVRReadBuffer::fill(mpegts::PacketBuffer &buffer) {
+	const std::size_t size = std::min(buffer.getAmountOfBytesToWrite(), available());
+	if (size == 0) {
+		return 0;
+	}
+	std::memcpy(buffer.getWriteBufferPtr(), _buffer.get() + _begin, size);
+	_begin += size;
+	buffer.addAmountOfBytesWritten(size);
+	return size;
+}
+
+}
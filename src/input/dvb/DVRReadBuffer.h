@@ -0,0 +1,107 @@
+/* DVRReadBuffer.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_DVB_DVRREADBUFFER_H_INCLUDE
+#define INPUT_DVB_DVRREADBUFFER_H_INCLUDE INPUT_DVB_DVRREADBUFFER_H_INCLUDE
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <sys/types.h>
+
+namespace mpegts {
+	class PacketBuffer;
+}
+
+namespace input::dvb {
+
+/// The class @c DVRReadBuffer drains the DVR with one large read into a read
+/// buffer, and fills the PacketBuffers from it. So the DVR is not read with
+/// the size of one PacketBuffer at a time.
+class DVRReadBuffer {
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	public:
+
+		DVRReadBuffer();
+
+		virtual ~DVRReadBuffer() = default;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Set the size of the read buffer, it is applied by the first
+		/// @see refill that finds the read buffer empty
+		void setSize(std::size_t size) {
+			_requestedSize = size;
+		}
+
+		/// Drop the data that is in the read buffer
+		void clear() {
+			_begin = 0;
+			_end = 0;
+		}
+
+		/// Get the amount of bytes that are in the read buffer
+		std::size_t available() const {
+			return _end - _begin;
+		}
+
+		/// Refill the read buffer with one read of all the free space in it
+		/// @param fd specifies the DVR to read from
+		/// @return the result of the read, so -1 with errno set on an error
+		ssize_t refill(int fd);
+
+		/// Fill the buffer with the data in the read buffer
+		/// @return the amount of bytes copied into the buffer
+		std::size_t fill(mpegts::PacketBuffer &buffer);
+
+		/// Get the amount of successful reads done by @see refill
+		uint64_t getReadCalls() const {
+			return _readCalls;
+		}
+
+		/// Get the average amount of bytes read by one read
+		uint64_t getBytesPerRead() const {
+			const uint64_t calls = _readCalls;
+			return (calls == 0) ? 0 : _readBytes / calls;
+		}
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		std::unique_ptr<unsigned char[]> _buffer;
+		std::size_t _size;
+		std::size_t _requestedSize;
+		std::size_t _begin;
+		std::size_t _end;
+		std::atomic<uint64_t> _readCalls;
+		std::atomic<uint64_t> _readBytes;
+};
+
+}
+
+#endif // INPUT_DVB_DVRREADBUFFER_H_INCLUDE
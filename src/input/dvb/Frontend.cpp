@@ -25,6 +25,7 @@
 #include <Stream.h>
 #include <StringConverter.h>
 #include <mpegts/PacketBuffer.h>
+#include <mpegts/PSICache.h>
 #include <input/dvb/dvbfix.h>
 #include <input/dvb/FrontendData.h>
 #include <input/dvb/delivery/DVBC.h>
@@ -32,7 +33,11 @@
 #include <input/dvb/delivery/DVBT.h>
 #include <input/dvb/delivery/DiSEqc.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 #include <thread>
 
 #include <stdio.h>
@@ -53,8 +58,19 @@ namespace input::dvb {
 
 static constexpr unsigned int DEFAULT_DVR_BUFFER_SIZE       = 3;
 static constexpr unsigned int MAX_DVR_BUFFER_SIZE           = 3 * 10;
+static constexpr unsigned int DEFAULT_DVR_READ_BUFFER_SIZE  = 1024;
+static constexpr unsigned int MIN_DVR_READ_BUFFER_SIZE      = 256;
+static constexpr unsigned int MAX_DVR_READ_BUFFER_SIZE      = 4096;
 static constexpr unsigned long MAX_WAIT_ON_LOCK_TIMEOUT     = 3500;
 static constexpr unsigned long DEFAULT_WAIT_ON_LOCK_TIMEOUT = 1000;
+static constexpr unsigned int MAX_DMX_PID_FILTERS           = 256;
+static constexpr unsigned int DEFAULT_DMX_PID_FILTERS       = 32;
+static constexpr unsigned int MAX_FULL_TS_BITRATE           = 1000;
+static constexpr unsigned int DEFAULT_FULL_TS_BITRATE       = 0;
+static constexpr uint16_t FULL_TRANSPONDER_PID              = 0x2000;
+static constexpr unsigned int MAX_DMX_BUSY_RETRIES          = 10;
+static constexpr std::chrono::milliseconds DMX_BUSY_RETRY_DELAY(2);
+static constexpr std::chrono::milliseconds DMX_WORKER_IDLE(100);
 
 // =============================================================================
 // -- Constructors and destructor ----------------------------------------------
@@ -63,6 +79,7 @@ static constexpr unsigned long DEFAULT_WAIT_ON_LOCK_TIMEOUT = 1000;
 Frontend::Frontend(
 		FeIndex index,
 		const std::string &appDataPath,
+		mpegts::SpPSICache psiCache,
 		const std::string &fe,
 		const std::string &dvr,
 		const std::string &dmx) :
@@ -82,9 +99,32 @@ Frontend::Frontend(
 	_dvbc(0),
 	_dvbc2(0),
 	_dvrBufferSizeMB(DEFAULT_DVR_BUFFER_SIZE),
-	_waitOnLockTimeout(DEFAULT_WAIT_ON_LOCK_TIMEOUT) {
+	_dvrReadBufferSizeKB(DEFAULT_DVR_READ_BUFFER_SIZE),
+	_dvrReadGeneration(0),
+	_dvrReadGenerationSeen(0),
+	_dvrOverflows(0),
+	_waitOnLockTimeout(DEFAULT_WAIT_ON_LOCK_TIMEOUT),
+	_psiCache(psiCache),
+	_psiCacheEnabled(true),
+	_psiCachePersist(false),
+	_dmxMode(DMXMode::Auto),
+	_dmxMaxPIDFilters(DEFAULT_DMX_PID_FILTERS),
+	_fullTSMaxBitrate(DEFAULT_FULL_TS_BITRATE),
+	_dmxFullTS(false),
+	_fullTSRejected(false),
+	_fullTSBitrate(0),
+	_fullTSBytes(0),
+	_dmxRequestPending(false),
+	_pidUpdateLatency(0),
+	_pidUpdateMaxLatency(0),
+	_threadDMX(
+		StringConverter::stringFormat("DMX@#1", _feID),
+		std::bind(&Frontend::threadExecuteDMX, this)) {
 	snprintf(_fe_info.name, sizeof(_fe_info.name), "Not Set");
 	setupFrontend();
+	if (!_threadDMX.startThread()) {
+		SI_LOG_ERROR("Frontend: @#1, Error Starting DMX worker", _feID);
+	}
 #if FULL_DVB_API_VERSION >= 0x050A
 	_oldApiCallStats = false;
 #else
@@ -92,6 +132,10 @@ Frontend::Frontend(
 #endif
 }
 
+Frontend::~Frontend() {
+	_threadDMX.terminateThread();
+}
+
 // =============================================================================
 //  -- Static functions --------------------------------------------------------
 // =============================================================================
@@ -99,6 +143,7 @@ Frontend::Frontend(
 static void getAttachedFrontends(
 		StreamSpVector &streamVector,
 		const std::string &appDataPath,
+		mpegts::SpPSICache psiCache,
 		decrypt::dvbapi::SpClient decrypt,
 		const std::string &path,
 		const std::string &startPath) {
@@ -113,13 +158,13 @@ static void getAttachedFrontends(
 	const std::string fe0 = StringConverter::stringFormat(FRONTEND.c_str(), 0, 0);
 	const std::string dvr0 = StringConverter::stringFormat(DVR.c_str(), 0, 0);
 	const std::string dmx0 = StringConverter::stringFormat(DMX.c_str(), 0, 0);
-	input::dvb::SpFrontend frontend0 = std::make_shared<input::dvb::Frontend>(0, appDataPath, fe0, dvr0, dmx0);
+	input::dvb::SpFrontend frontend0 = std::make_shared<input::dvb::Frontend>(0, appDataPath, psiCache, fe0, dvr0, dmx0);
 	streamVector.push_back(Stream::makeSP(frontend0, decrypt));
 
 	const std::string fe1 = StringConverter::stringFormat(FRONTEND.c_str(), 1, 0);
 	const std::string dvr1 = StringConverter::stringFormat(DVR.c_str(), 1, 0);
 	const std::string dmx1 = StringConverter::stringFormat(DMX.c_str(), 1, 0);
-	input::dvb::SpFrontend frontend1 = std::make_shared<input::dvb::Frontend>(1, appDataPath, fe1, dvr1, dmx1);
+	input::dvb::SpFrontend frontend1 = std::make_shared<input::dvb::Frontend>(1, appDataPath, psiCache, fe1, dvr1, dmx1);
 	streamVector.push_back(Stream::makeSP(frontend1, decrypt));
 #else
 	dirent **file_list;
@@ -145,14 +190,14 @@ static void getAttachedFrontends(
 
 							// Make new frontend here
 							const StreamSpVector::size_type size = streamVector.size();
-							const input::dvb::SpFrontend frontend = std::make_shared<input::dvb::Frontend>(size, appDataPath, fe, dvr, dmx);
+							const input::dvb::SpFrontend frontend = std::make_shared<input::dvb::Frontend>(size, appDataPath, psiCache, fe, dvr, dmx);
 							streamVector.push_back(Stream::makeSP(frontend, decrypt));
 						}
 						break;
 					case S_IFDIR:
 						// do not use dir '.' an '..'
 						if (strcmp(file_list[i]->d_name, ".") != 0 && strcmp(file_list[i]->d_name, "..") != 0) {
-							getAttachedFrontends(streamVector, appDataPath, decrypt, full_path, startPath);
+							getAttachedFrontends(streamVector, appDataPath, psiCache, decrypt, full_path, startPath);
 						}
 						break;
 					default:
@@ -177,7 +222,9 @@ void Frontend::enumerate(
 		const std::string &dvbAdapterPath) {
 	const StreamSpVector::size_type beginSize = streamVector.size();
 	SI_LOG_INFO("Detecting frontends in: @#1", dvbAdapterPath);
-	getAttachedFrontends(streamVector, appDataPath, decrypt, dvbAdapterPath, dvbAdapterPath);
+	// One PSI cache for all frontends, they may tune the same transponders
+	const mpegts::SpPSICache psiCache = std::make_shared<mpegts::PSICache>(appDataPath);
+	getAttachedFrontends(streamVector, appDataPath, psiCache, decrypt, dvbAdapterPath, dvbAdapterPath);
 	const StreamSpVector::size_type endSize = streamVector.size();
 	SI_LOG_INFO("Frontends found: @#1", endSize - beginSize);
 }
@@ -194,7 +241,20 @@ void Frontend::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "dvbversion", HEX(_dvbVersion, 4));
 
 	ADD_XML_NUMBER_INPUT(xml, "dvrbuffer", _dvrBufferSizeMB, 0, MAX_DVR_BUFFER_SIZE);
+	ADD_XML_NUMBER_INPUT(xml, "dvrReadBuffer", _dvrReadBufferSizeKB, MIN_DVR_READ_BUFFER_SIZE, MAX_DVR_READ_BUFFER_SIZE);
 	ADD_XML_NUMBER_INPUT(xml, "waitOnLockTimeout", _waitOnLockTimeout, 0, MAX_WAIT_ON_LOCK_TIMEOUT);
+	ADD_XML_CHECKBOX(xml, "psiCache", (_psiCacheEnabled ? "true" : "false"));
+	ADD_XML_CHECKBOX(xml, "psiCachePersist", (_psiCachePersist ? "true" : "false"));
+	ADD_XML_NUMBER_INPUT(xml, "dmxMode", static_cast<int>(_dmxMode), 0, 2);
+	ADD_XML_NUMBER_INPUT(xml, "dmxMaxPIDFilters", _dmxMaxPIDFilters, 1, MAX_DMX_PID_FILTERS);
+	ADD_XML_NUMBER_INPUT(xml, "fullTSMaxBitrate", _fullTSMaxBitrate, 0, MAX_FULL_TS_BITRATE);
+	ADD_XML_ELEMENT(xml, "dmxFullTS", _dmxFullTS ? "true" : "false");
+	ADD_XML_ELEMENT(xml, "dmxFullTSRejected", _fullTSRejected ? "true" : "false");
+	ADD_XML_ELEMENT(xml, "fullTSBitrate", _fullTSBitrate.load() / 1000);
+	ADD_XML_ELEMENT(xml, "pidUpdateLatency", _pidUpdateLatency.load());
+	ADD_XML_ELEMENT(xml, "pidUpdateMaxLatency", _pidUpdateMaxLatency.load());
+	ADD_XML_ELEMENT(xml, "dvrBytesPerRead", _dvrReadBuffer.getBytesPerRead());
+	ADD_XML_ELEMENT(xml, "dvrOverflows", _dvrOverflows.load());
 
 	// Channel
 	_frontendData.addToXML(xml);
@@ -213,10 +273,29 @@ void Frontend::doFromXML(const std::string &xml) {
 		_dvrBufferSizeMB = (newSize < MAX_DVR_BUFFER_SIZE) ?
 			newSize : DEFAULT_DVR_BUFFER_SIZE;
 	}
+	if (findXMLElement(xml, "dvrReadBuffer.value", element)) {
+		_dvrReadBufferSizeKB = std::clamp<unsigned long>(std::stoi(element),
+			MIN_DVR_READ_BUFFER_SIZE, MAX_DVR_READ_BUFFER_SIZE);
+	}
 	if (findXMLElement(xml, "waitOnLockTimeout.value", element)) {
 		const unsigned int c = std::stoi(element);
 		_waitOnLockTimeout = (c < MAX_WAIT_ON_LOCK_TIMEOUT) ? c : MAX_WAIT_ON_LOCK_TIMEOUT;
 	}
+	if (findXMLElement(xml, "psiCache.value", element)) {
+		_psiCacheEnabled = (element == "true") ? true : false;
+	}
+	if (findXMLElement(xml, "psiCachePersist.value", element)) {
+		_psiCachePersist = (element == "true") ? true : false;
+	}
+	if (findXMLElement(xml, "dmxMode.value", element)) {
+		_dmxMode = integerToEnum<DMXMode>(std::clamp(std::stoi(element), 0, 2));
+	}
+	if (findXMLElement(xml, "dmxMaxPIDFilters.value", element)) {
+		_dmxMaxPIDFilters = std::clamp<unsigned int>(std::stoi(element), 1, MAX_DMX_PID_FILTERS);
+	}
+	if (findXMLElement(xml, "fullTSMaxBitrate.value", element)) {
+		_fullTSMaxBitrate = std::clamp<unsigned int>(std::stoi(element), 0, MAX_FULL_TS_BITRATE);
+	}
 	for (std::size_t i = 0; i < _deliverySystem.size(); ++i) {
 		const std::string deliverySystem = StringConverter::stringFormat("deliverySystem@#1", i);
 		if (findXMLElement(xml, deliverySystem, element)) {
@@ -247,6 +326,9 @@ void Frontend::addDeliverySystemCount(
 }
 
 bool Frontend::isDataAvailable() {
+	if (hasBufferedData()) {
+		return true;
+	}
 	thread_local pollfd pfd;
 	pfd.fd = _fd_dmx;
 	pfd.events = POLLIN;
@@ -262,21 +344,69 @@ bool Frontend::isDataAvailable() {
 	return false;
 }
 
+int Frontend::getPollFD() const {
+	return _fd_dmx;
+}
+
+uint32_t Frontend::getPollFDGeneration() const {
+	return _dvrReadGeneration;
+}
+
+bool Frontend::hasBufferedData() const {
+	return _dvrReadGeneration == _dvrReadGenerationSeen && _dvrReadBuffer.available() > 0;
+}
+
+void Frontend::checkDVRReadGeneration() {
+	const uint32_t generation = _dvrReadGeneration;
+	if (generation != _dvrReadGenerationSeen) {
+		// Drop the data that was read ahead, it belongs to the old channel
+		_dvrReadGenerationSeen = generation;
+		_dvrReadBuffer.clear();
+	}
+}
+
 bool Frontend::readTSPackets(mpegts::PacketBuffer &buffer, const bool UNUSED(finalCall)) {
-	// try read maximum amount of bytes from DMX
-	const auto readSize = ::read(_fd_dmx, buffer.getWriteBufferPtr(), buffer.getAmountOfBytesToWrite());
+	checkDVRReadGeneration();
+	// Only read from the DVR when the read buffer can not fill this buffer,
+	// then it is refilled with one large read
+	if (_dvrReadBuffer.available() < buffer.getAmountOfBytesToWrite() && !readDVRData()) {
+		return false;
+	}
+	_dvrReadBuffer.fill(buffer);
+	// With the full transponder the unused PIDs are purged here, so filter
+	// every read to make room again
+	const bool fullTS = _dmxFullTS;
+	if (!buffer.full() && !fullTS) {
+		return false;
+	}
+	mpegts::Filter &filter = _frontendData.getFilter();
+	filter.filterData(_feID, buffer, fullTS);
+	if (_psiCacheEnabled && filter.hasPSIChanged()) {
+		mpegts::PSICache::Tables tables;
+		filter.getPSITables(tables);
+		_psiCache->store(getPSICacheKey(), tables, _psiCachePersist);
+	}
+	return buffer.full();
+}
+
+bool Frontend::readDVRData() {
+	_dvrReadBuffer.setSize(_dvrReadBufferSizeKB * 1024);
+	const ssize_t readSize = _dvrReadBuffer.refill(_fd_dmx);
 	if (readSize > 0) {
-		buffer.addAmountOfBytesWritten(readSize);
-		if (buffer.full()) {
-			_frontendData.getFilter().filterData(_feID, buffer, false);
-			return true;
+		if (_dmxFullTS) {
+			measureFullTSBitrate(readSize);
 		}
 	} else if (readSize < 0) {
-		SI_LOG_PERROR("Frontend: @#1, Error reading data..", _feID);
-	} else {
+		if (errno == EOVERFLOW) {
+			++_dvrOverflows;
+			SI_LOG_ERROR("Frontend: @#1, DVR buffer overflow (count: @#2)", _feID, _dvrOverflows.load());
+		} else if (errno != EAGAIN) {
+			SI_LOG_PERROR("Frontend: @#1, Error reading data..", _feID);
+		}
+	} else if (_dvrReadBuffer.available() == 0) {
 		SI_LOG_ERROR("Frontend: @#1, Error reading data: 0 Bytes available..", _feID);
 	}
-	return false;
+	return _dvrReadBuffer.available() > 0;
 }
 
 bool Frontend::capableOf(const input::InputSystem system) const {
@@ -293,6 +423,33 @@ bool Frontend::capableToTransform(const TransportParamVector& params) const {
 	return capableOf(system);
 }
 
+bool Frontend::isSameTransponder(const TransportParamVector& params) const {
+	// Transformed requests tune something else then requested, so skip them
+	if (!_tuned || _transform.isEnabled()) {
+		return false;
+	}
+	const double reqFreq = params.getDoubleParameter("freq");
+	if (reqFreq == -1.0 || std::lround(reqFreq * 1000.0) != _frontendData.getFrequency()) {
+		return false;
+	}
+	const input::InputSystem msys = params.getMSYSParameter();
+	if (msys != _frontendData.getDeliverySystem()) {
+		return false;
+	}
+	const std::string pol = params.getParameter("pol");
+	if (!pol.empty() && pol[0] != _frontendData.getPolarizationChar()) {
+		return false;
+	}
+	const int src = params.getIntParameter("src");
+	if (((src >= 1 && src <= 255) ? src : 1) != _frontendData.getDiSEqcSource()) {
+		return false;
+	}
+	const int isId = params.getIntParameter("isi");
+	const int plpId = params.getIntParameter("plp");
+	return (isId == -1 ? FrontendData::NO_STREAM_ID : isId) == _frontendData.getInputStreamIdentifier() &&
+		(plpId == -1 ? FrontendData::NO_STREAM_ID : plpId) == _frontendData.getUniqueIDPlp();
+}
+
 bool Frontend::monitorSignal(const bool showStatus) {
 #if SIMU
 	(void)showStatus;
@@ -425,6 +582,8 @@ bool Frontend::update() {
 	if (_frontendData.hasDeviceDataChanged()) {
 		_frontendData.resetDeviceDataChanged();
 		_tuned = false;
+		_fullTSBitrate = 0;
+		_psiCache->save();
 		// Close active PIDs
 		closeActivePIDFilters();
 		closeDMX();
@@ -437,6 +596,14 @@ bool Frontend::update() {
 		SI_LOG_INFO("Frontend: @#1, Updating frontend (Failed)", _feID);
 		return false;
 	}
+	// Use the cached PSI tables until the stream brings them (again)
+	mpegts::Filter &filter = _frontendData.getFilter();
+	if (_psiCacheEnabled && !filter.getPATData()->isCollected()) {
+		mpegts::PSICache::Tables tables;
+		if (_psiCache->find(getPSICacheKey(), tables)) {
+			filter.preloadPSITables(_feID, tables);
+		}
+	}
 	updatePIDFilters();
 	const unsigned long time = sw.getIntervalMS();
 	SI_LOG_INFO("Frontend: @#1, Updating frontend (Finished in @#2 ms)", _feID, time);
@@ -453,8 +620,10 @@ bool Frontend::teardown() {
 	}
 	closeDMX();
 	closeFE();
+	_fullTSBitrate = 0;
 	_frontendData.initialize();
 	_transform.resetTransformFlag();
+	_psiCache->save();
 	return true;
 }
 
@@ -464,12 +633,16 @@ std::string Frontend::attributeDescribeString() const {
 }
 
 void Frontend::closeActivePIDFilters() {
+	base::MutexLock lock(_dmxMutex);
 	_frontendData.getFilter().closeActivePIDFilters(_feID,
 		// closePid lambda function
 		[&](const int pid) {
-			uint16_t p = pid;
-			if (::ioctl(_fd_dmx, DMX_REMOVE_PID, &p) != 0) {
-				SI_LOG_PERROR("Frontend: @#1, DMX_REMOVE_PID: PID @#2", _feID, PID(p));
+			if (_dmxFullTS) {
+				// Only filtered in user space
+				return true;
+			}
+			if (!ioctlDMX(DMX_REMOVE_PID, pid)) {
+				SI_LOG_PERROR("Frontend: @#1, DMX_REMOVE_PID: PID @#2", _feID, PID(pid));
 				return false;
 			}
 			return true;
@@ -481,72 +654,220 @@ void Frontend::updatePIDFilters() {
 		SI_LOG_INFO("Frontend: @#1, Update PID filters requested, but frontend not tuned!", _feID);
 		return;
 	}
+	base::MutexLock lock(_dmxMutex);
+	mpegts::Filter &filter = _frontendData.getFilter();
+	const bool fullTS = useFullTransponderDMX();
+	if (_fd_dmx == -1) {
+		_dmxFullTS = fullTS;
+	} else if (fullTS != _dmxFullTS) {
+		// Switch the demux to the other mode, all PIDs are opened again
+		SI_LOG_INFO("Frontend: @#1, Switching DMX to @#2 (@#3 PIDs, @#4 kbps)", _feID,
+			fullTS ? "full transponder" : "PID filters",
+			filter.getNumberOfRequestedPIDs(), _fullTSBitrate.load() / 1000);
+		closeDMX();
+		_dmxFullTS = fullTS;
+		filter.reopenPIDFilters();
+	}
+	if (_dmxFullTS) {
+		// Open the whole transponder once, the PIDs are selected in user space
+		filter.updatePIDFilters(_feID,
+			// openPid lambda function
+			[&](const int UNUSED(pid)) {
+				return _fd_dmx != -1 || openDMXWithPID(FULL_TRANSPONDER_PID);
+			},
+			// closePid lambda function
+			[&](const int UNUSED(pid)) {
+				return true;
+			});
+		if (!_fullTSRejected) {
+			return;
+		}
+		// The driver does not know PID 0x2000, so continue with PID filters
+		SI_LOG_INFO("Frontend: @#1, Switching DMX to PID filters", _feID);
+		_dmxFullTS = false;
+		filter.reopenPIDFilters();
+	}
+	// Let the DMX worker add and remove the PID filters, a burst of requests
+	// is handled in one pass
+	{
+		base::MutexLock requestLock(_dmxRequestMutex);
+		if (!_dmxRequestPending) {
+			_dmxRequestPending = true;
+			_dmxRequestTime = std::chrono::steady_clock::now();
+		}
+	}
+	_dmxRequestEvent.notify();
+}
+
+bool Frontend::threadExecuteDMX() {
+	if (!_dmxRequestEvent.wait(DMX_WORKER_IDLE)) {
+		return true;
+	}
+	std::chrono::steady_clock::time_point requestTime;
+	{
+		base::MutexLock requestLock(_dmxRequestMutex);
+		// Handled already by the pass of an earlier signal
+		if (!_dmxRequestPending) {
+			return true;
+		}
+		_dmxRequestPending = false;
+		requestTime = _dmxRequestTime;
+	}
+	updateDMXPIDFilters(requestTime);
+	return true;
+}
+
+void Frontend::updateDMXPIDFilters(const std::chrono::steady_clock::time_point requestTime) {
+	base::MutexLock lock(_dmxMutex);
+	// Retuned or switched to the full transponder in the meanwhile
+	if (!_tuned || _dmxFullTS) {
+		return;
+	}
+	std::size_t opened = 0;
+	std::size_t closed = 0;
 	_frontendData.getFilter().updatePIDFilters(_feID,
 		// openPid lambda function
 		[&](const int pid) {
-			uint16_t p = pid;
 			// Check if we have already a DMX open
 			if (_fd_dmx == -1) {
-				// try opening DMX, try again if fails
-				std::size_t timeout = 0;
-				while ((_fd_dmx = openDMX(_path_to_dmx)) == -1) {
-					std::this_thread::sleep_for(std::chrono::milliseconds(20));
-					++timeout;
-					if (timeout > 3) {
-						return false;
-					}
-				}
-				SI_LOG_INFO("Frontend: @#1, Opened @#2 using fd: @#3", _feID, _path_to_dmx, _fd_dmx);
-				if (_dvrBufferSizeMB > 0) {
-					const unsigned int size = _dvrBufferSizeMB * 1024 * 1024;
-					if (::ioctl(_fd_dmx, DMX_SET_BUFFER_SIZE, size) != 0) {
-						SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_BUFFER_SIZE", _feID);
-					} else {
-						SI_LOG_INFO("Frontend: @#1, Set DMX buffer size to @#2 Bytes", _feID, size);
-					}
-				}
-				// Do we run on an Set-Top Box with Enigma2, then we need to set DMX_SET_SOURCE
-				std::ifstream infoVersionFile("/proc/stb/info/version");
-				if (infoVersionFile.is_open()) {
-					int offset = 0;
-					std::ifstream offsetFile("/proc/stb/frontend/dvr_source_offset");
-					if (offsetFile.is_open()) {
-						offsetFile >> offset;
-					}
-					int n = _feID.getID() - 1;
-					if (::ioctl(_fd_dmx, DMX_SET_SOURCE, &n) != 0) {
-						SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_SOURCE with (Src: @#2 - Offset: @#3)", _feID, n, offset);
-						return false;
-					}
-					SI_LOG_INFO("Frontend: @#1, Set DMX_SET_SOURCE with (Src: @#2 - Offset: @#3)", _feID, n, offset);
-				}
-				struct dmx_pes_filter_params pesFilter{};
-				pesFilter.pid      = p;
-				pesFilter.input    = DMX_IN_FRONTEND;
-				pesFilter.output   = DMX_OUT_TSDEMUX_TAP;
-				pesFilter.pes_type = DMX_PES_OTHER;
-				pesFilter.flags    = DMX_IMMEDIATE_START;
-				if (::ioctl(_fd_dmx, DMX_SET_PES_FILTER, &pesFilter) != 0) {
-					SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_PES_FILTER for PID: @#2", _feID, PID(p));
+				if (!openDMXWithPID(pid)) {
 					return false;
 				}
-			} else if (::ioctl(_fd_dmx, DMX_ADD_PID, &p) != 0) {
-				SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_ADD_PID for PID: @#2", _feID, PID(p));
+			} else if (!ioctlDMX(DMX_ADD_PID, pid)) {
+				SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_ADD_PID for PID: @#2", _feID, PID(pid));
 				return false;
 			}
-			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			++opened;
 			return true;
 		},
 		// closePid lambda function
 		[&](const int pid) {
-			uint16_t p = pid;
-			if (::ioctl(_fd_dmx, DMX_REMOVE_PID, &p) != 0) {
-				SI_LOG_PERROR("Frontend: @#1, DMX_REMOVE_PID: PID @#2", _feID, PID(p));
+			if (!ioctlDMX(DMX_REMOVE_PID, pid)) {
+				SI_LOG_PERROR("Frontend: @#1, DMX_REMOVE_PID: PID @#2", _feID, PID(pid));
 				return false;
 			}
-			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			++closed;
 			return true;
 		});
+	if (opened + closed == 0) {
+		return;
+	}
+	const uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - requestTime).count();
+	_pidUpdateLatency = latency;
+	if (latency > _pidUpdateMaxLatency) {
+		_pidUpdateMaxLatency = latency;
+	}
+	SI_LOG_INFO("Frontend: @#1, Updated PID filters (@#2 opened, @#3 closed) in @#4 us",
+		_feID, opened, closed, latency);
+}
+
+bool Frontend::ioctlDMX(const unsigned long request, const int pid) {
+	uint16_t p = pid;
+	for (unsigned int retry = 0; ; ++retry) {
+		if (::ioctl(_fd_dmx, request, &p) == 0) {
+			return true;
+		}
+		// Only a busy demux is worth trying again
+		if (errno != EBUSY || retry == MAX_DMX_BUSY_RETRIES) {
+			return false;
+		}
+		std::this_thread::sleep_for(DMX_BUSY_RETRY_DELAY);
+	}
+}
+
+bool Frontend::openDMXWithPID(const uint16_t pid) {
+	// try opening DMX, try again if fails
+	std::size_t timeout = 0;
+	while ((_fd_dmx = openDMX(_path_to_dmx)) == -1) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		++timeout;
+		if (timeout > 3) {
+			return false;
+		}
+	}
+	SI_LOG_INFO("Frontend: @#1, Opened @#2 using fd: @#3", _feID, _path_to_dmx, _fd_dmx);
+	if (_dvrBufferSizeMB > 0) {
+		const unsigned int size = _dvrBufferSizeMB * 1024 * 1024;
+		if (::ioctl(_fd_dmx, DMX_SET_BUFFER_SIZE, size) != 0) {
+			SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_BUFFER_SIZE", _feID);
+		} else {
+			SI_LOG_INFO("Frontend: @#1, Set DMX buffer size to @#2 Bytes", _feID, size);
+		}
+	}
+	// Do we run on an Set-Top Box with Enigma2, then we need to set DMX_SET_SOURCE
+	std::ifstream infoVersionFile("/proc/stb/info/version");
+	if (infoVersionFile.is_open()) {
+		int offset = 0;
+		std::ifstream offsetFile("/proc/stb/frontend/dvr_source_offset");
+		if (offsetFile.is_open()) {
+			offsetFile >> offset;
+		}
+		int n = _feID.getID() - 1;
+		if (::ioctl(_fd_dmx, DMX_SET_SOURCE, &n) != 0) {
+			SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_SOURCE with (Src: @#2 - Offset: @#3)", _feID, n, offset);
+			return false;
+		}
+		SI_LOG_INFO("Frontend: @#1, Set DMX_SET_SOURCE with (Src: @#2 - Offset: @#3)", _feID, n, offset);
+	}
+	struct dmx_pes_filter_params pesFilter{};
+	pesFilter.pid      = pid;
+	pesFilter.input    = DMX_IN_FRONTEND;
+	pesFilter.output   = DMX_OUT_TSDEMUX_TAP;
+	pesFilter.pes_type = DMX_PES_OTHER;
+	pesFilter.flags    = DMX_IMMEDIATE_START;
+	if (::ioctl(_fd_dmx, DMX_SET_PES_FILTER, &pesFilter) != 0) {
+		SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_PES_FILTER for PID: @#2", _feID, PID(pid));
+		if (pid == FULL_TRANSPONDER_PID) {
+			// Remember it, this driver will not read the full transponder
+			SI_LOG_ERROR("Frontend: @#1, DMX does not support the full transponder, using PID filters", _feID);
+			_fullTSRejected = true;
+			CLOSE_FD(_fd_dmx);
+		}
+		return false;
+	}
+	if (pid == FULL_TRANSPONDER_PID) {
+		_fullTSBytes = 0;
+		_fullTSMeasureStart = std::chrono::steady_clock::now();
+		SI_LOG_INFO("Frontend: @#1, Reading full transponder, PIDs are filtered in user space", _feID);
+	}
+	return true;
+}
+
+bool Frontend::useFullTransponderDMX() const {
+	if (_fullTSRejected) {
+		return false;
+	}
+	switch (_dmxMode) {
+		case DMXMode::PIDFilters:
+			return false;
+		case DMXMode::FullTransponder:
+			return true;
+		default: {
+			// More PIDs then the demux can (or should) filter
+			if (_frontendData.getFilter().getNumberOfRequestedPIDs() > _dmxMaxPIDFilters) {
+				return true;
+			}
+			// When enabled, start with the full transponder to measure its
+			// bitrate, then keep it if reading all of it is cheap enough
+			if (_fullTSMaxBitrate == 0) {
+				return false;
+			}
+			const uint64_t bitrate = _fullTSBitrate;
+			return bitrate == 0 || bitrate <= _fullTSMaxBitrate * 1000000ull;
+		}
+	}
+}
+
+void Frontend::measureFullTSBitrate(const std::size_t bytes) {
+	_fullTSBytes += bytes;
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _fullTSMeasureStart).count();
+	if (elapsed >= 1000) {
+		_fullTSBitrate = (_fullTSBytes * 8 * 1000) / elapsed;
+		_fullTSBytes = 0;
+		_fullTSMeasureStart = now;
+	}
 }
 
 // =============================================================================
@@ -752,6 +1073,10 @@ int Frontend::openDMX(const std::string &path) const {
 }
 
 void Frontend::closeDMX() {
+	base::MutexLock lock(_dmxMutex);
+	// Let the stream thread drop the data that was read ahead, it belongs to
+	// the old channel
+	++_dvrReadGeneration;
 	if (_fd_dmx != -1) {
 		SI_LOG_INFO("Frontend: @#1, Closing @#2 fd: @#3", _feID, _path_to_dmx, _fd_dmx);
 		CLOSE_FD(_fd_dmx);
@@ -768,6 +1093,14 @@ bool Frontend::tune() {
 	return false;
 }
 
+std::string Frontend::getPSICacheKey() const {
+	return StringConverter::stringFormat("@#1:@#2:@#3:@#4:@#5:@#6",
+		StringConverter::delsys_to_string(_frontendData.getDeliverySystem()),
+		_frontendData.getFrequency(), _frontendData.getDiSEqcSource(),
+		_frontendData.getPolarizationChar(), _frontendData.getInputStreamIdentifier(),
+		_frontendData.getUniqueIDPlp());
+}
+
 bool Frontend::setupAndTune() {
 	if (!_tuned) {
 		base::StopWatch sw;
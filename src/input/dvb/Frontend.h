@@ -22,8 +22,12 @@
 
 #include <Defs.h>
 #include <FwDecl.h>
+#include <base/Event.h>
+#include <base/Mutex.h>
+#include <base/Thread.h>
 #include <input/Device.h>
 #include <input/Transformation.h>
+#include <input/dvb/DVRReadBuffer.h>
 #include <input/dvb/delivery/System.h>
 #include <input/dvb/FrontendData.h>
 #ifdef LIBDVBCSA
@@ -31,11 +35,15 @@
 #include <decrypt/dvbapi/ClientProperties.h>
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <string>
 
 FW_DECL_NS1(input, DeviceData);
 FW_DECL_NS3(input, dvb, delivery, System);
 
+FW_DECL_SP_NS1(mpegts, PSICache);
 FW_DECL_SP_NS2(decrypt, dvbapi, Client);
 FW_DECL_SP_NS2(input, dvb, Frontend);
 
@@ -58,11 +66,12 @@ class Frontend :
 		Frontend(
 			FeIndex index,
 			const std::string &appDataPath,
+			mpegts::SpPSICache psiCache,
 			const std::string &fe,
 			const std::string &dvr,
 			const std::string &dmx);
 
-		virtual ~Frontend() = default;
+		virtual ~Frontend();
 
 		// =========================================================================
 		//  -- Static member functions ---------------------------------------------
@@ -134,9 +143,7 @@ class Frontend :
 			const std::string &protocolName,
 			int hops) final;
 
-		virtual bool isMarkedAsActivePMT(int pid) const final;
-
-		virtual mpegts::SpPMT getPMTData(int pid) const final;
+		virtual void getActivePMTs(mpegts::PMTVector &pmts) const final;
 
 		virtual mpegts::SpSDT getSDTData() const final;
 #endif
@@ -155,12 +162,20 @@ class Frontend :
 
 		virtual bool isDataAvailable() final;
 
+		virtual int getPollFD() const final;
+
+		virtual uint32_t getPollFDGeneration() const final;
+
+		virtual bool hasBufferedData() const final;
+
 		virtual bool readTSPackets(mpegts::PacketBuffer &buffer, bool finalCall) final;
 
 		virtual bool capableOf(InputSystem system) const final;
 
 		virtual bool capableToTransform(const TransportParamVector& params) const final;
 
+		virtual bool isSameTransponder(const TransportParamVector& params) const final;
+
 		virtual bool monitorSignal(bool showStatus) final;
 
 		virtual bool hasDeviceDataChanged() const final;
@@ -202,18 +217,59 @@ class Frontend :
 		///
 		void closeDMX();
 
+		/// Refill the DVR read buffer with one read of its configured size
+		/// @return true if there is data in the read buffer
+		bool readDVRData();
+
+		/// Drop the data that was read ahead when @see closeDMX did ask for it,
+		/// this is done on the stream thread that owns the read buffer
+		void checkDVRReadGeneration();
+
 		///
 		bool tune();
 
 		///
 		bool setupAndTune();
 
+		/// Get the key of the tuned transponder for the @see PSICache
+		std::string getPSICacheKey() const;
+
+		/// Open the DMX with the first PID filter
+		/// @param pid specifies the PID to open, or 0x2000 for the full transponder
+		bool openDMXWithPID(uint16_t pid);
+
+		/// Check if the DMX should read the full transponder, so the PIDs are
+		/// only selected in user space, @see DMXMode
+		bool useFullTransponderDMX() const;
+
+		/// Measure the bitrate of the full transponder with the bytes read
+		void measureFullTSBitrate(std::size_t bytes);
+
+		/// Thread execute function of the DMX worker, it adds and removes the
+		/// PID filters requested by @see updatePIDFilters
+		bool threadExecuteDMX();
+
+		/// Add and remove the changed PIDs with the DMX PID filters
+		/// @param requestTime specifies when the update was requested
+		void updateDMXPIDFilters(std::chrono::steady_clock::time_point requestTime);
+
+		/// DMX_ADD_PID or DMX_REMOVE_PID that is tried again when the DMX is busy
+		bool ioctlDMX(unsigned long request, int pid);
+
 		// =========================================================================
 		// -- Data members ---------------------------------------------------------
 		// =========================================================================
 	private:
 
-		bool _tuned;
+		/// How the DMX is used to select the PIDs
+		enum class DMXMode {
+			Auto,            /// Full transponder when there are too many PIDs or
+			                 /// its bitrate is below fullTSMaxBitrate
+			PIDFilters,      /// One DMX PID filter per PID
+			FullTransponder  /// PID 0x2000 and select the PIDs in user space
+		};
+
+		std::atomic_bool _tuned;
 		int _fd_fe;
 		int _fd_dmx;
 		std::string _path_to_fe;
@@ -236,8 +292,34 @@ class Frontend :
 		std::size_t _dvbc2;
 
 		unsigned long _dvrBufferSizeMB;
+		unsigned long _dvrReadBufferSizeKB;
+		DVRReadBuffer _dvrReadBuffer;
+		/// Incremented by @see closeDMX, the read buffer belongs to the generation seen
+		std::atomic<uint32_t> _dvrReadGeneration;
+		uint32_t _dvrReadGenerationSeen;
+		std::atomic<uint32_t> _dvrOverflows;
 		unsigned long _waitOnLockTimeout;
 		bool _oldApiCallStats;
+		mpegts::SpPSICache _psiCache;
+		bool _psiCacheEnabled;
+		bool _psiCachePersist;
+		DMXMode _dmxMode;
+		unsigned int _dmxMaxPIDFilters;
+		unsigned int _fullTSMaxBitrate;
+		std::atomic_bool _dmxFullTS;
+		/// Set when the driver refused PID 0x2000, use PID filters from then on
+		std::atomic_bool _fullTSRejected;
+		std::atomic<uint64_t> _fullTSBitrate;
+		uint64_t _fullTSBytes;
+		std::chrono::steady_clock::time_point _fullTSMeasureStart;
+		base::Mutex _dmxMutex;
+		base::Mutex _dmxRequestMutex;
+		base::Event _dmxRequestEvent;
+		bool _dmxRequestPending;
+		std::chrono::steady_clock::time_point _dmxRequestTime;
+		std::atomic<uint64_t> _pidUpdateLatency;     /// usec
+		std::atomic<uint64_t> _pidUpdateMaxLatency;  /// usec
+		base::Thread _threadDMX;
 };
 
 }
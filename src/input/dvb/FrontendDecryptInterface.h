@@ -22,10 +22,10 @@
 
 #include <Defs.h>
 #include <FwDecl.h>
+#include <mpegts/PMT.h>
 
 FW_DECL_NS0(dvbcsa_bs_key_s);
 
-FW_DECL_SP_NS1(mpegts, PMT);
 FW_DECL_SP_NS1(mpegts, SDT);
 FW_DECL_SP_NS2(input, dvb, FrontendDecryptInterface);
 
@@ -105,11 +105,8 @@ class FrontendDecryptInterface {
 			const std::string &protocolName,
 			int hops) = 0;
 
-		///
-		virtual bool isMarkedAsActivePMT(int pid) const = 0;
-
-		///
-		virtual mpegts::SpPMT getPMTData(int pid) const = 0;
+		/// Get a snapshot of the active PMTs, @see mpegts::Filter::getActivePMTs
+		virtual void getActivePMTs(mpegts::PMTVector &pmts) const = 0;
 
 		///
 		virtual mpegts::SpSDT getSDTData() const = 0;
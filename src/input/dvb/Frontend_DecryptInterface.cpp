@@ -99,12 +99,8 @@ void Frontend::setECMInfo(int pid, int serviceID, int caID, int provID, int emcT
 		cardSystem, readerName, sourceName, protocolName, hops);
 }
 
-bool Frontend::isMarkedAsActivePMT(int pid) const {
-	return _frontendData.getFilter().isMarkedAsActivePMT(pid);
-}
-
-mpegts::SpPMT Frontend::getPMTData(int pid) const {
-	return _frontendData.getFilter().getPMTData(pid);
+void Frontend::getActivePMTs(mpegts::PMTVector &pmts) const {
+	_frontendData.getFilter().getActivePMTs(pmts);
 }
 
 mpegts::SpSDT Frontend::getSDTData() const {
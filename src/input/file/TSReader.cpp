@@ -94,17 +94,10 @@ void TSReader::addDeliverySystemCount(
 }
 
 bool TSReader::isDataAvailable() {
-	const std::int64_t pcrDelta = _deviceData.getFilter().getPCRData()->getPCRDelta();
-	if (pcrDelta != 0) {
-		_t2 = _t1;
-		_t1 = std::chrono::steady_clock::now();
-
-		const long interval = pcrDelta - std::chrono::duration_cast<std::chrono::microseconds>(_t1 - _t2).count();
-		if (interval > 0) {
-			std::this_thread::sleep_for(std::chrono::microseconds(interval));
-		}
-		_t1 = std::chrono::steady_clock::now();
-		_deviceData.getFilter().getPCRData()->clearPCRDelta();
+	mpegts::PCR::Clock::time_point deadline;
+	if (_deviceData.getFilter().getPCRData()->getNextDeadline(deadline)) {
+		// Play the stream at the rate of its PCR
+		std::this_thread::sleep_until(deadline);
 	} else {
 		std::this_thread::sleep_for(std::chrono::microseconds(150));
 	}
@@ -168,8 +161,7 @@ bool TSReader::update() {
 			_file.open(filePath, std::ifstream::binary | std::ifstream::in);
 			if (_file.is_open()) {
 				SI_LOG_INFO("Frontend: @#1, TS Reader using path: @#2", _feID, filePath);
-				_t1 = std::chrono::steady_clock::now();
-				_t2 = _t1;
+				_deviceData.getFilter().getPCRData()->reset();
 			} else {
 				SI_LOG_ERROR("Frontend: @#1, TS Reader unable to open path: @#2", _feID, filePath);
 			}
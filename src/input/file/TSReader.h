@@ -26,7 +26,6 @@
 #include <input/file/TSReaderData.h>
 
 #include <string>
-#include <chrono>
 #include <fstream>
 
 FW_DECL_SP_NS2(input, file, TSReader);
@@ -125,9 +124,6 @@ class TSReader :
 		TSReaderData _deviceData;
 		input::Transformation _transform;
 		const bool _enableUnsecureFrontends;
-
-		std::chrono::steady_clock::time_point _t1;
-		std::chrono::steady_clock::time_point _t2;
 };
 
 }
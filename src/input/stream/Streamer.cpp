@@ -103,6 +103,10 @@ bool Streamer::isDataAvailable() {
 	return false;
 }
 
+int Streamer::getPollFD() const {
+	return _udpMultiListen.getFD();
+}
+
 bool Streamer::readTSPackets(mpegts::PacketBuffer &buffer, const bool finalCall) {
 	if (_udpMultiListen.getFD() == -1) {
 		return false;
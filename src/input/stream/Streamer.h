@@ -90,6 +90,8 @@ class Streamer :
 
 		virtual bool isDataAvailable() final;
 
+		virtual int getPollFD() const final;
+
 		virtual bool readTSPackets(mpegts::PacketBuffer &buffer, bool finalCall) final;
 
 		virtual bool capableOf(input::InputSystem msys) const final;
@@ -0,0 +1,202 @@
+/* CRC32.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/CRC32.h>
+
+#include <Log.h>
+
+#include <array>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+	#define CRC32_PCLMUL
+	#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+	#define CRC32_ARMV8
+	#include <arm_acle.h>
+	#include <asm/hwcap.h>
+	#include <sys/auxv.h>
+#endif
+
+namespace mpegts {
+
+namespace {
+
+using Table = std::array<std::array<uint32_t, 256>, 8>;
+
+/// Table k has the CRC of byte b followed by k zero bytes
+constexpr Table makeTables() {
+	Table table{};
+	for (uint32_t b = 0; b < 256; ++b) {
+		uint32_t crc = b << 24;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc & 0x80000000) ? (crc << 1) ^ CRC32::POLYNOMIAL : (crc << 1);
+		}
+		table[0][b] = crc;
+	}
+	for (std::size_t k = 1; k < table.size(); ++k) {
+		for (std::size_t b = 0; b < 256; ++b) {
+			const uint32_t prev = table[k - 1][b];
+			table[k][b] = (prev << 8) ^ table[0][prev >> 24];
+		}
+	}
+	return table;
+}
+
+constexpr Table TABLE = makeTables();
+
+inline uint32_t readBE32(const unsigned char *data) {
+	return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+	       (static_cast<uint32_t>(data[2]) <<  8) |  static_cast<uint32_t>(data[3]);
+}
+
+using CalculateFunc = uint32_t (*)(const unsigned char *, std::size_t);
+
+struct Implementation {
+	const char *name;
+	CalculateFunc calculate;
+};
+
+uint32_t calculateSliceBy8(const unsigned char *data, const std::size_t len) {
+	return CRC32::calculateSliceBy8(CRC32::INITIAL, data, len);
+}
+
+#if defined(CRC32_PCLMUL)
+
+/// x^n mod P, to fold the data n bits further
+constexpr uint64_t xPowModP(const unsigned int n) {
+	uint32_t r = 1;
+	for (unsigned int i = 0; i < n; ++i) {
+		r = (r & 0x80000000) ? (r << 1) ^ CRC32::POLYNOMIAL : (r << 1);
+	}
+	return r;
+}
+
+/// Fold 16 bytes at a time with carry-less multiplication, the remaining
+/// bytes (and the last 64 bits) are done with the tables
+__attribute__((target("pclmul,ssse3")))
+uint32_t calculatePCLMUL(const unsigned char *data, std::size_t len) {
+	if (len < 32) {
+		return calculateSliceBy8(data, len);
+	}
+	// Data is MSB first, so reverse the bytes to get the first byte on top
+	const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	const __m128i fold128 = _mm_set_epi64x(xPowModP(192), xPowModP(128));
+	const __m128i fold96_64 = _mm_set_epi64x(xPowModP(64), xPowModP(96));
+
+	// The initial value is the same as inverting the first 32 bits
+	__m128i acc = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), reverse);
+	acc = _mm_xor_si128(acc, _mm_set_epi32(static_cast<int>(CRC32::INITIAL), 0, 0, 0));
+	data += 16;
+	len -= 16;
+	for (; len >= 16; data += 16, len -= 16) {
+		const __m128i next = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), reverse);
+		acc = _mm_xor_si128(next, _mm_xor_si128(
+			_mm_clmulepi64_si128(acc, fold128, 0x11),
+			_mm_clmulepi64_si128(acc, fold128, 0x00)));
+	}
+	// Reduce 128 bits times x^32 to 64 bits
+	__m128i r = _mm_xor_si128(_mm_clmulepi64_si128(acc, fold96_64, 0x01),
+		_mm_slli_si128(_mm_move_epi64(acc), 4));
+	r = _mm_xor_si128(_mm_clmulepi64_si128(_mm_srli_si128(r, 8), fold96_64, 0x10),
+		_mm_move_epi64(r));
+	const uint64_t v = static_cast<uint64_t>(_mm_cvtsi128_si64(r));
+
+	// The upper 32 bits mod P with the table, then continue with the rest
+	const uint32_t hi = static_cast<uint32_t>(v >> 32);
+	uint32_t crc = TABLE[3][hi >> 24] ^ TABLE[2][(hi >> 16) & 0xff] ^
+		TABLE[1][(hi >> 8) & 0xff] ^ TABLE[0][hi & 0xff];
+	crc ^= static_cast<uint32_t>(v);
+	return CRC32::calculateSliceBy8(crc, data, len);
+}
+
+#endif
+
+#if defined(CRC32_ARMV8)
+
+/// The CRC32 instructions work LSB first (reflected), so feed them the bit
+/// reversed bytes and reverse the result back
+__attribute__((target("+crc")))
+uint32_t calculateARMv8(const unsigned char *data, std::size_t len) {
+	uint32_t crc = __rbit(CRC32::INITIAL);
+	for (; len >= 8; data += 8, len -= 8) {
+		uint64_t word;
+		__builtin_memcpy(&word, data, sizeof(word));
+		crc = __crc32d(crc, __builtin_bswap64(__rbitll(word)));
+	}
+	for (; len > 0; ++data, --len) {
+		crc = __crc32b(crc, __rbit(*data) >> 24);
+	}
+	return __rbit(crc);
+}
+
+#endif
+
+Implementation selectImplementation() {
+#if defined(CRC32_PCLMUL)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3")) {
+		return {"PCLMULQDQ", calculatePCLMUL};
+	}
+#elif defined(CRC32_ARMV8)
+	if ((::getauxval(AT_HWCAP) & HWCAP_CRC32) != 0) {
+		return {"ARMv8 CRC32", calculateARMv8};
+	}
+#endif
+	return {"Slice-by-8", calculateSliceBy8};
+}
+
+const Implementation &getImplementation() {
+	static const Implementation implementation = [] {
+		const Implementation selected = selectImplementation();
+		SI_LOG_INFO("CRC32 using @#1", selected.name);
+		return selected;
+	}();
+	return implementation;
+}
+
+}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+uint32_t CRC32::calculate(const unsigned char *data, const std::size_t len) {
+	return getImplementation().calculate(data, len);
+}
+
+const char *CRC32::getImplementationName() {
+	return getImplementation().name;
+}
+
+uint32_t CRC32::calculateSliceBy8(uint32_t crc, const unsigned char *data, std::size_t len) {
+	for (; len >= 8; data += 8, len -= 8) {
+		const uint32_t one = crc ^ readBE32(data);
+		const uint32_t two = readBE32(data + 4);
+		crc = TABLE[7][one >> 24] ^ TABLE[6][(one >> 16) & 0xff] ^
+		      TABLE[5][(one >> 8) & 0xff] ^ TABLE[4][one & 0xff] ^
+		      TABLE[3][two >> 24] ^ TABLE[2][(two >> 16) & 0xff] ^
+		      TABLE[1][(two >> 8) & 0xff] ^ TABLE[0][two & 0xff];
+	}
+	for (; len > 0; ++data, --len) {
+		crc = (crc << 8) ^ TABLE[0][(crc >> 24) ^ *data];
+	}
+	return crc;
+}
+
+}
@@ -0,0 +1,60 @@
+/* CRC32.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_CRC32_H_INCLUDE
+#define MPEGTS_CRC32_H_INCLUDE MPEGTS_CRC32_H_INCLUDE
+
+#include <cstdint>
+#include <cstddef>
+
+namespace mpegts {
+
+/// The class @c CRC32 calculates the MPEG-2 CRC32 (polynomial 0x04C11DB7, MSB
+/// first, initial value 0xFFFFFFFF) of PSI sections. A PCLMULQDQ (x86) or
+/// CRC32 instruction (ARMv8) version is selected at runtime for this CPU,
+/// else slice-by-8 is used.
+class CRC32 {
+		// =====================================================================
+		//  -- Static member functions -----------------------------------------
+		// =====================================================================
+	public:
+
+		/// Calculate the CRC32 of data
+		static uint32_t calculate(const unsigned char *data, std::size_t len);
+
+		/// Get the name of the implementation selected for this CPU
+		static const char *getImplementationName();
+
+		/// Slice-by-8 version of @see calculate, that works on any CPU
+		/// @param crc specifies the CRC of the previous data or 0xFFFFFFFF
+		static uint32_t calculateSliceBy8(uint32_t crc, const unsigned char *data, std::size_t len);
+
+		// =====================================================================
+		//  -- Data members ----------------------------------------------------
+		// =====================================================================
+	public:
+
+		static constexpr uint32_t POLYNOMIAL = 0x04C11DB7;
+		static constexpr uint32_t INITIAL = 0xFFFFFFFF;
+
+};
+
+}
+
+#endif // MPEGTS_CRC32_H_INCLUDE
@@ -0,0 +1,475 @@
+/* EIT.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/EIT.h>
+
+#include <StringConverter.h>
+#include <mpegts/SDT.h>
+#include <mpegts/TDT.h>
+#include <mpegts/TableData.h>
+
+#include <algorithm>
+
+namespace mpegts {
+
+static constexpr std::size_t MAX_SECTION_SIZE = 4096;
+static constexpr std::size_t SECTION_HEADER_SIZE = 14;
+static constexpr std::size_t EVENT_HEADER_SIZE = 12;
+
+/// Get the DVB text as UTF-8 without the DVB control codes, a CR/LF
+/// (0x8A) becomes a space
+static std::string getText(const unsigned char *ptr, const std::size_t len) {
+	std::string str;
+	// Keep the character table bytes, UTF-8 text has no control codes to remove
+	const std::size_t prefix = (len == 0 || ptr[0] >= 0x20) ? 0 :
+		(ptr[0] == 0x10) ? 3 : (ptr[0] == 0x1F) ? 2 : 1;
+	if (prefix > len || (prefix == 1 && ptr[0] == 0x15)) {
+		TableData::copyToUTF8(str, ptr, len);
+		return str;
+	}
+	unsigned char text[256];
+	std::copy(ptr, ptr + prefix, text);
+	std::size_t size = prefix;
+	for (std::size_t i = prefix; i < len; ++i) {
+		if (ptr[i] == 0x8A) {
+			text[size++] = ' ';
+		} else if (ptr[i] >= 0x20 && (ptr[i] < 0x80 || ptr[i] > 0x9F)) {
+			text[size++] = ptr[i];
+		}
+	}
+	TableData::copyToUTF8(str, text, size);
+	return str;
+}
+
+static std::string getXMLTVTime(const std::time_t time) {
+	std::tm tm;
+	char str[32];
+	::gmtime_r(&time, &tm);
+	std::strftime(str, sizeof(str), "%Y%m%d%H%M%S +0000", &tm);
+	return str;
+}
+
+static std::string makeXMLTVString(const std::string &str) {
+	std::string xml;
+	xml.reserve(str.size());
+	for (const char c : str) {
+		switch (c) {
+			case '&':  xml += "&amp;";  break;
+			case '<':  xml += "&lt;";   break;
+			case '>':  xml += "&gt;";   break;
+			case '\"': xml += "&quot;"; break;
+			default:   xml += c;        break;
+		}
+	}
+	return xml;
+}
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+EIT::EIT(const TDT &clock) :
+	_clock(clock) {
+	_section.reserve(MAX_SECTION_SIZE);
+	clear();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void EIT::clear() {
+	base::MutexLock lock(_mutex);
+	_section.clear();
+	_cc = -1;
+	_subTables.clear();
+	_services.clear();
+	_updateCount = 0;
+	_strings.clear();
+	_stringIndex.clear();
+	_stringBytes = 0;
+	_compactAt = MAX_STRINGS;
+	// Index 0 is the empty string
+	intern("");
+}
+
+void EIT::collectData(const unsigned char *data) {
+	base::MutexLock lock(_mutex);
+	// Skip packets without payload
+	if ((data[3] & 0x10) == 0) {
+		return;
+	}
+	std::size_t offset = 4;
+	if ((data[3] & 0x20) == 0x20) {
+		offset += 1 + data[4];
+	}
+	if (offset >= 188) {
+		return;
+	}
+	const unsigned char *payload = data + offset;
+	std::size_t len = 188 - offset;
+
+	const int cc = data[3] & 0x0F;
+	const bool ccOK = (_cc == -1 || cc == ((_cc + 1) & 0x0F));
+	_cc = cc;
+
+	if ((data[1] & 0x40) == 0x40) {
+		// Payload Unit Start, the pointer field gives the begin of the next section
+		const std::size_t pointer = payload[0];
+		++payload;
+		--len;
+		if (pointer > len) {
+			_section.clear();
+			return;
+		}
+		if (!_section.empty() && ccOK) {
+			const unsigned char *rest = payload;
+			std::size_t restLen = pointer;
+			if (addSectionData(rest, restLen)) {
+				parseSection();
+			}
+		}
+		_section.clear();
+		payload += pointer;
+		len -= pointer;
+		// More sections can start in this packet, stuffing ends them
+		while (len > 0 && payload[0] != 0xFF) {
+			if (!addSectionData(payload, len)) {
+				break;
+			}
+			parseSection();
+			_section.clear();
+		}
+	} else if (!_section.empty()) {
+		if (!ccOK) {
+			_section.clear();
+			return;
+		}
+		if (addSectionData(payload, len)) {
+			parseSection();
+			_section.clear();
+		}
+	}
+}
+
+bool EIT::addSectionData(const unsigned char *&data, std::size_t &len) {
+	if (_section.size() < 3) {
+		const std::size_t size = std::min(len, 3 - _section.size());
+		_section.insert(_section.end(), data, data + size);
+		data += size;
+		len -= size;
+		if (_section.size() < 3) {
+			return false;
+		}
+	}
+	const std::size_t sectionLength = (((_section[1] & 0x0F) << 8) | _section[2]) + 3;
+	if (sectionLength > MAX_SECTION_SIZE) {
+		_section.clear();
+		len = 0;
+		return false;
+	}
+	const std::size_t size = std::min(len, sectionLength - _section.size());
+	_section.insert(_section.end(), data, data + size);
+	data += size;
+	len -= size;
+	return _section.size() == sectionLength;
+}
+
+void EIT::parseSection() {
+	const unsigned char *ptr = _section.data();
+	const std::size_t size = _section.size();
+	const int tableID = ptr[0];
+	// Only the 'current' EIT sections (actual/other, p/f and schedule)
+	if (tableID < TableData::EIT1_ID || tableID > 0x6F ||
+			size < SECTION_HEADER_SIZE + 4 || (ptr[5] & 0x01) == 0) {
+		return;
+	}
+	const uint64_t serviceID = (ptr[3] << 8) | ptr[4];
+	const int version = (ptr[5] & 0x3E) >> 1;
+	const std::size_t secNr = ptr[6];
+	const uint64_t tsID = (ptr[8] << 8) | ptr[9];
+	const uint64_t onID = (ptr[10] << 8) | ptr[11];
+	const uint64_t key = (onID << 32) | (tsID << 16) | serviceID;
+	const uint64_t subTableKey = (static_cast<uint64_t>(tableID) << 48) | key;
+
+	// Skip the sections we already have, without calculating the CRC again
+	const auto s = _subTables.find(subTableKey);
+	const bool known = s != _subTables.end();
+	if (known && s->second.version == version && s->second.sections[secNr]) {
+		return;
+	}
+	if (TableData::calculateCRC32(ptr, size) != 0) {
+		return;
+	}
+	SubTable &subTable = _subTables[subTableKey];
+	if (!known || subTable.version != version) {
+		subTable.version = version;
+		subTable.sections.reset();
+	}
+	subTable.sections[secNr] = true;
+
+	const std::time_t now = _clock.getUTCTime();
+	Service &service = _services[key];
+	service.updated = ++_updateCount;
+	EventVector &events = service.events;
+	// Remove the events that are over
+	events.erase(events.begin(), std::find_if(events.begin(), events.end(),
+		[now](const Event &e) {
+			return e.start + static_cast<std::time_t>(e.duration) + EXPIRE_TIME > now;
+		}));
+
+	const std::size_t end = size - 4;
+	std::size_t i = SECTION_HEADER_SIZE;
+	while (i + EVENT_HEADER_SIZE <= end) {
+		const std::size_t descEnd = i + EVENT_HEADER_SIZE + (((ptr[i + 10] & 0x0F) << 8) | ptr[i + 11]);
+		if (descEnd > end) {
+			break;
+		}
+		Event event;
+		event.eventID = (ptr[i] << 8) | ptr[i + 1];
+		event.start = TableData::getUTCTime(&ptr[i + 2]);
+		event.duration = (TableData::fromBCD(ptr[i + 7]) * 3600) + (TableData::fromBCD(ptr[i + 8]) * 60) + TableData::fromBCD(ptr[i + 9]);
+		event.running = ptr[i + 10] >> 5;
+		event.scrambled = (ptr[i + 10] & 0x10) == 0x10;
+		event.title = 0;
+		event.text = 0;
+		event.language = 0;
+		const bool undefinedStart = ptr[i + 2] == 0xFF && ptr[i + 3] == 0xFF;
+
+		std::string extendedText;
+		for (std::size_t j = i + EVENT_HEADER_SIZE; j + 2 <= descEnd; ) {
+			const int tag = ptr[j];
+			const std::size_t descLength = ptr[j + 1];
+			const unsigned char *desc = &ptr[j + 2];
+			j += 2 + descLength;
+			if (j > descEnd) {
+				break;
+			}
+			if (tag == 0x4D && descLength >= 5) {
+				// Short event descriptor
+				const std::size_t nameLength = desc[3];
+				if (4 + nameLength < descLength) {
+					const std::size_t textLength = desc[4 + nameLength];
+					if (5 + nameLength + textLength <= descLength) {
+						event.language = intern(std::string(reinterpret_cast<const char *>(desc), 3));
+						event.title = intern(getText(&desc[4], nameLength));
+						event.text = intern(getText(&desc[5 + nameLength], textLength));
+					}
+				}
+			} else if (tag == 0x4E && descLength >= 6) {
+				// Extended event descriptor, only the text after the items
+				const std::size_t itemsLength = desc[4];
+				if (5 + itemsLength < descLength) {
+					const std::size_t textLength = desc[5 + itemsLength];
+					if (6 + itemsLength + textLength <= descLength) {
+						extendedText += getText(&desc[6 + itemsLength], textLength);
+					}
+				}
+			}
+		}
+		i = descEnd;
+		if (undefinedStart) {
+			continue;
+		}
+		if (!extendedText.empty()) {
+			event.text = intern(extendedText);
+		}
+
+		// Replace the same event and the ones it overlaps, they are rescheduled
+		const std::time_t eventEnd = event.start + event.duration;
+		events.erase(std::remove_if(events.begin(), events.end(),
+			[&event, eventEnd](const Event &e) {
+				return e.eventID == event.eventID ||
+					(e.start < eventEnd && event.start < e.start + static_cast<std::time_t>(e.duration));
+			}), events.end());
+		const auto pos = std::upper_bound(events.begin(), events.end(), event.start,
+			[](const std::time_t start, const Event &e) {
+				return start < e.start;
+			});
+		events.insert(pos, event);
+		if (events.size() > MAX_EVENTS_PER_SERVICE) {
+			events.pop_back();
+		}
+	}
+	evict();
+}
+
+uint32_t EIT::intern(const std::string &str) {
+	const auto s = _stringIndex.find(str);
+	if (s != _stringIndex.end()) {
+		return s->second;
+	}
+	const uint32_t index = _strings.size();
+	_strings.push_back(str);
+	_stringIndex.emplace(str, index);
+	_stringBytes += str.size();
+	return index;
+}
+
+void EIT::compactStrings() {
+	std::vector<std::string> strings;
+	strings.swap(_strings);
+	_stringIndex.clear();
+	_stringBytes = 0;
+	intern("");
+	for (auto &[_, service] : _services) {
+		for (Event &event : service.events) {
+			event.title = intern(strings[event.title]);
+			event.text = intern(strings[event.text]);
+			event.language = intern(strings[event.language]);
+		}
+	}
+	_compactAt = std::max(MAX_STRINGS, 2 * _strings.size());
+}
+
+void EIT::evict() {
+	while (_services.size() > MAX_SERVICES) {
+		const auto oldest = std::min_element(_services.begin(), _services.end(),
+			[](const auto &a, const auto &b) {
+				return a.second.updated < b.second.updated;
+			});
+		removeService(oldest->first);
+	}
+	std::size_t numberOfEvents = 0;
+	for (const auto &[_, service] : _services) {
+		numberOfEvents += service.events.size();
+	}
+	while (numberOfEvents > MAX_EVENTS) {
+		// Drop the last event of the service with the most events
+		const auto largest = std::max_element(_services.begin(), _services.end(),
+			[](const auto &a, const auto &b) {
+				return a.second.events.size() < b.second.events.size();
+			});
+		largest->second.events.pop_back();
+		--numberOfEvents;
+	}
+	if (_strings.size() <= _compactAt && _stringBytes <= MAX_STRING_BYTES) {
+		return;
+	}
+	compactStrings();
+	// Still too much text, halve the events of every service until it fits
+	while (_stringBytes > MAX_STRING_BYTES && numberOfEvents > 0) {
+		numberOfEvents = 0;
+		for (auto &[_, service] : _services) {
+			service.events.resize(service.events.size() / 2);
+			numberOfEvents += service.events.size();
+		}
+		compactStrings();
+	}
+}
+
+void EIT::removeService(const uint64_t key) {
+	_services.erase(key);
+	for (auto s = _subTables.begin(); s != _subTables.end(); ) {
+		if ((s->first & 0xFFFFFFFFFFFFull) == key) {
+			s = _subTables.erase(s);
+		} else {
+			++s;
+		}
+	}
+}
+
+std::size_t EIT::getNumberOfEvents() const {
+	base::MutexLock lock(_mutex);
+	std::size_t size = 0;
+	for (const auto &[_, service] : _services) {
+		size += service.events.size();
+	}
+	return size;
+}
+
+void EIT::addToJSON(base::JSONSerializer &json, const int serviceID, const bool nowNext) const {
+	base::MutexLock lock(_mutex);
+	const std::time_t now = _clock.getUTCTime();
+	json.startArrayWithName("services");
+	for (const auto &[key, service] : _services) {
+		const EventVector &events = service.events;
+		const int sid = key & 0xFFFF;
+		if ((serviceID != -1 && serviceID != sid) || events.empty()) {
+			continue;
+		}
+		json.startObject();
+		json.addValueNumber("onid", StringConverter::stringFormat("@#1", (key >> 32) & 0xFFFF));
+		json.addValueNumber("tsid", StringConverter::stringFormat("@#1", (key >> 16) & 0xFFFF));
+		json.addValueNumber("sid", StringConverter::stringFormat("@#1", sid));
+		json.startArrayWithName("events");
+		std::size_t count = 0;
+		for (const Event &event : events) {
+			if (nowNext && (event.start + static_cast<std::time_t>(event.duration) <= now || ++count > 2)) {
+				continue;
+			}
+			json.startObject();
+			json.addValueNumber("eventID", StringConverter::stringFormat("@#1", event.eventID));
+			json.addValueNumber("start", StringConverter::stringFormat("@#1", event.start));
+			json.addValueNumber("duration", StringConverter::stringFormat("@#1", event.duration));
+			json.addValueNumber("running", StringConverter::stringFormat("@#1", static_cast<int>(event.running)));
+			json.addValueNumber("scrambled", event.scrambled ? "1" : "0");
+			json.addValueString("language", _strings[event.language]);
+			json.addValueString("title", _strings[event.title]);
+			json.addValueString("text", _strings[event.text]);
+			json.endObject();
+		}
+		json.endArray();
+		json.endObject();
+	}
+	json.endArray();
+}
+
+void EIT::addToXMLTV(std::string &channels, std::string &programmes,
+		std::set<uint64_t> &added, const SDT &sdt, const int serviceID, const bool nowNext) const {
+	base::MutexLock lock(_mutex);
+	const std::time_t now = _clock.getUTCTime();
+	for (const auto &[key, service] : _services) {
+		const EventVector &events = service.events;
+		const int sid = key & 0xFFFF;
+		const int tsID = (key >> 16) & 0xFFFF;
+		const int onID = (key >> 32) & 0xFFFF;
+		if ((serviceID != -1 && serviceID != sid) || events.empty() || !added.insert(key).second) {
+			continue;
+		}
+		const std::string channelID = StringConverter::stringFormat("@#1.@#2.@#3", onID, tsID, sid);
+		// The SDT only knows the names of the services of this transport stream
+		std::string name = channelID;
+		if (sdt.getTransportStreamID() == tsID && sdt.getNetworkID() == onID) {
+			const std::string channelName = sdt.getSDTDataFor(sid).channelNameUTF8;
+			if (!channelName.empty() && channelName != "Not Found") {
+				name = channelName;
+			}
+		}
+		channels += StringConverter::stringFormat("<channel id=\"@#1\"><display-name>@#2</display-name></channel>\r\n",
+			channelID, makeXMLTVString(name));
+		std::size_t count = 0;
+		for (const Event &event : events) {
+			if (nowNext && (event.start + static_cast<std::time_t>(event.duration) <= now || ++count > 2)) {
+				continue;
+			}
+			const std::string &language = _strings[event.language];
+			const std::string lang = language.empty() ? "" : " lang=\"" + makeXMLTVString(language) + "\"";
+			programmes += StringConverter::stringFormat("<programme start=\"@#1\" stop=\"@#2\" channel=\"@#3\">",
+				getXMLTVTime(event.start), getXMLTVTime(event.start + event.duration), channelID);
+			programmes += "<title" + lang + ">" + makeXMLTVString(_strings[event.title]) + "</title>";
+			if (event.text != 0) {
+				programmes += "<desc" + lang + ">" + makeXMLTVString(_strings[event.text]) + "</desc>";
+			}
+			programmes += "</programme>\r\n";
+		}
+	}
+}
+
+}
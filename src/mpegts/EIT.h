@@ -0,0 +1,174 @@
+/* EIT.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_EIT_H_INCLUDE
+#define MPEGTS_EIT_H_INCLUDE MPEGTS_EIT_H_INCLUDE
+
+#include <base/JSONSerializer.h>
+#include <base/Mutex.h>
+
+#include <bitset>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mpegts {
+
+class SDT;
+class TDT;
+
+/// The class @c EIT collects the present/following and schedule sections of
+/// PID 18, actual and other TS, into an EPG index. The index maps each service
+/// to its events sorted on start time, titles and texts are interned.
+/// It is filled passively from the TS packets of a stream that is tuned anyway.
+/// The time is taken from the broadcast clock, @see TDT
+class EIT {
+		// =========================================================================
+		//  -- Constructors and destructor -----------------------------------------
+		// =========================================================================
+	public:
+
+		/// @param clock specifies the broadcast clock of the frontend
+		explicit EIT(const TDT &clock);
+
+		virtual ~EIT() = default;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Clear the EPG index and the collected sections
+		void clear();
+
+		/// Collect the EIT sections of this TS packet of PID 18
+		/// @param data specifies the TS packet
+		void collectData(const unsigned char *data);
+
+		/// Get the number of events in the EPG index
+		std::size_t getNumberOfEvents() const;
+
+		/// Add the EPG index as 'services' array
+		/// @param json specifies the JSON to add the services to
+		/// @param serviceID specifies the service or -1 for all of them
+		/// @param nowNext specifies if only the present and following event should be added
+		void addToJSON(base::JSONSerializer &json, int serviceID, bool nowNext) const;
+
+		/// Add the EPG index as XMLTV channel and programme elements
+		/// @param channels specifies the string to add the channel elements to
+		/// @param programmes specifies the string to add the programme elements to
+		/// @param added specifies the services that are already added, by an other
+		/// frontend, they are skipped and the added services are inserted
+		/// @param sdt specifies the SDT used to get the channel names
+		/// @param serviceID specifies the service or -1 for all of them
+		/// @param nowNext specifies if only the present and following event should be added
+		void addToXMLTV(std::string &channels, std::string &programmes,
+			std::set<uint64_t> &added, const SDT &sdt, int serviceID, bool nowNext) const;
+
+	private:
+
+		/// Append the section data to the section being collected
+		/// @return true if the section is complete
+		bool addSectionData(const unsigned char *&data, std::size_t &len);
+
+		/// Parse the collected section and add its events to the index
+		void parseSection();
+
+		/// Intern the string and return its index in @see _strings
+		uint32_t intern(const std::string &str);
+
+		/// Rebuild the interned strings with only the strings that are used
+		void compactStrings();
+
+		/// Keep the index within @see MAX_SERVICES, @see MAX_EVENTS and
+		/// @see MAX_STRING_BYTES by evicting the least recently updated services
+		/// and the events furthest in the future
+		void evict();
+
+		/// Remove the service and its sub tables, so it is collected again when
+		/// its sections are received
+		void removeService(uint64_t key);
+
+		// =========================================================================
+		//  -- Data members --------------------------------------------------------
+		// =========================================================================
+	private:
+
+		/// Maximum number of events kept per service, the last ones are dropped
+		static constexpr std::size_t MAX_EVENTS_PER_SERVICE = 1024;
+		/// Maximum number of services, the least recently updated one is removed
+		static constexpr std::size_t MAX_SERVICES = 1024;
+		/// Maximum number of events of all services together
+		static constexpr std::size_t MAX_EVENTS = 65536;
+		/// Maximum size of the interned strings after they are compacted
+		static constexpr std::size_t MAX_STRING_BYTES = 16 * 1024 * 1024;
+		/// Number of interned strings before they are compacted for the first time
+		static constexpr std::size_t MAX_STRINGS = 65536;
+		/// Events that ended this long ago are removed
+		static constexpr std::time_t EXPIRE_TIME = 3600;
+
+		struct Event {
+			std::time_t start;
+			uint32_t duration;
+			uint32_t title;
+			uint32_t text;
+			uint32_t language;
+			uint16_t eventID;
+			uint8_t running;
+			bool scrambled;
+		};
+		using EventVector = std::vector<Event>;
+
+		struct Service {
+			EventVector events;
+			/// Value of @see _updateCount when the service was last updated
+			uint64_t updated = 0;
+		};
+
+		/// Version and received section numbers of one sub table
+		struct SubTable {
+			int version;
+			std::bitset<256> sections;
+		};
+
+		mutable base::Mutex _mutex;
+		const TDT &_clock;
+		std::vector<unsigned char> _section;
+		int _cc = -1;
+		/// Key is table ID, original network ID, transport stream ID and service ID
+		std::unordered_map<uint64_t, SubTable> _subTables;
+		/// Key is original network ID, transport stream ID and service ID
+		std::map<uint64_t, Service> _services;
+		uint64_t _updateCount = 0;
+		std::vector<std::string> _strings;
+		std::unordered_map<std::string, uint32_t> _stringIndex;
+		/// Total size of @see _strings
+		std::size_t _stringBytes = 0;
+		/// Compact the strings when there are more then this, it grows with the
+		/// number of strings that are still used after compacting
+		std::size_t _compactAt = MAX_STRINGS;
+};
+
+}
+
+#endif // MPEGTS_EIT_H_INCLUDE
@@ -24,6 +24,9 @@
 #include <StringConverter.h>
 #include <mpegts/PacketBuffer.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -31,11 +34,27 @@
 
 namespace mpegts {
 
+static constexpr int TDT_PID = 20;
+
+/// Add the PIDs of the CSV string to pids, invalid PIDs are skipped
+static void addPIDsTo(const std::string &csv, std::bitset<PidTable::ALL_PIDS> &pids) {
+	for (const std::string &pid : StringConverter::split(csv, ",")) {
+		try {
+			if (const int p = std::stoi(pid); p >= 0 && p < PidTable::ALL_PIDS) {
+				pids.set(p);
+			}
+		} catch (const std::logic_error &) {
+			// Skip it, parsePIDString logs it
+		}
+	}
+}
+
 // =============================================================================
 // -- Constructors and destructor ----------------------------------------------
 // =============================================================================
 
-Filter::Filter() {
+Filter::Filter() :
+	_eit(_tdt) {
 	_nit = std::make_shared<NIT>();
 	_pat = std::make_shared<PAT>();
 	_pcr = std::make_shared<PCR>();
@@ -50,7 +69,22 @@ Filter::Filter() {
 void Filter::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "pidcsv", getPidCSV());
 	ADD_XML_ELEMENT(xml, "totalCCErrors", getTotalCCErrors());
+	ADD_XML_ELEMENT(xml, "tr101290Priority1", _tr101290.getErrors(1));
+	ADD_XML_ELEMENT(xml, "tr101290Priority2", _tr101290.getErrors(2));
 	ADD_XML_CHECKBOX(xml, "filterPCR", (_filterPCR ? "true" : "false"));
+	ADD_XML_CHECKBOX(xml, "collectEPG", (_collectEPG ? "true" : "false"));
+	ADD_XML_ELEMENT(xml, "epgEvents", _eit.getNumberOfEvents());
+	if (_tdt.isValid()) {
+		std::tm tm;
+		char broadcastTime[32];
+		const std::time_t utc = _tdt.getUTCTime();
+		::gmtime_r(&utc, &tm);
+		std::strftime(broadcastTime, sizeof(broadcastTime), "%Y-%m-%d %H:%M:%S UTC", &tm);
+		ADD_XML_ELEMENT(xml, "broadcastTime", broadcastTime);
+	} else {
+		ADD_XML_ELEMENT(xml, "broadcastTime", "-");
+	}
+	ADD_XML_ELEMENT(xml, "broadcastClockDrift", _tdt.getDriftMS());
 	ADD_XML_TEXT_INPUT(xml, "addUserPids", _userPids);
 
 	const SDT::Data sdtData = getSDTData()->getSDTDataFor(
@@ -84,6 +118,11 @@ void Filter::doFromXML(const std::string &xml) {
 	}
 	if (findXMLElement(xml, "filterPCR.value", element)) {
 		_filterPCR = (element == "true") ? true : false;
+		markPIDActionTableChanged();
+	}
+	if (findXMLElement(xml, "collectEPG.value", element)) {
+		_collectEPG = (element == "true") ? true : false;
+		markPIDActionTableChanged();
 	}
 }
 
@@ -99,22 +138,198 @@ void Filter::clear() {
 	_sdt = std::make_shared<SDT>();
 	_pmtMap.clear();
 	_pidTable.clear();
+	_pidStatistics.clear();
+	_tr101290.clear();
+	_tdtPIDRequested = false;
+	_serviceID = -1;
+	_servicePMTPID = -1;
+	_servicePIDs.clear();
+	_servicePAT.clear();
+	_servicePMTPass = false;
+	markPIDActionTableChanged();
+}
+
+void Filter::setService(const FeID id, const int serviceID) {
+	base::MutexLock lock(_mutex);
+	if (serviceID == _serviceID) {
+		return;
+	}
+	SI_LOG_INFO("Frontend: @#1, Selecting service @#2 - @#3", id, HEX(serviceID, 4), DIGIT(serviceID, 5));
+	// Only the PAT and the PIDs of this service are opened
+	_pidTable.clear();
+	_pidTable.setPID(0, true);
+	_pidTable.setPID(TDT_PID, true);
+	_tdtPIDRequested = false;
+	_serviceID = serviceID;
+	_servicePMTPID = -1;
+	_servicePIDs.clear();
+	_servicePAT.clear();
+	_servicePMTPass = false;
+	markPIDActionTableChanged();
+	// The PAT and PMT may be collected already
+	updateServicePIDs_L(id);
+}
+
+void Filter::clearService(const FeID id) {
+	base::MutexLock lock(_mutex);
+	if (_serviceID == -1) {
+		return;
+	}
+	SI_LOG_INFO("Frontend: @#1, Clearing service @#2", id, DIGIT(_serviceID.load(), 5));
+	// The requested PIDs are opened again by the same request
+	_pidTable.clear();
+	_tdtPIDRequested = false;
+	_serviceID = -1;
+	_servicePMTPID = -1;
+	_servicePIDs.clear();
+	_servicePAT.clear();
+	_servicePMTPass = false;
+	markPIDActionTableChanged();
+	_servicePIDsChanged = true;
+}
+
+void Filter::updateServicePIDs_L(const FeID id) {
+	const int serviceID = _serviceID;
+	if (serviceID == -1 || !_pat->isCollected()) {
+		return;
+	}
+	const int pmtPID = _pat->getPMTPID(serviceID);
+	const auto s = _pmtMap.find(pmtPID);
+	const bool pmtCollected = s != _pmtMap.end() && s->second->isCollected();
+	// Keep the PIDs while a new version of the PMT is collected
+	if (pmtPID == _servicePMTPID && !pmtCollected) {
+		return;
+	}
+	std::set<int> pids;
+	if (pmtPID > 0) {
+		pids.insert(pmtPID);
+		if (pmtCollected) {
+			const SpPMT &pmt = s->second;
+			// PID 0x1FFF means there is no PCR
+			const int pcrPID = pmt->getPCRPid();
+			if (pcrPID > 0 && pcrPID < 0x1FFF) {
+				pids.insert(pcrPID);
+			}
+			for (const PMT::ESData &es : pmt->getESPIDs()) {
+				pids.insert(es.pid);
+			}
+			for (const PMT::ECMData &ecm : pmt->getECMPIDs()) {
+				pids.insert(ecm.ecmpid);
+			}
+		}
+	} else {
+		SI_LOG_ERROR("Frontend: @#1, Service @#2 not found in PAT", id, DIGIT(serviceID, 5));
+	}
+	if (pmtPID != _servicePMTPID) {
+		_servicePMTPID = pmtPID;
+		_servicePATVersion = (_servicePATVersion + 1) & 0x1F;
+		_servicePAT.clear();
+		if (pmtPID > 0) {
+			PAT::ProgramMap programs;
+			programs[serviceID] = pmtPID;
+			_servicePAT = PAT::generatePacket(_pat->getTransportStreamID(),
+				_servicePATVersion, 0, programs);
+		}
+	}
+	if (pids == _servicePIDs) {
+		return;
+	}
+	for (const int pid : _servicePIDs) {
+		if (pids.find(pid) == pids.end()) {
+			_pidTable.setPID(pid, false);
+		}
+	}
+	for (const int pid : pids) {
+		_pidTable.setPID(pid, true);
+	}
+	_servicePIDs.swap(pids);
+	std::string pidCSV;
+	for (const int pid : _servicePIDs) {
+		pidCSV += StringConverter::stringFormat("@#1,", pid);
+	}
+	SI_LOG_INFO("Frontend: @#1, Service @#2 - PMT PID: @#3 - PIDs: @#4",
+		id, DIGIT(serviceID, 5), PID(pmtPID), pidCSV);
+	markPIDActionTableChanged();
+	_servicePIDsChanged = true;
+}
+
+void Filter::replaceServicePAT(mpegts::PacketBuffer &buffer, const std::size_t packetNumber) {
+	unsigned char *ptr = buffer.getTSPacketPtr(packetNumber);
+	base::MutexLock lock(_mutex);
+	// The single program PAT always fits in the first TS packet of the PAT
+	if ((ptr[1] & 0x40) == 0 || _servicePAT.size() != PacketBuffer::TS_PACKET_SIZE) {
+		buffer.markTSForPurging(packetNumber);
+		return;
+	}
+	std::memcpy(ptr, _servicePAT.data(), PacketBuffer::TS_PACKET_SIZE);
+	ptr[3] = (ptr[3] & 0xF0) | _servicePATCC;
+	_servicePATCC = (_servicePATCC + 1) & 0x0F;
+}
+
+void Filter::filterServicePMT_L(mpegts::PacketBuffer &buffer, const std::size_t packetNumber) {
+	unsigned char *ptr = buffer.getTSPacketPtr(packetNumber);
+	const std::size_t size = PacketBuffer::TS_PACKET_SIZE;
+	const std::size_t payload = 4 + (((ptr[3] & 0x20) == 0x20) ? 1 + ptr[4] : 0);
+	bool pass = _servicePMTPass;
+	if ((ptr[1] & 0x40) == 0x40 && payload < size) {
+		// Only the first section that starts in this packet is checked, the
+		// pointer field skips the end of the section before it
+		const std::size_t start = std::min(payload + 1 + ptr[payload], size);
+		bool selected = false;
+		std::size_t end = size;
+		if (start + 5 <= size) {
+			selected = ptr[start] == TableData::PMT_ID &&
+				((ptr[start + 3] << 8) | ptr[start + 4]) == _serviceID;
+			end = start + 3 + (((ptr[start + 1] & 0x0F) << 8) | ptr[start + 2]);
+		}
+		if (selected) {
+			// Stuff the sections after the one of the service
+			if (end < size) {
+				std::memset(&ptr[end], 0xFF, size - end);
+			}
+			pass = true;
+		} else if (pass && start > payload + 1) {
+			// Keep the end of the section of the service, stuff the other one
+			std::memset(&ptr[start], 0xFF, size - start);
+		} else {
+			pass = false;
+		}
+		_servicePMTPass = selected;
+	}
+	if (!pass) {
+		buffer.markTSForPurging(packetNumber);
+		return;
+	}
+	ptr[3] = (ptr[3] & 0xF0) | _servicePMTCC;
+	_servicePMTCC = (_servicePMTCC + 1) & 0x0F;
 }
 
 void Filter::parsePIDString(const FeID id, const std::string &reqPids, const bool add) {
 	base::MutexLock lock(_mutex);
+	markPIDActionTableChanged();
 	if (reqPids.find("all") != std::string::npos ||
 		reqPids.find("none") != std::string::npos) {
 		// all/none pids requested then 'remove' all used PIDS first
 		_pidTable.clear();
+		_tdtPIDRequested = false;
 		if (reqPids.find("all") != std::string::npos) {
 			_pidTable.setAllPID(add);
+			_tdtPIDRequested = add;
 		}
 	} else {
+		// The user PIDs can not be deleted, they are opened with every request
+		std::bitset<PidTable::ALL_PIDS> userPIDs;
+		addPIDsTo(_userPids, userPIDs);
 		const StringVector reqPidList = StringConverter::split(reqPids, ",");
 		for (const std::string &pid : reqPidList) {
 			try {
-				if (const auto p = std::stoi(pid); p > 18 || add) {
+				if (const auto p = std::stoi(pid); p < 0 || p >= PidTable::ALL_PIDS) {
+					SI_LOG_ERROR("Frontend: @#1, Error, skipping PID: @#2", id, pid);
+				} else if (p == TDT_PID) {
+					// Keep it open for the broadcast clock, only stop sending it
+					_tdtPIDRequested = add;
+					_pidTable.setPID(p, true);
+				} else if (add || !userPIDs.test(p)) {
 					_pidTable.setPID(p, add);
 				}
 			} catch (const std::invalid_argument &) {
@@ -125,11 +340,71 @@ void Filter::parsePIDString(const FeID id, const std::string &reqPids, const boo
 			const StringVector userPidList = StringConverter::split(_userPids, ",");
 			for (const std::string &pid : userPidList) {
 				try {
-					_pidTable.setPID(std::stoi(pid), add);
+					const int p = std::stoi(pid);
+					_pidTable.setPID(p, add);
+					_tdtPIDRequested = _tdtPIDRequested || p == TDT_PID;
 				} catch (const std::invalid_argument &) {
 					SI_LOG_ERROR("Frontend: @#1, Error, skipping PID: @#2", id, pid);
 				}
 			}
+			_pidTable.setPID(TDT_PID, true);
+		}
+	}
+}
+
+void Filter::rebuildPIDActionTable() {
+	_pidActionChanged = false;
+	std::vector<int> pmtPIDs;
+	std::vector<int> pcrPIDs;
+	for (int pid = 0; pid < PidTable::ALL_PIDS; ++pid) {
+		if (!_pidTable.isPIDOpened(pid)) {
+			_pidAction[pid] = PidAction::Drop;
+			continue;
+		}
+		switch (pid) {
+			case 0:
+				_pidAction[pid] = PidAction::PAT;
+				break;
+			case 16:
+				_pidAction[pid] = PidAction::NIT;
+				break;
+			case 17:
+				_pidAction[pid] = PidAction::SDT;
+				break;
+			case TDT_PID:
+				_pidAction[pid] = _tdtPIDRequested ? PidAction::TDT : PidAction::Clock;
+				break;
+			case 18:
+				_pidAction[pid] = _collectEPG ? PidAction::EIT : PidAction::Count;
+				break;
+			case 1:
+			case 21:
+				_pidAction[pid] = PidAction::Count;
+				break;
+			default:
+				if (_pat->isMarkedAsPMT(pid)) {
+					_pidAction[pid] = PidAction::PMT;
+					pmtPIDs.push_back(pid);
+				} else {
+					_pidAction[pid] = PidAction::Count;
+				}
+				break;
+		}
+	}
+	for (const auto &[pmtPID, pmt] : _pmtMap) {
+		const int pcrPID = pmt->getPCRPid();
+		if (pcrPID >= 0 && pcrPID < PidTable::ALL_PIDS && _pidTable.isPIDOpened(pcrPID)) {
+			pcrPIDs.push_back(pcrPID);
+		}
+	}
+	_tr101290.setReferencedPIDs(_pidTable.isPIDOpened(0), pmtPIDs, pcrPIDs);
+	if (_filterPCR) {
+		for (const auto &[pmtPID, pmt] : _pmtMap) {
+			const int pcrPID = pmt->getPCRPid();
+			if (pcrPID >= 0 && pcrPID < PidTable::ALL_PIDS &&
+					_pidAction[pcrPID] == PidAction::Count) {
+				_pidAction[pcrPID] = PidAction::PCR;
+			}
 		}
 	}
 }
@@ -138,43 +413,78 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 //	base::MutexLock lock(_mutex);
 	const std::size_t size = buffer.getNumberOfCompletedPackets();
 	const std::size_t begin = buffer.getBeginOfUnFilteredPackets();
+	// A selected service is always filtered, so only its PIDs are send
+	const bool service = _serviceID != -1;
+	const bool purge = (filter || service) && !_pidTable.isAllPID();
+	bool clockPurged = false;
+
+	// First classify all packets of this buffer with the PID action table,
+	// again from 'from' when a new PAT or PMT changed the table
+	PidAction action[PacketBuffer::MAX_NUMBER_OF_TS_PACKETS];
+	const auto classify = [&](const std::size_t from) {
+		if (_pidActionChanged) {
+			base::MutexLock lock(_mutex);
+			rebuildPIDActionTable();
+		}
+		for (std::size_t i = from; i < size; ++i) {
+			const unsigned char *ptr = buffer.getTSPacketPtr(i);
+			// Check is this the beginning of the TS and no Transport error indicator and not a NULL packet
+			if (ptr[0] != 0x47 || (ptr[1] & 0x80) == 0x80 || (ptr[1] == 0x1F && ptr[2] == 0xFF)) {
+				action[i] = PidAction::Drop;
+			} else {
+				action[i] = _pidAction[((ptr[1] & 0x1f) << 8) | ptr[2]];
+			}
+		}
+	};
+	classify(begin);
 
+	// Check the packets as received, before they are changed or purged
+	_tr101290.checkPackets(buffer, begin, size, filter || _pidTable.isAllPID());
+
+	// Then dispatch each packet on its class
 	for (std::size_t i = begin; i < size; ++i) {
 		const unsigned char *ptr = buffer.getTSPacketPtr(i);
-		// Check is this the beginning of the TS and no Transport error indicator and not a NULL packet
-		if (ptr[0] != 0x47 || (ptr[1] & 0x80) == 0x80 || (ptr[1] == 0x1F && ptr[2] == 0xFF)) {
-			if (filter && !_pidTable.isAllPID()) {
+		if (action[i] == PidAction::Drop) {
+			// PID was not opened, skip this one (and perhaps purge it)
+			if (purge) {
 				buffer.markTSForPurging(i);
 			}
 			continue;
 		}
 		// get PID and CC from TS
 		const uint16_t pid = ((ptr[1] & 0x1f) << 8) | ptr[2];
-		// If pid was not opened, skip this one (and perhaps purge it)
-		if (!_pidTable.isPIDOpened(pid)) {
-			if (filter && !_pidTable.isAllPID()) {
-				buffer.markTSForPurging(i);
-			}
-			continue;
-		}
 		const uint8_t cc = ptr[3] & 0x0f;
 		_pidTable.addPIDData(pid, cc);
 
-		switch (pid) {
-			case 0:
+		switch (action[i]) {
+			case PidAction::PAT: {
+				// The stream and the decrypt may use the PAT and PMT map meanwhile
+				base::MutexLock lock(_mutex);
+				if (_pat->isVersionChanged(TableData::PAT_ID, ptr)) {
+					SI_LOG_INFO("Frontend: @#1, PAT - Version changed, collecting again", id);
+					_pat = std::make_shared<PAT>();
+				}
 				if (!_pat->isCollected()) {
 					// collect PAT data
 					_pat->collectData(id, TableData::PAT_ID, ptr, false);
 					// Did we finish collecting PAT
 					if (_pat->isCollected()) {
 						_pat->parse(id);
+						removeUnlistedPMTs_L(id);
+						_psiChanged = true;
+						if (service) {
+							updateServicePIDs_L(id);
+						}
+						markPIDActionTableChanged();
+						classify(i + 1);
 					}
 				}
+				if (service) {
+					replaceServicePAT(buffer, i);
+				}
+				}
 				break;
-			case 1:
-				// Empty
-				break;
-			case 16:
+			case PidAction::NIT:
 				if (!_nit->isCollected()) {
 					// collect NIT data
 					_nit->collectData(id, TableData::NIT_ID, ptr, false);
@@ -185,91 +495,114 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 					}
 				}
 				break;
-			case 17:
+			case PidAction::SDT: {
+				// The stream and the decrypt may use the SDT meanwhile
+				base::MutexLock lock(_mutex);
+				if (_sdt->isVersionChanged(TableData::SDT_ID, ptr)) {
+					SI_LOG_INFO("Frontend: @#1, SDT - Version changed, collecting again", id);
+					_sdt = std::make_shared<SDT>();
+				}
 				if (!_sdt->isCollected()) {
 					// collect SDT data
 					_sdt->collectData(id, TableData::SDT_ID, ptr, false);
 					// Did we finish collecting SDT
 					if (_sdt->isCollected()) {
 						_sdt->parse(id);
+						_psiChanged = true;
 					}
 				}
+				}
 				break;
-			case 18:
-				// Empty
+			case PidAction::TDT:
+				_tdt.collectData(ptr);
 				break;
-			case 20: {
-				const unsigned int tableID = ptr[5];
-				const unsigned int mjd = (ptr[8] << 8) | (ptr[9]);
-				const unsigned int y1 = static_cast<unsigned int>((mjd - 15078.2) / 365.25);
-				const unsigned int m1 = static_cast<unsigned int>((mjd - 14956.1 - static_cast<unsigned int>(y1 * 365.25)) / 30.6001);
-				const unsigned int d = static_cast<unsigned int>(mjd - 14956.0 - static_cast<unsigned int>(y1 * 365.25) - static_cast<unsigned int>(m1 * 30.6001 ));
-				const unsigned int k = (m1 == 14 || m1 ==15) ? 1 : 0;
-				const unsigned int y = y1 + k + 1900;
-				const unsigned int m = m1 - 1 - (k * 12);
-				const unsigned int h = ptr[10];
-				const unsigned int mi = ptr[11];
-				const unsigned int s = ptr[12];
-
-				SI_LOG_INFO("Frontend: @#1, TDT - Table ID: @#2  Date: @#3-@#4-@#5  Time: @#6:@#7.@#8  MJD: @#9",
-					id, HEX(tableID, 2), y, m, d, DIGIT(h, 2), DIGIT(mi, 2), DIGIT(s, 2), HEX(mjd, 4));
-#ifdef ADDDVBCA
-				const char fileFIFO[] = "/tmp/fifo";
-				int fd = ::open(fileFIFO, O_WRONLY | O_NONBLOCK);
-				if (fd > 0) {
-					::write(fd, ptr, 188);
-					::close(fd);
-				}
-#endif
-				}
+			case PidAction::Clock:
+				_tdt.collectData(ptr);
+				buffer.markTSForPurging(i);
+				clockPurged = true;
 				break;
-			case 21:
-				// Empty
+			case PidAction::EIT:
+				_eit.collectData(ptr);
 				break;
-			default:
-				if (_pat->isMarkedAsPMT(pid)) {
-					// Did we finish collecting PMT
-					_pmtMap.try_emplace(pid, std::make_shared<PMT>());
-					if (!_pmtMap[pid]->isCollected()) {
-						// collect PMT data
-						_pmtMap[pid]->collectData(id, TableData::PMT_ID, ptr, false);
-						if (_pmtMap[pid]->isCollected()) {
-							_pmtMap[pid]->parse(id);
-						}
-#ifdef ADDDVBCA
-						const char fileFIFO[] = "/tmp/fifo";
-						int fd = ::open(fileFIFO, O_WRONLY | O_NONBLOCK);
-						if (fd > 0) {
-							::write(fd, ptr, 188);
-							::close(fd);
+			case PidAction::PMT: {
+				// The decrypt and the stream may use the PMT map meanwhile
+				base::MutexLock lock(_mutex);
+				// Did we finish collecting PMT
+				SpPMT &pmt = _pmtMap.try_emplace(pid, std::make_shared<PMT>()).first->second;
+				if (pmt->isVersionChanged(TableData::PMT_ID, ptr)) {
+					// A new PMT object will also be send again to the decrypt client
+					SI_LOG_INFO("Frontend: @#1, PMT - PID @#2: Version changed, collecting again", id, PID(pid));
+					pmt = std::make_shared<PMT>();
+				}
+				if (!pmt->isCollected()) {
+					// collect PMT data
+					pmt->collectData(id, TableData::PMT_ID, ptr, false);
+					if (pmt->isCollected()) {
+						pmt->parse(id);
+						_psiChanged = true;
+						if (service) {
+							updateServicePIDs_L(id);
 						}
-#endif
+						markPIDActionTableChanged();
+						classify(i + 1);
 					}
-				} else if (_filterPCR && PCR::isPCRTableData(ptr)) {
-					for (const auto &[_, pmt] : _pmtMap) {
-						const int pcrPID = pmt->getPCRPid();
-						if (pid == pcrPID && _pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0) {
-							_pcr->collectData(id, ptr);
-						}
+#ifdef ADDDVBCA
+					const char fileFIFO[] = "/tmp/fifo";
+					int fd = ::open(fileFIFO, O_WRONLY | O_NONBLOCK);
+					if (fd > 0) {
+						::write(fd, ptr, 188);
+						::close(fd);
 					}
+#endif
+				}
+				if (service && pid == _servicePMTPID) {
+					filterServicePMT_L(buffer, i);
+				}
+				}
+				break;
+			case PidAction::PCR:
+				if (PCR::isPCRTableData(ptr)) {
+					_pcr->collectData(id, ptr);
 				}
 				break;
+			default:
+				// Only counted
+				break;
 		}
 	}
-	if (filter) {
+	_pidStatistics.update(_pidTable);
+	if (filter || service || clockPurged) {
 		buffer.purge();
 	}
 }
 
-bool Filter::isMarkedAsActivePMT(const int pid) const {
-	// Do not use lock here, its used for decrypt (Uses to much time)
-	if (_pat->isMarkedAsPMT(pid) && _pmtMap.find(pid) != _pmtMap.end()) {
-		const int pcrPID = _pmtMap[pid]->getPCRPid();
-		if (_pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0) {
-			return true;
+void Filter::removeUnlistedPMTs_L(const FeID id) {
+	for (auto it = _pmtMap.begin(); it != _pmtMap.end();) {
+		if (_pat->isMarkedAsPMT(it->first)) {
+			++it;
+		} else {
+			SI_LOG_INFO("Frontend: @#1, PMT - PID @#2: Not in the PAT anymore, removing it", id, PID(it->first));
+			it = _pmtMap.erase(it);
+		}
+	}
+}
+
+void Filter::addEPGToXMLTV(std::string &channels, std::string &programmes,
+		std::set<uint64_t> &added, const int serviceID, const bool nowNext) const {
+	const SpSDT sdt = getSDTData();
+	_eit.addToXMLTV(channels, programmes, added, *sdt, serviceID, nowNext);
+}
+
+void Filter::getActivePMTs(PMTVector &pmts) const {
+	base::MutexLock lock(_mutex);
+	pmts.clear();
+	for (const auto &[pid, pmt] : _pmtMap) {
+		const int pcrPID = pmt->getPCRPid();
+		if (pmt->isCollected() && _pat->isMarkedAsPMT(pid) &&
+				_pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0) {
+			pmts.emplace_back(pid, pmt);
 		}
 	}
-	return false;
 }
 
 mpegts::SpPMT Filter::getPMTData(const int pid) const {
@@ -296,12 +629,117 @@ uint32_t Filter::getTotalCCErrors() const {
 
 std::string Filter::getPidCSV() const {
 	base::MutexLock lock(_mutex);
-	return _pidTable.getPidCSV();
+	// PID 20 is not shown when it is only opened for the broadcast clock
+	return _pidTable.getPidCSV(_tdtPIDRequested ? -1 : TDT_PID);
 }
 
 void Filter::setPID(const int pid, const bool val) {
 	base::MutexLock lock(_mutex);
 	_pidTable.setPID(pid, val);
+	markPIDActionTableChanged();
+}
+
+void Filter::setSharedPIDs(std::bitset<PidTable::ALL_PIDS> pids, const bool all) {
+	base::MutexLock lock(_mutex);
+	addPIDsTo(_userPids, pids);
+	// PID 20 is only send when a session did select it
+	const bool tdtPIDRequested = all || pids.test(TDT_PID);
+	bool changed = tdtPIDRequested != _tdtPIDRequested;
+	_tdtPIDRequested = tdtPIDRequested;
+	pids.set(TDT_PID);
+	if (_serviceID != -1) {
+		pids.set(0);
+		for (const int pid : _servicePIDs) {
+			pids.set(pid);
+		}
+	}
+	if (_pidTable.isPIDRequested(PidTable::ALL_PIDS) != all) {
+		_pidTable.setAllPID(all);
+		changed = true;
+	}
+	for (int pid = 0; pid < PidTable::ALL_PIDS; ++pid) {
+		if (_pidTable.isPIDRequested(pid) != pids.test(pid)) {
+			_pidTable.setPID(pid, pids.test(pid));
+			changed = true;
+		}
+	}
+	if (changed) {
+		markPIDActionTableChanged();
+	}
+}
+
+std::bitset<PidTable::ALL_PIDS> Filter::getUserPIDs() const {
+	base::MutexLock lock(_mutex);
+	std::bitset<PidTable::ALL_PIDS> pids;
+	addPIDsTo(_userPids, pids);
+	return pids;
+}
+
+void Filter::getPSITables(PSICache::Tables &tables) const {
+	base::MutexLock lock(_mutex);
+	tables.clear();
+	if (_pat->isCollected()) {
+		tables[0] = _pat->getTSPackets();
+	}
+	if (_sdt->isCollected()) {
+		tables[17] = _sdt->getTSPackets();
+	}
+	for (const auto &[pid, pmt] : _pmtMap) {
+		if (pmt->isCollected()) {
+			tables[pid] = pmt->getTSPackets();
+		}
+	}
+}
+
+void Filter::preloadPSITables(const FeID id, const PSICache::Tables &tables) {
+	// Collect the cached packets into new tables first, the stream may use
+	// the current ones in the meanwhile. Then swap them in under the lock
+	const auto collect = [&](TableData &table, const int tableID, const TSData &packets) {
+		for (std::size_t i = 0; i + 188 <= packets.size() && !table.isCollected(); i += 188) {
+			table.collectData(id, tableID, &packets[i], false);
+		}
+		return table.isCollected();
+	};
+	SpPAT pat;
+	SpSDT sdt;
+	PMTMap pmtMap;
+	for (const auto &[pid, packets] : tables) {
+		if (pid < 0 || pid >= PidTable::ALL_PIDS) {
+			continue;
+		} else if (pid == 0) {
+			const SpPAT table = std::make_shared<PAT>();
+			if (collect(*table, TableData::PAT_ID, packets)) {
+				table->parse(id);
+				pat = table;
+			}
+		} else if (pid == 17) {
+			const SpSDT table = std::make_shared<SDT>();
+			if (collect(*table, TableData::SDT_ID, packets)) {
+				table->parse(id);
+				sdt = table;
+			}
+		} else {
+			const SpPMT table = std::make_shared<PMT>();
+			if (collect(*table, TableData::PMT_ID, packets)) {
+				table->parse(id);
+				pmtMap[pid] = table;
+			}
+		}
+	}
+	base::MutexLock lock(_mutex);
+	if (sdt != nullptr) {
+		_sdt = sdt;
+	}
+	for (const auto &[pid, pmt] : pmtMap) {
+		_pmtMap[pid] = pmt;
+	}
+	if (pat != nullptr) {
+		_pat = pat;
+		removeUnlistedPMTs_L(id);
+	}
+	SI_LOG_INFO("Frontend: @#1, Preloaded @#2 PSI tables from cache", id, tables.size());
+	updateServicePIDs_L(id);
+	markPIDActionTableChanged();
 }
 
 }
@@ -25,13 +25,21 @@
 #include <Log.h>
 #include <base/Mutex.h>
 #include <base/XMLSupport.h>
+#include <mpegts/EIT.h>
 #include <mpegts/NIT.h>
 #include <mpegts/PAT.h>
 #include <mpegts/PCR.h>
+#include <mpegts/PidStatistics.h>
+#include <mpegts/PSICache.h>
 #include <mpegts/PidTable.h>
 #include <mpegts/PMT.h>
 #include <mpegts/SDT.h>
+#include <mpegts/TDT.h>
+#include <mpegts/TR101290.h>
 
+#include <array>
+#include <atomic>
+#include <set>
 #include <unordered_map>
 
 FW_DECL_NS1(mpegts, PacketBuffer);
@@ -75,6 +83,25 @@ class Filter :
 		/// @param add specifies if true to open all the PIDs or false to close
 		void parsePIDString(FeID id, const std::string &reqPids, bool add);
 
+		/// Select the service to stream as single program TS. The PMT, PCR,
+		/// elementary and ECM PIDs of the service are opened from the collected
+		/// PAT and PMT, and follow the PMT when its version changes. The PAT is
+		/// replaced by one with only this service
+		/// @param id specifies the frontend ID
+		/// @param serviceID specifies the service (program number)
+		void setService(FeID id, int serviceID);
+
+		/// Stop streaming the selected service, the requested PIDs are streamed
+		/// again, @see setService
+		/// @param id specifies the frontend ID
+		void clearService(FeID id);
+
+		/// Check if the PIDs of the selected service changed since the last
+		/// call, so the PID filters should be updated
+		bool hasServicePIDsChanged() {
+			return _servicePIDsChanged.exchange(false);
+		}
+
 		/// Add the filter data to MPEG Tables and
 		/// optionally purge TS packets from unused pids if filter is true
 		/// @param feID specifies the frontend ID
@@ -82,10 +109,11 @@ class Filter :
 		/// @param filter enables the software pid filtering
 		void filterData(FeID id, mpegts::PacketBuffer &buffer, bool filter);
 
-		/// This will return true if the requested pid is the active/current one
-		/// accoording to the PCR that is open.
-		/// @param pid specifies the PID to check if it is the current one
-		bool isMarkedAsActivePMT(int pid) const;
+		/// Get a snapshot of the collected PMTs that are active/current
+		/// accoording to the PCR that is open. So the decrypt can use them
+		/// without the lock, while @see filterData may replace them
+		/// @param pmts specifies the PMTs with their PID that are active
+		void getActivePMTs(PMTVector &pmts) const;
 
 		/// This will return the requested PMT for the specified pid
 		/// @param pid specifies the PID to retrieve if it does not exists it will
@@ -99,6 +127,11 @@ class Filter :
 			return _pcr;
 		}
 
+		/// Check if PCR collecting (filterPCR) is enabled
+		bool isPCRFilteringEnabled() const {
+			return _filterPCR;
+		}
+
 		///
 		mpegts::SpPAT getPATData() const {
 			base::MutexLock lock(_mutex);
@@ -126,9 +159,80 @@ class Filter :
 		/// Get the CSV of all the requested PID
 		std::string getPidCSV() const;
 
+		/// Add the rolling per PID statistics as 'pids' array
+		void addPIDStatisticsToJSON(base::JSONSerializer &json) const {
+			_pidStatistics.addToJSON(json);
+		}
+
+		/// Add the TR 101 290 indicators as 'tr101290' object
+		void addTR101290ToJSON(base::JSONSerializer &json) const {
+			_tr101290.addToJSON(json);
+		}
+
+		/// Add the EPG index collected from the EIT as 'services' array
+		/// @param serviceID specifies the service or -1 for all of them
+		/// @param nowNext specifies if only the present and following event should be added
+		void addEPGToJSON(base::JSONSerializer &json, const int serviceID, const bool nowNext) const {
+			_eit.addToJSON(json, serviceID, nowNext);
+		}
+
+		/// Add the EPG index collected from the EIT as XMLTV elements, @see EIT
+		void addEPGToXMLTV(std::string &channels, std::string &programmes,
+				std::set<uint64_t> &added, int serviceID, bool nowNext) const;
+
+		/// Add the broadcast clock from the TDT/TOT as 'clock' object
+		void addClockToJSON(base::JSONSerializer &json) const {
+			_tdt.addToJSON(json);
+		}
+
+		/// Get the broadcast UTC time, or the system time when there is none
+		std::time_t getBroadcastTime() const {
+			return _tdt.getUTCTime();
+		}
+
 		/// Set pid used or not
 		void setPID(int pid, bool val);
 
+		/// Set the PIDs selected by the sessions sharing this transponder. The
+		/// PIDs this filter opens itself stay opened: the user PIDs, PID 20 for
+		/// the broadcast clock and the PIDs of the selected service. Only the
+		/// PIDs that differ from the @see PidTable are changed
+		/// @param pids specifies the PIDs selected by the sessions
+		/// @param all specifies if a session selected all PIDs
+		void setSharedPIDs(std::bitset<PidTable::ALL_PIDS> pids, bool all);
+
+		/// Get the user PIDs ('addUserPids') that are opened with every request
+		std::bitset<PidTable::ALL_PIDS> getUserPIDs() const;
+
+		/// Get the number of PIDs that are opened or should be opened
+		std::size_t getNumberOfRequestedPIDs() const {
+			base::MutexLock lock(_mutex);
+			return _pidTable.getNumberOfRequestedPIDs();
+		}
+
+		/// Let @see updatePIDFilters open all opened PIDs again, because the
+		/// demux was closed and opened again
+		void reopenPIDFilters() {
+			base::MutexLock lock(_mutex);
+			_pidTable.reopenPIDs();
+			markPIDActionTableChanged();
+		}
+
+		/// Check if the PAT, a PMT or the SDT was collected from the stream since
+		/// the last call, so the @see PSICache can be updated
+		bool hasPSIChanged() {
+			return _psiChanged.exchange(false);
+		}
+
+		/// Get the collected PAT, PMTs and SDT as TS packets for the @see PSICache
+		void getPSITables(PSICache::Tables &tables) const;
+
+		/// Preload the PAT, PMTs and SDT with the TS packets of the @see PSICache.
+		/// They are replaced when the stream brings a new version
+		/// @param feID specifies the frontend ID
+		/// @param tables specifies the cached TS packets mapped by PID
+		void preloadPSITables(FeID id, const PSICache::Tables &tables);
+
 		/// Close all active PID filter
 		/// @param feID specifies the frontend ID
 		/// @param closePid specifies the lambda function to use to close the PIDs
@@ -136,6 +240,7 @@ class Filter :
 		void closeActivePIDFilters(const FeID feID, CLOSE_FUNC closePid) {
 			base::MutexLock lock(_mutex);
 			SI_LOG_INFO("Frontend: @#1, Closing all active PID filters...", feID);
+			markPIDActionTableChanged();
 			for (int pid = 0; pid < mpegts::PidTable::MAX_PIDS; ++pid) {
 				_pidTable.setPID(pid, false);
 				if (_pidTable.shouldPIDClose(pid)) {
@@ -169,6 +274,44 @@ class Filter :
 
 	private:
 
+		/// What @see filterData should do with the TS packets of a PID
+		enum class PidAction : uint8_t {
+			Drop,  /// PID is not opened, purge it when filtering
+			Count, /// Only count it and check the continuity counter
+			PAT,
+			NIT,
+			SDT,
+			TDT,
+			Clock, /// PID 20 opened only for the broadcast clock, purge it after collecting
+			EIT,   /// PID 18, with collectEPG enabled
+			PMT,
+			PCR    /// PCR PID of one of the PMTs, with filterPCR enabled
+		};
+
+		/// Rebuild the PID action table from the PID table, PAT and PMTs
+		void rebuildPIDActionTable();
+
+		/// Open the PIDs of the selected service from the PAT and its PMT and
+		/// close the ones it does not use anymore
+		void updateServicePIDs_L(FeID id);
+
+		/// Replace this PAT packet by the single program PAT of the selected
+		/// service, or purge it when that PAT is not there (yet)
+		void replaceServicePAT(mpegts::PacketBuffer &buffer, std::size_t packetNumber);
+
+		/// Pass only the PMT sections of the selected service in this PMT packet,
+		/// the PMT PID may be shared with other programs. The other sections are
+		/// purged or stuffed and the CC is kept continuous
+		void filterServicePMT_L(mpegts::PacketBuffer &buffer, std::size_t packetNumber);
+
+		/// Remove the PMTs of the programs that the new PAT does not list anymore
+		void removeUnlistedPMTs_L(FeID id);
+
+		/// Let @see filterData rebuild the PID action table before using it
+		void markPIDActionTableChanged() {
+			_pidActionChanged = true;
+		}
+
 		/// Open requesed PID filter
 		/// @param feID specifies the frontend ID
 		/// @param pid specifies the PID to open with openPid
@@ -178,6 +321,7 @@ class Filter :
 			const bool done = openPid(pid);
 			if (done) {
 				_pidTable.setPIDOpened(pid);
+				markPIDActionTableChanged();
 				SI_LOG_DEBUG("Frontend: @#1, Set filter PID: @#2@#3",
 					feID, PID(pid),
 					_pat->isMarkedAsPMT(pid) ? " - PMT" : "");
@@ -199,6 +343,7 @@ class Filter :
 					_pat->isMarkedAsPMT(pid) ? " - PMT" : "");
 				// Clear stats
 				_pidTable.setPIDClosed(pid);
+				markPIDActionTableChanged();
 				// Need to clear the PID Tables as well?
 				if (pid == 0) {
 					_pat = std::make_shared<PAT>();
@@ -233,12 +378,38 @@ class Filter :
 		mutable PMTMap _pmtMap;
 
 		mutable mpegts::PidTable _pidTable;
+		mpegts::PidStatistics _pidStatistics;
+		mpegts::TR101290 _tr101290;
 		mutable mpegts::SpNIT _nit;
 		mutable mpegts::SpPAT _pat;
 		mutable mpegts::SpPCR _pcr;
 		mutable mpegts::SpSDT _sdt;
+		/// The broadcast clock and EPG index are kept when the filter is cleared,
+		/// they are not bound to a tuning
+		mpegts::TDT _tdt;
+		mpegts::EIT _eit;
 		bool _filterPCR = false;
+		bool _collectEPG = true;
 		std::string _userPids;
+		/// PID 20 is always opened for the broadcast clock, but only send when
+		/// it was requested by the client or the user PIDs
+		bool _tdtPIDRequested = false;
+		/// Action of each PID, rebuild only when the PIDs, PAT or PMTs change
+		std::array<PidAction, PidTable::ALL_PIDS> _pidAction;
+		std::atomic_bool _pidActionChanged{true};
+		std::atomic_bool _psiChanged{false};
+		/// Service selected with 'service=', or -1 when streaming the requested PIDs
+		std::atomic_int _serviceID{-1};
+		int _servicePMTPID = -1;
+		std::set<int> _servicePIDs;
+		/// Single program PAT of the selected service, the CC is set when it is send
+		TSData _servicePAT;
+		int _servicePATVersion = 0;
+		int _servicePATCC = 0;
+		/// The PMT section of the selected service is being send, and its CC
+		bool _servicePMTPass = false;
+		int _servicePMTCC = 0;
+		std::atomic_bool _servicePIDsChanged{false};
 };
 
 }
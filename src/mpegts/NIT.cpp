@@ -183,11 +183,11 @@ void NIT::parse(const FeID id) {
 	for (std::size_t secNr = 0; secNr < _numberOfSections; ++secNr) {
 		TableData::Data tableData;
 		if (getDataForSectionNumber(secNr, tableData)) {
-			const unsigned char *data = tableData.data.c_str();
+			const unsigned char *data = tableData.data;
 			size_t index = 8;
 			_nid =  getWord(index, data);
 
-//			SI_LOG_BIN_DEBUG(data, tableData.data.size(), "Frontend: @#1, NIT data", id);
+//			SI_LOG_BIN_DEBUG(data, tableData.size, "Frontend: @#1, NIT data", id);
 
 			SI_LOG_INFO("Frontend: @#1, NIT - Section Length: @#2  NID: @#3  Version: @#4  secNr: @#5 lastSecNr: @#6  CRC: @#7",
 				id, DIGIT(tableData.sectionLength, 4), DIGIT(_nid, 4), tableData.version, tableData.secNr, tableData.lastSecNr, HEX(tableData.crc, 4));
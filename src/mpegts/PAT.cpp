@@ -32,6 +32,7 @@ namespace mpegts {
 void PAT::clear() {
 	_tid = 0;
 	_pmtPidTable.clear();
+	_programMap.clear();
 	TableData::clear();
 }
 
@@ -48,52 +49,16 @@ void PAT::doAddToXML(std::string &xml) const {
 void PAT::doFromXML(const std::string &UNUSED(xml)) {}
 
 // =============================================================================
-//  -- Other member functions --------------------------------------------------
+// -- Static member functions --------------------------------------------------
 // =============================================================================
 
-void PAT::parse(const FeID id) {
-	Data tableData;
-	if (getDataForSectionNumber(0, tableData)) {
-		const unsigned char *data = tableData.data.c_str();
-		_tid =  (data[8u] << 8) | data[9u];
-
-//		SI_LOG_BIN_DEBUG(data, tableData.data.size(), "Frontend: @#1, PAT data", id);
-
-		SI_LOG_INFO("Frontend: @#1, PAT - Section Length: @#2  TID: @#3  Version: @#4  secNr: @#5 lastSecNr: @#6  CRC: @#7",
-			id, DIGIT(tableData.sectionLength, 4), _tid, tableData.version, tableData.secNr, tableData.lastSecNr, HEX(tableData.crc, 4));
-
-		// 4 = CRC  5 = PAT Table begin from section length
-		const size_t len = tableData.sectionLength - 4u - 5u;
-
-		// skip to Table begin and iterate over entries
-		const unsigned char *ptr = &data[13u];
-		for (size_t i = 0u; i < len; i += 4u) {
-			// Get PAT entry
-			const int prognr =  (ptr[i + 0u] << 8) | ptr[i + 1u];
-			const int pid    = ((ptr[i + 2u] & 0x1F) << 8) | ptr[i + 3u];
-			if (prognr == 0u) {
-				SB_LOG_INFO(MPEGTS_TABLES, "Frontend: @#1, PAT: Prog NR: @#2 - @#3  NIT PID: @#4",
-					id, HEX(prognr, 4), DIGIT(prognr, 5), DIGIT(pid, 4));
-			} else {
-				SB_LOG_INFO(MPEGTS_TABLES, "Frontend: @#1, PAT: Prog NR: @#2 - @#3  PMT PID: @#4",
-					id, HEX(prognr, 4), DIGIT(prognr, 5), DIGIT(pid, 4));
-				_pmtPidTable[pid] = true;
-			}
-		}
-	}
-}
-
-mpegts::TSData PAT::generateFrom(
-		FeID UNUSED(id), const base::M3UParser::TransformationMap &info) {
-	static int cc = 0;
-
-	int version = 5;
+mpegts::TSData PAT::generatePacket(const int transportStreamID, const int version,
+		const int cc, const ProgramMap &programs) {
 	int currIndicator = 1;
 	int pid = 0; // for PAT
 //	int payloadStart = 1;
 	int payloadOnly = 1;
 	int scrambled = 0;
-	int transportStreamID = 0;
 
 	std::array<unsigned char, 188> tmp;
 	tmp[0]  = 0x47;
@@ -110,37 +75,22 @@ mpegts::TSData PAT::generateFrom(
 	tmp[11] = 0x00; // section number
 	tmp[12] = 0x00; // last section number
 
-	++cc;
-	cc %= 0x10;
-
 	int index = 13;
 
-	// First program is NIT
-	tmp[index + 0] = 0x00; //
-	tmp[index + 1] = 0x00; //
-	tmp[index + 2] = 0x00; //
-	tmp[index + 3] = 0x10; //
-	index += 4;
-
-	int prognr = 0x4000;
-	int pmtPid = 0x0100;
-
-	for (auto [freq, element] : info) {
-//		SI_LOG_DEBUG("Frontend: @#1, Generating PAT: TID: @#2  Prog NR: @#3 - @#4  PMT PID: @#5  CC: @#6",
-//			id, transportStreamID, HEX(prognr, 4), DIGIT(prognr, 5), element.freq, cc);
+	// 13 = Header  4 = CRC, so the programs should fit in one TS packet
+	for (const auto &[prognr, pmtPid] : programs) {
+		if (index + 4 + 4 > static_cast<int>(tmp.size())) {
+			break;
+		}
 		tmp[index + 0] = (prognr & 0xFF00) >> 8;
 		tmp[index + 1] = (prognr & 0x00FF);
-		tmp[index + 2] = (pmtPid & 0x1F00) >> 8; //
-		tmp[index + 3] = (pmtPid & 0x00FF); //
+		tmp[index + 2] = 0xE0 | ((pmtPid & 0x1F00) >> 8);
+		tmp[index + 3] = (pmtPid & 0x00FF);
 		index += 4;
-
-		// Increment program and pid
-		++prognr;
-		pmtPid += 0x10;
 	}
 	// Adjust lenght
 	int len = index - 8 + 4;
-	tmp[6]  = (len & 0xFF00) >> 8;
+	tmp[6]  = 0xB0 | ((len & 0x0F00) >> 8);
 	tmp[7]  = len & 0xFF;
 
 	// append calculated CRC
@@ -157,4 +107,64 @@ mpegts::TSData PAT::generateFrom(
 	return TSData(tmp.data(), tmp.size());
 }
 
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void PAT::parse(const FeID id) {
+	Data tableData;
+	if (getDataForSectionNumber(0, tableData)) {
+		const unsigned char *data = tableData.data;
+		_tid =  (data[8u] << 8) | data[9u];
+
+//		SI_LOG_BIN_DEBUG(data, tableData.size, "Frontend: @#1, PAT data", id);
+
+		SI_LOG_INFO("Frontend: @#1, PAT - Section Length: @#2  TID: @#3  Version: @#4  secNr: @#5 lastSecNr: @#6  CRC: @#7",
+			id, DIGIT(tableData.sectionLength, 4), _tid, tableData.version, tableData.secNr, tableData.lastSecNr, HEX(tableData.crc, 4));
+
+		// 4 = CRC  5 = PAT Table begin from section length
+		const size_t len = tableData.sectionLength - 4u - 5u;
+
+		// skip to Table begin and iterate over entries
+		const unsigned char *ptr = &data[13u];
+		for (size_t i = 0u; i < len; i += 4u) {
+			// Get PAT entry
+			const int prognr =  (ptr[i + 0u] << 8) | ptr[i + 1u];
+			const int pid    = ((ptr[i + 2u] & 0x1F) << 8) | ptr[i + 3u];
+			if (prognr == 0u) {
+				SB_LOG_INFO(MPEGTS_TABLES, "Frontend: @#1, PAT: Prog NR: @#2 - @#3  NIT PID: @#4",
+					id, HEX(prognr, 4), DIGIT(prognr, 5), DIGIT(pid, 4));
+			} else {
+				SB_LOG_INFO(MPEGTS_TABLES, "Frontend: @#1, PAT: Prog NR: @#2 - @#3  PMT PID: @#4",
+					id, HEX(prognr, 4), DIGIT(prognr, 5), DIGIT(pid, 4));
+				_pmtPidTable[pid] = true;
+				_programMap[prognr] = pid;
+			}
+		}
+	}
+}
+
+mpegts::TSData PAT::generateFrom(
+		FeID UNUSED(id), const base::M3UParser::TransformationMap &info) {
+	static int cc = 0;
+
+	// First program is NIT
+	ProgramMap programs;
+	programs[0] = 0x0010;
+
+	int prognr = 0x4000;
+	int pmtPid = 0x0100;
+	for (std::size_t i = 0; i < info.size(); ++i) {
+		programs[prognr] = pmtPid;
+		// Increment program and pid
+		++prognr;
+		pmtPid += 0x10;
+	}
+	const TSData pat = generatePacket(0, 5, cc, programs);
+	++cc;
+	cc %= 0x10;
+	return pat;
+}
+
 }
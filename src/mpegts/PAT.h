@@ -25,6 +25,7 @@
 #include <base/XMLSupport.h>
 #include <mpegts/TableData.h>
 
+#include <map>
 #include <string>
 #include <unordered_map>
 
@@ -62,6 +63,22 @@ class PAT :
 		/// @see XMLSupport
 		virtual void doFromXML(const std::string &xml) final;
 
+		// =========================================================================
+		// -- Static member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Program numbers mapped to their PMT PID, program 0 maps to the NIT PID
+		using ProgramMap = std::map<int, int>;
+
+		/// Generate a PAT of one TS packet with the programs
+		/// @param transportStreamID specifies the TID of the PAT
+		/// @param version specifies the version of the PAT
+		/// @param cc specifies the continuity counter of the TS packet
+		/// @param programs specifies the programs of the PAT
+		static TSData generatePacket(int transportStreamID, int version, int cc,
+				const ProgramMap &programs);
+
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
@@ -69,6 +86,19 @@ class PAT :
 
 		void parse(FeID id);
 
+		/// Get the transport stream ID of this PAT
+		uint16_t getTransportStreamID() const {
+			return _tid;
+		}
+
+		/// Get the PMT PID of the requested program
+		/// @param programNumber specifies the program (service ID)
+		/// @return the PMT PID or -1 if the program is not in this PAT
+		int getPMTPID(const int programNumber) const {
+			const auto s = _programMap.find(programNumber);
+			return (s != _programMap.end()) ? s->second : -1;
+		}
+
 		bool isMarkedAsPMT(const int pid) const {
 			const auto s = _pmtPidTable.find(pid);
 			if (s != _pmtPidTable.end()) {
@@ -87,6 +117,7 @@ class PAT :
 
 		uint16_t _tid = 0;
 		std::unordered_map<int, bool> _pmtPidTable;
+		ProgramMap _programMap;
 };
 
 }
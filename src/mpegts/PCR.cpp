@@ -20,7 +20,8 @@
 #include <mpegts/PCR.h>
 
 #include <Unused.h>
-#include <Log.h>
+
+#include <algorithm>
 
 namespace mpegts {
 
@@ -28,44 +29,88 @@ namespace mpegts {
 // -- Constructors and destructor ----------------------------------------------
 // =============================================================================
 
-PCR::PCR() :
-	_pcrPrev(0),
-	_pcrDelta(0) {}
+PCR::PCR() {
+	reset();
+}
 
 // =============================================================================
 //  -- Other member functions --------------------------------------------------
 // =============================================================================
 
 void PCR::collectData(const FeID UNUSED(id), const unsigned char *data) {
-	if (isPCRTableData(data)) {
-		//        4           3          2          1          0
-		// 76543210 98765432 10987654 32109876 54321098 76543210
-		// xxxxxxxx xxxxxxxx xxxxxxxx xxxxxxxx xRRRRRRx xxxxxxxx
-		// 21098765 43210987 65432109 87654321 0      8 76543210
-		//   3          2          1           0               0
-		//  b6       b7       b8       b9       b10      b11
-		// PCR Base runs with 90KHz and PCR Ext runs with 27MHz
-		#define PCR_BASE(DATA) static_cast<uint64_t>(DATA[6] << 24 | DATA[7] << 16 | DATA[8] << 8 | DATA[9]) << 1
-		#define PCR_EXT(DATA)  static_cast<uint64_t>((DATA[10] & 0x01 << 8) | DATA[11])
-
-		const uint64_t pcrCur = PCR_BASE(data);
-
-		_pcrDelta = pcrCur - _pcrPrev;
-		_pcrPrev = pcrCur;
-		if (_pcrDelta < 0) {
-			_pcrDelta = 1;
+	const int pid = ((data[1] & 0x1f) << 8) | data[2];
+	// A PCR needs an adaptation field of at least 7 bytes
+	if (isPCRTableData(data) && data[4] >= 7) {
+		addPCR(pid, getPCRValue(data), isDiscontinuity(data), Clock::now());
+	} else if (isDiscontinuity(data)) {
+		// The next PCR of the locked PID is discontinuous
+		base::MutexLock lock(_mutex);
+		if (pid == _tracker.getPID()) {
+			_discontinuityPending = true;
 		}
-		if (_pcrDelta > 75000) {
-			_pcrDelta = 75000;
-		}
-		_pcrDelta *= 11;  // 11 -> PCR_Base runs with 90KHz
-		#undef PCR_BASE
-		#undef PCR_EXT
 	}
 }
 
-std::int64_t PCR::getPCRDelta() const {
-	return _pcrDelta;
+void PCR::addPCR(const int pid, const std::uint64_t pcr, const bool discontinuity, const Clock::time_point arrival) {
+	base::MutexLock lock(_mutex);
+	const PCRTracker::Result result = _tracker.addPCR(pid, pcr,
+		discontinuity || _discontinuityPending, arrival);
+	if (result == PCRTracker::Result::Ignored) {
+		return;
+	}
+	_discontinuityPending = false;
+	bool restart = true;
+	if (result == PCRTracker::Result::Continuous) {
+		_pcrUnwrapped += _tracker.getDelta();
+		restart = false;
+	} else if (_started) {
+		// Keep the time line continuous over the discontinuity, or the lost
+		// PCR PID, with the local clock
+		const double elapsed = std::chrono::duration<double>(arrival - _arrivalPrev).count();
+		_pcrUnwrapped += static_cast<std::uint64_t>(std::max(0.0, elapsed) * CLOCK_FREQUENCY);
+		++_discontinuities;
+	}
+	_arrivalPrev = arrival;
+	_started = true;
+	if (restart) {
+		_anchorTime = arrival;
+		_anchorPCR = _pcrUnwrapped;
+	}
+
+	// Deadline at the nominal clock rate from the anchor, anchor again when we
+	// are far behind (reading stalled) or far ahead (PCR jumped)
+	_deadline = _anchorTime + std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<double>(static_cast<double>(_pcrUnwrapped - _anchorPCR) / CLOCK_FREQUENCY));
+	if (_deadline > arrival + MAX_DEADLINE_ERROR || _deadline + MAX_DEADLINE_ERROR < arrival) {
+		_anchorTime = arrival;
+		_anchorPCR = _pcrUnwrapped;
+		_deadline = arrival;
+	}
+	_newDeadline = true;
+}
+
+void PCR::reset() {
+	base::MutexLock lock(_mutex);
+	_tracker.reset();
+	_pcrUnwrapped = 0;
+	_arrivalPrev = Clock::time_point();
+	_started = false;
+	_discontinuityPending = false;
+	_discontinuities = 0;
+	_anchorTime = Clock::time_point();
+	_anchorPCR = 0;
+	_deadline = Clock::time_point();
+	_newDeadline = false;
+}
+
+bool PCR::getNextDeadline(Clock::time_point &deadline) {
+	base::MutexLock lock(_mutex);
+	if (!_newDeadline) {
+		return false;
+	}
+	_newDeadline = false;
+	deadline = _deadline;
+	return true;
 }
 
 }
@@ -22,14 +22,25 @@
 
 #include <Defs.h>
 #include <FwDecl.h>
+#include <base/Mutex.h>
+#include <mpegts/PCRTracker.h>
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 
 FW_DECL_SP_NS1(mpegts, PCR);
 
 namespace mpegts {
 
+/// The class @c PCR recovers the clock of a stream from the PCRs of one PID.
+/// It locks onto the first PID carrying a PCR with @see PCRTracker and unwraps
+/// its PCRs into one continuous 27MHz time line, also over discontinuities. This gives the
+/// deadlines to pace a stream at the nominal rate of its own clock.
 class PCR {
+	public:
+		using Clock = std::chrono::steady_clock;
+
 		// =========================================================================
 		// -- Constructors and destructor ------------------------------------------
 		// =========================================================================
@@ -44,24 +55,71 @@ class PCR {
 		// =========================================================================
 	public:
 
+		/// Frequency of the PCR clock (PCR base * 300 + PCR extension)
+		static constexpr std::uint64_t CLOCK_FREQUENCY = 27000000;
+
+		/// The PCR wraps around after 2^33 ticks of the 90KHz PCR base
+		static constexpr std::uint64_t WRAP_AROUND = (UINT64_C(1) << 33) * 300;
+
 		/// This will check for 'adaptation field flag' and 'PCR field present' to
 		/// indicate this is an PCR table
 		static bool isPCRTableData(const unsigned char *data) {
 			return ((data[3] & 0x20) == 0x20 && (data[5] & 0x10) == 0x10);
 		}
 
+		/// This will check for the 'discontinuity indicator' of the adaptation field
+		static bool isDiscontinuity(const unsigned char *data) {
+			return ((data[3] & 0x20) == 0x20 && data[4] > 0 && (data[5] & 0x80) == 0x80);
+		}
+
+		/// Get the PCR of this TS packet in ticks of the 27MHz clock, check it
+		/// with @see isPCRTableData first
+		static std::uint64_t getPCRValue(const unsigned char *data) {
+			const std::uint64_t base =
+				(static_cast<std::uint64_t>(data[6]) << 25) |
+				(static_cast<std::uint64_t>(data[7]) << 17) |
+				(static_cast<std::uint64_t>(data[8]) <<  9) |
+				(static_cast<std::uint64_t>(data[9]) <<  1) |
+				(static_cast<std::uint64_t>(data[10]) >> 7);
+			const std::uint64_t ext = (static_cast<std::uint64_t>(data[10] & 0x01) << 8) | data[11];
+			return base * 300 + ext;
+		}
+
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
 	public:
 
-		/// Collect Table data for tableID
+		/// Collect the PCR of this TS packet, with the current time as arrival time
 		void collectData(FeID id, const unsigned char *data);
 
-		std::int64_t getPCRDelta() const;
+		/// Add a PCR to the clock recovery, PCRs of an other PID then the locked
+		/// one are ignored until the locked PID times out
+		/// @param pid specifies the PID that carries the PCR
+		/// @param pcr specifies the PCR in ticks of the 27MHz clock
+		/// @param discontinuity specifies if the discontinuity indicator was set
+		/// @param arrival specifies the time the PCR arrived
+		void addPCR(int pid, std::uint64_t pcr, bool discontinuity, Clock::time_point arrival);
+
+		/// Forget the PCR lock and all PCRs, the next PCR starts a new anchor
+		void reset();
+
+		/// Get the time the TS packet with the last PCR should be played, when
+		/// the stream is played at the nominal rate of its clock. This returns only true once for
+		/// each new PCR, so it can be used to pace the reading of the stream
+		/// @param deadline will be set to the time the last PCR should be played
+		bool getNextDeadline(Clock::time_point &deadline);
+
+		/// Get the PID the clock is locked onto, or -1 when not locked (yet)
+		int getPCRPID() const {
+			base::MutexLock lock(_mutex);
+			return _tracker.getPID();
+		}
 
-		void clearPCRDelta() {
-			_pcrDelta = 0;
+		/// Get the number of discontinuities found
+		std::size_t getDiscontinuities() const {
+			base::MutexLock lock(_mutex);
+			return _discontinuities;
 		}
 
 		// =========================================================================
@@ -69,8 +127,22 @@ class PCR {
 		// =========================================================================
 	private:
 
-		std::uint64_t _pcrPrev;
-		std::int64_t _pcrDelta;
+		/// Anchor again when the deadline is this far from the arrival time
+		static constexpr Clock::duration MAX_DEADLINE_ERROR = std::chrono::seconds(1);
+
+		mutable base::Mutex _mutex;
+		PCRTracker _tracker;
+		/// The PCR in one continuous time line, without wraps and discontinuities
+		std::uint64_t _pcrUnwrapped;
+		Clock::time_point _arrivalPrev;
+		bool _started;
+		bool _discontinuityPending;
+		std::size_t _discontinuities;
+
+		Clock::time_point _anchorTime;
+		std::uint64_t _anchorPCR;
+		Clock::time_point _deadline;
+		bool _newDeadline;
 };
 
 }
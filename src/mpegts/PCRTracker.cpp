@@ -0,0 +1,77 @@
+/* PCRTracker.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/PCRTracker.h>
+
+#include <mpegts/PCR.h>
+
+namespace mpegts {
+
+/// PCRs should be 100ms apart at most, a gap of more then 500ms is a discontinuity
+static constexpr std::uint64_t MAX_PCR_INTERVAL = PCR::CLOCK_FREQUENCY / 2;
+/// Unlock the PCR PID when it was not seen for this time
+static constexpr PCRTracker::Clock::duration PCR_TIMEOUT = std::chrono::seconds(1);
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+PCRTracker::PCRTracker() {
+	reset();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void PCRTracker::reset() {
+	_pid = -1;
+	_pcrPrev = 0;
+	_delta = 0;
+	_seen = Clock::time_point();
+}
+
+PCRTracker::Result PCRTracker::addPCR(const int pid, const std::uint64_t pcr,
+		const bool discontinuity, const Clock::time_point now) {
+	if (_pid != -1 && pid != _pid && !checkTimeout(now)) {
+		return Result::Ignored;
+	}
+	const std::uint64_t value = pcr % PCR::WRAP_AROUND;
+	Result result = Result::Locked;
+	if (_pid != -1) {
+		_delta = (value + PCR::WRAP_AROUND - _pcrPrev) % PCR::WRAP_AROUND;
+		result = (!discontinuity && _delta <= MAX_PCR_INTERVAL) ?
+			Result::Continuous : Result::Discontinuous;
+	}
+	_pid = pid;
+	_pcrPrev = value;
+	_seen = now;
+	return result;
+}
+
+bool PCRTracker::checkTimeout(const Clock::time_point now) {
+	// Lost the PCR PID (PID filter changed?), so lock onto the next one found
+	if (_pid != -1 && now - _seen > PCR_TIMEOUT) {
+		_pid = -1;
+		return true;
+	}
+	return false;
+}
+
+}
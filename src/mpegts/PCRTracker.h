@@ -0,0 +1,97 @@
+/* PCRTracker.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_PCRTRACKER_H_INCLUDE
+#define MPEGTS_PCRTRACKER_H_INCLUDE MPEGTS_PCRTRACKER_H_INCLUDE
+
+#include <chrono>
+#include <cstdint>
+
+namespace mpegts {
+
+/// The class @c PCRTracker follows the PCRs of one PID. It locks onto the
+/// first PID carrying a PCR, ignores the PCRs of the other PIDs and gives the
+/// ticks between two PCRs of the locked PID, also over a wrap around. When
+/// the locked PID is not seen for a while it locks onto the next one found.
+class PCRTracker {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/// What @see addPCR did with the PCR
+		enum class Result {
+			Ignored,      /// PCR of an other PID then the locked one
+			Locked,       /// First PCR of a newly locked PID
+			Continuous,   /// Next PCR of the locked PID, @see getDelta is valid
+			Discontinuous /// Discontinuity indicator set or a too big gap
+		};
+
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	public:
+
+		PCRTracker();
+
+		virtual ~PCRTracker() = default;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Forget the locked PID
+		void reset();
+
+		/// Follow this PCR, the locked PID is replaced when it timed out
+		/// @param pid specifies the PID that carries the PCR
+		/// @param pcr specifies the PCR in ticks of the 27MHz clock
+		/// @param discontinuity specifies if the discontinuity indicator was set
+		/// @param now specifies the current time
+		Result addPCR(int pid, std::uint64_t pcr, bool discontinuity, Clock::time_point now);
+
+		/// Forget the locked PID when it was not seen for a while
+		/// @param now specifies the current time
+		/// @return true if the locked PID timed out now
+		bool checkTimeout(Clock::time_point now);
+
+		/// Get the PID that is locked onto, or -1 when not locked (yet)
+		int getPID() const {
+			return _pid;
+		}
+
+		/// Get the ticks of the 27MHz clock between the last two PCRs, only
+		/// valid when @see addPCR returned Result::Continuous
+		std::uint64_t getDelta() const {
+			return _delta;
+		}
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		int _pid;
+		std::uint64_t _pcrPrev;
+		std::uint64_t _delta;
+		Clock::time_point _seen;
+};
+
+}
+
+#endif // MPEGTS_PCRTRACKER_H_INCLUDE
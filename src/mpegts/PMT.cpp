@@ -139,7 +139,7 @@ void PMT::cleanPI(unsigned char *data) {
 int PMT::parsePCRPid() {
 	Data tableData;
 	if (getDataForSectionNumber(0, tableData)) {
-		const unsigned char *const data = tableData.data.c_str();
+		const unsigned char *const data = tableData.data;
 		_pcrPID = ((data[13u] & 0x1F) << 8) | data[14u];
 	}
 	return _pcrPID;
@@ -148,13 +148,13 @@ int PMT::parsePCRPid() {
 void PMT::parse(const FeID id) {
 	Data tableData;
 	if (getDataForSectionNumber(0, tableData)) {
-		const unsigned char* const data = tableData.data.c_str();
+		const unsigned char* const data = tableData.data;
 		_programNumber = ((data[ 8u]       ) << 8) | data[ 9u];
 		_pcrPID        = ((data[13u] & 0x1F) << 8) | data[14u];
 		_prgLength     = ((data[15u] & 0x0F) << 8) | data[16u];
 
 		_pmtData.pid = tableData.pid;
-//		SI_LOG_BIN_DEBUG(data, tableData.data.size(), "Frontend: @#1, PMT data", id);
+//		SI_LOG_BIN_DEBUG(data, tableData.size, "Frontend: @#1, PMT data", id);
 		SI_LOG_INFO("Frontend: @#1, PMT - PID: @#2 - Section Length: @#3  Prog NR: @#4  Version: @#5  secNr: @#6  lastSecNr: @#7  PCR-PID: @#8  Program Length: @#9  CRC: @#10",
 			id, PID(tableData.pid), DIGIT(tableData.sectionLength, 4), DIGIT(_programNumber, 5), tableData.version,
 			tableData.secNr, tableData.lastSecNr, PID(_pcrPID), _prgLength, HEX(tableData.crc, 4));
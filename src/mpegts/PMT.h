@@ -25,6 +25,7 @@
 #include <mpegts/TableData.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 FW_DECL_SP_NS1(mpegts, PMT);
@@ -40,6 +41,7 @@ class PMT :
 	public:
 
 		struct ECMData;
+		struct ESData;
 
 		// =========================================================================
 		// -- Constructors and destructor ------------------------------------------
@@ -102,6 +104,10 @@ class PMT :
 			return _pmtData.ecmPID;
 		}
 
+		std::vector<ESData> getESPIDs() const {
+			return _pmtData.esPID;
+		}
+
 		bool isReadySend() const {
 			if (isCollected() && !_send) {
 				_send = true;
@@ -142,6 +148,9 @@ class PMT :
 		mutable bool _send = false;
 };
 
+/// The PMTs together with the PID they are received on
+using PMTVector = std::vector<std::pair<int, SpPMT>>;
+
 }
 
 #endif // MPEGTS_PMT_DATA_H_INCLUDE
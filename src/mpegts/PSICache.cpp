@@ -0,0 +1,182 @@
+/* PSICache.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/PSICache.h>
+
+#include <Log.h>
+#include <mpegts/PidTable.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace mpegts {
+
+// File layout: magic, then per transponder the key and the tables with
+// their PID and TS packets. All numbers are little endian.
+static constexpr char FILE_MAGIC[4] = { 'S', 'P', 'S', '1' };
+static constexpr uint32_t MAX_TABLE_SIZE = 256 * 188;
+
+template<typename T>
+static void writeNumber(std::ofstream &file, const T value) {
+	for (std::size_t i = 0; i < sizeof(T); ++i) {
+		file.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+	}
+}
+
+template<typename T>
+static bool readNumber(std::ifstream &file, T &value) {
+	value = 0;
+	for (std::size_t i = 0; i < sizeof(T); ++i) {
+		const int c = file.get();
+		if (c == std::ifstream::traits_type::eof()) {
+			return false;
+		}
+		value |= static_cast<T>(c & 0xFF) << (i * 8);
+	}
+	return true;
+}
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+PSICache::PSICache(const std::string &appDataPath) :
+	_filePath(appDataPath + "/PSICache.dat") {
+	restore();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+bool PSICache::find(const std::string &key, Tables &tables) {
+	base::MutexLock lock(_mutex);
+	const auto it = _entries.find(key);
+	if (it == _entries.end()) {
+		return false;
+	}
+	it->second.lastUsed = ++_useCounter;
+	tables = it->second.tables;
+	return true;
+}
+
+void PSICache::store(const std::string &key, const Tables &tables, const bool persist) {
+	base::MutexLock lock(_mutex);
+	auto it = _entries.find(key);
+	if (it == _entries.end()) {
+		// Make room by dropping the least recently used transponder
+		if (_entries.size() >= MAX_TRANSPONDERS) {
+			auto oldest = _entries.begin();
+			for (auto e = _entries.begin(); e != _entries.end(); ++e) {
+				if (e->second.lastUsed < oldest->second.lastUsed) {
+					oldest = e;
+				}
+			}
+			_changed |= oldest->second.persist;
+			_entries.erase(oldest);
+		}
+		it = _entries.emplace(key, Entry{ Tables(), 0, persist }).first;
+	} else if (it->second.tables == tables && it->second.persist == persist) {
+		it->second.lastUsed = ++_useCounter;
+		return;
+	}
+	it->second.tables = tables;
+	it->second.lastUsed = ++_useCounter;
+	it->second.persist = persist;
+	_changed = true;
+}
+
+void PSICache::save() {
+	base::MutexLock lock(_mutex);
+	if (!_changed) {
+		return;
+	}
+	_changed = false;
+	const std::string tmpPath = _filePath + ".tmp";
+	std::ofstream file(tmpPath, std::ofstream::binary | std::ofstream::trunc);
+	if (!file.is_open()) {
+		SI_LOG_ERROR("PSI Cache - Unable to open @#1", tmpPath);
+		return;
+	}
+	file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+	std::size_t count = 0;
+	for (const auto &[key, entry] : _entries) {
+		if (!entry.persist) {
+			continue;
+		}
+		writeNumber<uint16_t>(file, key.size());
+		file.write(key.data(), key.size());
+		writeNumber<uint16_t>(file, entry.tables.size());
+		for (const auto &[pid, packets] : entry.tables) {
+			writeNumber<uint16_t>(file, pid);
+			writeNumber<uint32_t>(file, packets.size());
+			file.write(reinterpret_cast<const char *>(packets.data()), packets.size());
+		}
+		++count;
+	}
+	file.close();
+	if (!file || std::rename(tmpPath.c_str(), _filePath.c_str()) != 0) {
+		SI_LOG_ERROR("PSI Cache - Unable to save @#1", _filePath);
+		std::remove(tmpPath.c_str());
+		return;
+	}
+	SI_LOG_DEBUG("PSI Cache - Saved @#1 transponders to @#2", count, _filePath);
+}
+
+void PSICache::restore() {
+	base::MutexLock lock(_mutex);
+	std::ifstream file(_filePath, std::ifstream::binary);
+	if (!file.is_open()) {
+		return;
+	}
+	char magic[sizeof(FILE_MAGIC)];
+	if (!file.read(magic, sizeof(magic)) ||
+		!std::equal(magic, magic + sizeof(magic), FILE_MAGIC)) {
+		SI_LOG_ERROR("PSI Cache - @#1 is not a PSI cache file, ignoring it", _filePath);
+		return;
+	}
+	uint16_t keySize;
+	while (readNumber(file, keySize)) {
+		std::string key(keySize, '\0');
+		uint16_t numberOfTables;
+		if (!file.read(&key[0], keySize) || !readNumber(file, numberOfTables)) {
+			break;
+		}
+		Entry entry{ Tables(), 0, true };
+		for (uint16_t i = 0; i < numberOfTables; ++i) {
+			uint16_t pid;
+			uint32_t size;
+			if (!readNumber(file, pid) || !readNumber(file, size) ||
+				pid >= PidTable::ALL_PIDS || size > MAX_TABLE_SIZE || (size % 188) != 0) {
+				SI_LOG_ERROR("PSI Cache - @#1 is corrupt, ignoring the rest", _filePath);
+				return;
+			}
+			TSData packets(size, 0);
+			if (!file.read(reinterpret_cast<char *>(&packets[0]), size)) {
+				return;
+			}
+			entry.tables[pid] = std::move(packets);
+		}
+		_entries[key] = std::move(entry);
+	}
+	SI_LOG_INFO("PSI Cache - Restored @#1 transponders from @#2", _entries.size(), _filePath);
+}
+
+}
@@ -0,0 +1,100 @@
+/* PSICache.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_PSICACHE_H_INCLUDE
+#define MPEGTS_PSICACHE_H_INCLUDE MPEGTS_PSICACHE_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Mutex.h>
+#include <mpegts/TableData.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+FW_DECL_SP_NS1(mpegts, PSICache);
+
+namespace mpegts {
+
+/// The class @c PSICache keeps the last seen PAT, PMT and SDT sections of
+/// each transponder as TS packets, so a @see Filter can be preloaded with
+/// them on tuning instead of waiting for them to be collected again.
+/// The cache is shared by all frontends and can be saved in the app data path.
+class PSICache {
+		// =========================================================================
+		//  -- Constructors and destructor -----------------------------------------
+		// =========================================================================
+	public:
+
+		/// @param appDataPath specifies the path were the cache file is saved
+		explicit PSICache(const std::string &appDataPath);
+
+		virtual ~PSICache() = default;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// The TS packets of the tables of one transponder, mapped by PID
+		using Tables = std::map<int, TSData>;
+
+		/// Find the cached tables of the requested transponder
+		/// @param key specifies the transponder, @see Frontend
+		/// @param tables will be filled with the cached tables
+		bool find(const std::string &key, Tables &tables);
+
+		/// Store the tables of the requested transponder
+		/// @param key specifies the transponder
+		/// @param tables specifies the TS packets of the collected tables
+		/// @param persist specifies if this transponder should be saved to file
+		void store(const std::string &key, const Tables &tables, bool persist);
+
+		/// Save the cache to file when there are changed transponders that
+		/// should be persisted
+		void save();
+
+	private:
+
+		/// Restore the cache from file
+		void restore();
+
+		// =========================================================================
+		//  -- Data members --------------------------------------------------------
+		// =========================================================================
+	private:
+
+		static constexpr std::size_t MAX_TRANSPONDERS = 64;
+
+		struct Entry {
+			Tables tables;
+			uint64_t lastUsed;
+			bool persist;
+		};
+
+		base::Mutex _mutex;
+		std::string _filePath;
+		std::map<std::string, Entry> _entries;
+		uint64_t _useCounter = 0;
+		bool _changed = false;
+};
+
+}
+
+#endif // MPEGTS_PSICACHE_H_INCLUDE
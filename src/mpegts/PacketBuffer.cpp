@@ -21,13 +21,14 @@
 
 #include <Log.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <climits>
 
 namespace mpegts {
 
-static_assert(PacketBuffer::MTU_MAX_TS_PACKET_SIZE < PacketBuffer::MTU, "TS Packet size bigger then MTU");
+static_assert(PacketBuffer::MAX_BUFFER_SIZE + 4 <= 0xFFFF, "TS Packet size bigger then RTP/TCP frame");
 static_assert(CHAR_BIT == 8, "Error CHAR_BIT != 8");
 
 // =============================================================================
@@ -52,6 +53,18 @@ void PacketBuffer::initialize(const uint32_t ssrc, const long timestamp) {
 	_initialized = true;
 }
 
+void PacketBuffer::setNumberOfTSPackets(const std::size_t packets) {
+	_numberOfTSPackets = std::clamp<std::size_t>(packets, 1, MAX_NUMBER_OF_TS_PACKETS);
+	// Only keep the memory that is needed, the RTP header is kept
+	_buffer.resize(RTP_HEADER_LEN + (TS_PACKET_SIZE * _numberOfTSPackets));
+}
+
+std::size_t PacketBuffer::getNumberOfTSPacketsForMTU(const std::size_t mtu) {
+	const std::size_t header = IP_UDP_HEADER_LEN + RTP_HEADER_LEN;
+	const std::size_t packets = (mtu > header) ? (mtu - header) / TS_PACKET_SIZE : 1;
+	return std::clamp<std::size_t>(packets, 1, MAX_NUMBER_OF_TS_PACKETS);
+}
+
 bool PacketBuffer::trySyncing() {
 	const std::size_t size = getCurrentBufferSize();
 	if (size < (TS_PACKET_SIZE * 3)) {
@@ -60,18 +73,15 @@ bool PacketBuffer::trySyncing() {
 	if (isSynced()) {
 		return true;
 	}
-	for (size_t i = RTP_HEADER_LEN; i < MTU_MAX_TS_PACKET_SIZE + RTP_HEADER_LEN - (TS_PACKET_SIZE * 2); ++i) {
-		const unsigned char *cData = _buffer + i;
-		if (cData[TS_PACKET_SIZE * 0] == 0x47 &&
-			cData[TS_PACKET_SIZE * 1] == 0x47 &&
-			cData[TS_PACKET_SIZE * 2] == 0x47) {
-			// found sync, now move it to begin of buffer
-			const size_t cpySize = (MTU_MAX_TS_PACKET_SIZE + RTP_HEADER_LEN) - i;
-			_writeIndex = _writeIndex - (i - RTP_HEADER_LEN);
-			_processedIndex = _writeIndex;
-			std::memmove(_buffer + RTP_HEADER_LEN, cData, cpySize);
-			return true;
-		}
+	// Only search the data that is written, the buffer size may be configured
+	const std::size_t offset = PacketScan::findSync(getTSReadBufferPtr(), size);
+	if (offset < size) {
+		// found sync, now move it to begin of buffer
+		const size_t cpySize = size - offset;
+		_writeIndex = RTP_HEADER_LEN + cpySize;
+		_processedIndex = _writeIndex;
+		std::memmove(&_buffer[RTP_HEADER_LEN], &_buffer[RTP_HEADER_LEN + offset], cpySize);
+		return true;
 	}
 	// did not find a sync, so flush buffer
 	reset();
@@ -79,7 +89,7 @@ bool PacketBuffer::trySyncing() {
 }
 
 void PacketBuffer::markTSForPurging(std::size_t packetNumber) {
-	if (packetNumber <= NUMBER_OF_TS_PACKETS) {
+	if (packetNumber < _numberOfTSPackets) {
 		// Invalid TS packets are labeled 0xFF _after_ the first SYNC Byte.
 		unsigned char *cData = getTSPacketPtr(packetNumber);
 		cData[1] = 0xFF;
@@ -93,30 +103,37 @@ void PacketBuffer::purge() {
 	}
 	_purgePending = 0;
 	const std::size_t bufSize = getCurrentBufferSize();
-	if (bufSize == 0) {
+	const std::size_t packets = bufSize / TS_PACKET_SIZE;
+	if (packets == 0) {
 		return;
 	}
-	// i: represents the packet number, and not the packet position!
-	std::size_t skipData = 0;
-	for (std::size_t i = (bufSize / TS_PACKET_SIZE); i > 0 ; --i) {
-		unsigned char *cData = getTSPacketPtr(i - 1);
-		if (cData[1] == 0xFF) {
-			// Next packet needs to be purged as well, then continue to next
-			if (i > 1 && (cData - TS_PACKET_SIZE)[1] == 0xFF) {
-				skipData += TS_PACKET_SIZE;
-				continue;
-			}
-			skipData += TS_PACKET_SIZE;
-			// Remove current (plus other) packet from the buffer
-			unsigned char *endData = getWriteBufferPtr();
-			unsigned char *nextData = cData + skipData;
-			if (nextData < endData) {
-				std::memcpy(cData, nextData, endData - nextData);
-			}
-			_writeIndex -= skipData;
-			skipData = 0;
+	// Compact in place with one pass, every run of packets that stay is
+	// moved once. An incomplete packet at the end is kept as well
+	const std::uint64_t marked = PacketScan::getHeaderMasks(getTSPacketPtr(0), packets).marked;
+	std::size_t keep = 0;
+	std::size_t i = 0;
+	while (i < packets) {
+		if (((marked >> i) & 1) != 0) {
+			++i;
+			continue;
+		}
+		std::size_t end = i + 1;
+		while (end < packets && ((marked >> end) & 1) == 0) {
+			++end;
 		}
+		if (keep != i) {
+			std::memmove(getTSPacketPtr(keep), getTSPacketPtr(i), (end - i) * TS_PACKET_SIZE);
+		}
+		keep += end - i;
+		i = end;
+	}
+	const std::size_t partial = bufSize - (packets * TS_PACKET_SIZE);
+	if (partial != 0 && keep != packets) {
+		std::memmove(getTSPacketPtr(keep), getTSPacketPtr(packets), partial);
 	}
+	_writeIndex = RTP_HEADER_LEN + (keep * TS_PACKET_SIZE) + partial;
+	// Everything that is left was filtered already
+	_processedIndex = _writeIndex;
 }
 
 void PacketBuffer::tagRTPHeaderWith(const uint16_t cseq, const long timestamp) {
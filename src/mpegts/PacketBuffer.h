@@ -20,8 +20,11 @@
 #ifndef MPEGTS_PACKET_BUFFER_H_INCLUDE
 #define MPEGTS_PACKET_BUFFER_H_INCLUDE MPEGTS_PACKET_BUFFER_H_INCLUDE
 
+#include <mpegts/PacketScan.h>
+
 #include <cstdint>
 #include <cstddef>
+#include <vector>
 
 namespace mpegts {
 
@@ -42,14 +45,23 @@ class PacketBuffer {
 		/// Initialize this TS buffer
 		void initialize(uint32_t ssrc, long timestamp);
 
+		/// Set the amount of TS packets this buffer should carry, this should
+		/// only be changed on an empty buffer. The buffer is sized to it
+		/// @param packets a value from 1 up until MAX_NUMBER_OF_TS_PACKETS
+		void setNumberOfTSPackets(std::size_t packets);
+
+		/// Get the amount of TS packets that fit in one RTP/UDP datagram
+		/// @param mtu specifies the MTU of the network path
+		static std::size_t getNumberOfTSPacketsForMTU(std::size_t mtu);
+
 		/// get the amount of data that CAN be written to this TS buffer
-		static constexpr std::size_t getMaxBufferSize() {
-			return MTU_MAX_TS_PACKET_SIZE;
+		std::size_t getMaxBufferSize() const {
+			return _numberOfTSPackets * TS_PACKET_SIZE;
 		}
 
 		/// Check if we have written all of the TS Packets
 		bool full() const {
-			return (MTU_MAX_TS_PACKET_SIZE + RTP_HEADER_LEN) == _writeIndex;
+			return (getMaxBufferSize() + RTP_HEADER_LEN) == _writeIndex;
 		}
 
 		/// Check if we have written all of the TS Packets
@@ -69,7 +81,7 @@ class PacketBuffer {
 		bool trySyncing();
 
 		/// Mark one TS packet for purging (remove) by setting 0xFF _after_ the first SYNC Byte.
-		/// @param packetNumber a value from 0 up until NUMBER_OF_TS_PACKETS
+		/// @param packetNumber a value from 0 up until getMaxNumberOfTSPackets()
 		void markTSForPurging(std::size_t packetNumber);
 
 		/// Purge (remove) marked filtered TS packets
@@ -80,15 +92,15 @@ class PacketBuffer {
 
 		/// This function will return the maximum number of TS Packets that will fit
 		/// in this TS buffer
-		static constexpr std::size_t getMaxNumberOfTSPackets() {
-			return NUMBER_OF_TS_PACKETS;
+		std::size_t getMaxNumberOfTSPackets() const {
+			return _numberOfTSPackets;
 		}
 
 		/// This function will return the number of completed TS Packets that are
 		/// in this TS buffer
 		std::size_t getNumberOfCompletedPackets() const {
 			if (full()) {
-				return NUMBER_OF_TS_PACKETS;
+				return _numberOfTSPackets;
 			}
 			return (_writeIndex - RTP_HEADER_LEN) / TS_PACKET_SIZE;
 		}
@@ -113,7 +125,7 @@ class PacketBuffer {
 		/// This will return the amount of bytes that can still be written to
 		/// this TS buffer
 		std::size_t getAmountOfBytesToWrite() const {
-			return (MTU_MAX_TS_PACKET_SIZE + RTP_HEADER_LEN) - _writeIndex;
+			return (getMaxBufferSize() + RTP_HEADER_LEN) - _writeIndex;
 		}
 
 		/// Add the amount of bytes written, by increment the write index
@@ -129,7 +141,7 @@ class PacketBuffer {
 
 		/// This function will return the begin of this RTP packet
 		unsigned char *getReadBufferPtr() {
-			return _buffer;
+			return _buffer.data();
 		}
 
 		/// This function will return the begin of the first TS packet in this TS buffer
@@ -138,8 +150,8 @@ class PacketBuffer {
 			return &_buffer[RTP_HEADER_LEN];
 		}
 
-		/// Get the TS packet pointer for packets 0 up until NUMBER_OF_TS_PACKETS
-		/// @param packetNumber a value from 0 up until NUMBER_OF_TS_PACKETS
+		/// Get the TS packet pointer for packets 0 up until getMaxNumberOfTSPackets()
+		/// @param packetNumber a value from 0 up until getMaxNumberOfTSPackets()
 		unsigned char *getTSPacketPtr(std::size_t packetNumber) {
 			const std::size_t index = (packetNumber * TS_PACKET_SIZE) + RTP_HEADER_LEN;
 			return &_buffer[index];
@@ -165,11 +177,8 @@ class PacketBuffer {
 //			bool ready = (getCurrentBufferSize() % TS_PACKET_SIZE) == 0;
 			bool ready = full();
 			if (_decryptPending && ready) {
-				const std::size_t size = getNumberOfCompletedPackets();
-				for (std::size_t i = 0; i < size; ++i) {
-					const unsigned char *ts = getTSPacketPtr(i);
-					ready &= ((ts[3] & 0x80) != 0x80);
-				}
+				ready = PacketScan::getHeaderMasks(getTSPacketPtr(0),
+					getNumberOfCompletedPackets()).scrambled == 0;
 			}
 			return ready;
 		}
@@ -189,20 +198,25 @@ class PacketBuffer {
 		// =====================================================================
 	public:
 
-		static constexpr size_t MTU                    = 1500;
+		static constexpr size_t IP_UDP_HEADER_LEN      =   28;
 		static constexpr size_t RTP_HEADER_LEN         =   12;
 		static constexpr size_t TS_PACKET_SIZE         =  188;
 		static constexpr size_t NUMBER_OF_TS_PACKETS   =    7;
-		static constexpr size_t MTU_MAX_TS_PACKET_SIZE = TS_PACKET_SIZE * NUMBER_OF_TS_PACKETS;
+		/// Upper limit for jumbo frames and HTTP, 64 TS packets still fit in
+		/// the 16 bit length of RTP/TCP interleaved frames
+		static constexpr size_t MAX_NUMBER_OF_TS_PACKETS =  64;
+		static constexpr size_t MAX_BUFFER_SIZE = RTP_HEADER_LEN + (TS_PACKET_SIZE * MAX_NUMBER_OF_TS_PACKETS);
 
 	protected:
 
-		unsigned char       _buffer[MTU];
+		std::vector<unsigned char> _buffer = std::vector<unsigned char>(
+			RTP_HEADER_LEN + (TS_PACKET_SIZE * NUMBER_OF_TS_PACKETS));
 		std::size_t         _writeIndex = RTP_HEADER_LEN;
 		mutable std::size_t _processedIndex = RTP_HEADER_LEN;
 		bool                _initialized = false;
 		bool                _decryptPending = false;
 		std::size_t         _purgePending = 0;
+		std::size_t         _numberOfTSPackets = NUMBER_OF_TS_PACKETS;
 
 };
 
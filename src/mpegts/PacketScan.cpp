@@ -0,0 +1,219 @@
+/* PacketScan.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/PacketScan.h>
+
+#include <Log.h>
+#include <mpegts/PacketBuffer.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define PACKET_SCAN_X86
+	#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	#define PACKET_SCAN_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace mpegts {
+
+namespace {
+
+constexpr std::size_t TS_SIZE = PacketBuffer::TS_PACKET_SIZE;
+constexpr unsigned char SYNC = 0x47;
+
+using FindSyncFunc = std::size_t (*)(const unsigned char *, std::size_t);
+using HeaderMasksFunc = PacketScan::HeaderMasks (*)(const unsigned char *, std::size_t);
+
+struct Implementation {
+	const char *name;
+	FindSyncFunc findSync;
+	HeaderMasksFunc getHeaderMasks;
+};
+
+#if defined(PACKET_SCAN_X86) && defined(__SSE2__)
+
+// Compare 16 candidate offsets at once
+std::size_t findSyncSSE2(const unsigned char *data, const std::size_t size) {
+	std::size_t i = 0;
+	if (size > TS_SIZE * 2) {
+		const std::size_t end = size - (TS_SIZE * 2);
+		const __m128i sync = _mm_set1_epi8(SYNC);
+		for (; i + 16 <= end; i += 16) {
+			const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + TS_SIZE));
+			const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + TS_SIZE * 2));
+			const __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(a, sync),
+				_mm_and_si128(_mm_cmpeq_epi8(b, sync), _mm_cmpeq_epi8(c, sync)));
+			const unsigned int mask = _mm_movemask_epi8(eq);
+			if (mask != 0) {
+				return i + __builtin_ctz(mask);
+			}
+		}
+	}
+	return i + PacketScan::findSyncScalar(data + i, size - i);
+}
+
+#endif
+
+#if defined(PACKET_SCAN_X86)
+
+// Compare 32 candidate offsets at once
+__attribute__((target("avx2")))
+std::size_t findSyncAVX2(const unsigned char *data, const std::size_t size) {
+	std::size_t i = 0;
+	if (size > TS_SIZE * 2) {
+		const std::size_t end = size - (TS_SIZE * 2);
+		const __m256i sync = _mm256_set1_epi8(SYNC);
+		for (; i + 32 <= end; i += 32) {
+			const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+			const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + TS_SIZE));
+			const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + TS_SIZE * 2));
+			const __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(a, sync),
+				_mm256_and_si256(_mm256_cmpeq_epi8(b, sync), _mm256_cmpeq_epi8(c, sync)));
+			const unsigned int mask = _mm256_movemask_epi8(eq);
+			if (mask != 0) {
+				return i + __builtin_ctz(mask);
+			}
+		}
+	}
+	return i + PacketScan::findSyncScalar(data + i, size - i);
+}
+
+// Gather the first 4 bytes of 8 TS packets at once, then the sign bit of
+// each 32 bit lane is the scramble bit (byte 3, bit 7)
+__attribute__((target("avx2")))
+PacketScan::HeaderMasks getHeaderMasksAVX2(const unsigned char *data, const std::size_t packets) {
+	PacketScan::HeaderMasks masks{0, 0};
+	const __m256i offset = _mm256_setr_epi32(
+		TS_SIZE * 0, TS_SIZE * 1, TS_SIZE * 2, TS_SIZE * 3,
+		TS_SIZE * 4, TS_SIZE * 5, TS_SIZE * 6, TS_SIZE * 7);
+	const __m256i byte1 = _mm256_set1_epi32(0x0000FF00);
+	std::size_t i = 0;
+	for (; i + 8 <= packets; i += 8) {
+		const __m256i header = _mm256_i32gather_epi32(
+			reinterpret_cast<const int *>(data + (i * TS_SIZE)), offset, 1);
+		const std::uint64_t scrambled = _mm256_movemask_ps(_mm256_castsi256_ps(header));
+		const __m256i eq = _mm256_cmpeq_epi32(_mm256_and_si256(header, byte1), byte1);
+		const std::uint64_t marked = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+		masks.scrambled |= scrambled << i;
+		masks.marked |= marked << i;
+	}
+	if (i < packets) {
+		const PacketScan::HeaderMasks rest =
+			PacketScan::getHeaderMasksScalar(data + (i * TS_SIZE), packets - i);
+		masks.scrambled |= rest.scrambled << i;
+		masks.marked |= rest.marked << i;
+	}
+	return masks;
+}
+
+#endif
+
+#if defined(PACKET_SCAN_NEON)
+
+// Compare 16 candidate offsets at once
+std::size_t findSyncNEON(const unsigned char *data, const std::size_t size) {
+	std::size_t i = 0;
+	if (size > TS_SIZE * 2) {
+		const std::size_t end = size - (TS_SIZE * 2);
+		const uint8x16_t sync = vdupq_n_u8(SYNC);
+		for (; i + 16 <= end; i += 16) {
+			const uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(data + i), sync),
+				vandq_u8(vceqq_u8(vld1q_u8(data + i + TS_SIZE), sync),
+				         vceqq_u8(vld1q_u8(data + i + TS_SIZE * 2), sync)));
+			if (vmaxvq_u8(eq) != 0) {
+				// Narrow each byte to 4 bits to get the first match
+				const std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+					vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+				return i + (__builtin_ctzll(mask) / 4);
+			}
+		}
+	}
+	return i + PacketScan::findSyncScalar(data + i, size - i);
+}
+
+#endif
+
+Implementation selectImplementation() {
+#if defined(PACKET_SCAN_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return {"AVX2", findSyncAVX2, getHeaderMasksAVX2};
+	}
+#endif
+#if defined(PACKET_SCAN_X86) && defined(__SSE2__)
+	return {"SSE2", findSyncSSE2, PacketScan::getHeaderMasksScalar};
+#elif defined(PACKET_SCAN_NEON)
+	return {"NEON", findSyncNEON, PacketScan::getHeaderMasksScalar};
+#else
+	return {"Scalar", PacketScan::findSyncScalar, PacketScan::getHeaderMasksScalar};
+#endif
+}
+
+const Implementation &getImplementation() {
+	static const Implementation implementation = [] {
+		const Implementation selected = selectImplementation();
+		SI_LOG_INFO("TS packet scan using @#1", selected.name);
+		return selected;
+	}();
+	return implementation;
+}
+
+}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+std::size_t PacketScan::findSync(const unsigned char *data, const std::size_t size) {
+	return getImplementation().findSync(data, size);
+}
+
+PacketScan::HeaderMasks PacketScan::getHeaderMasks(
+		const unsigned char *data, const std::size_t packets) {
+	return getImplementation().getHeaderMasks(data, packets);
+}
+
+const char *PacketScan::getImplementationName() {
+	return getImplementation().name;
+}
+
+std::size_t PacketScan::findSyncScalar(const unsigned char *data, const std::size_t size) {
+	for (std::size_t i = 0; i + (TS_SIZE * 2) < size; ++i) {
+		if (data[i] == SYNC &&
+			data[i + TS_SIZE * 1] == SYNC &&
+			data[i + TS_SIZE * 2] == SYNC) {
+			return i;
+		}
+	}
+	return size;
+}
+
+PacketScan::HeaderMasks PacketScan::getHeaderMasksScalar(
+		const unsigned char *data, const std::size_t packets) {
+	HeaderMasks masks{0, 0};
+	for (std::size_t i = 0; i < packets; ++i) {
+		const unsigned char *ts = data + (i * TS_SIZE);
+		masks.scrambled |= static_cast<std::uint64_t>(ts[3] >> 7) << i;
+		masks.marked |= static_cast<std::uint64_t>(ts[1] == 0xFF) << i;
+	}
+	return masks;
+}
+
+}
@@ -0,0 +1,67 @@
+/* PacketScan.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_PACKET_SCAN_H_INCLUDE
+#define MPEGTS_PACKET_SCAN_H_INCLUDE MPEGTS_PACKET_SCAN_H_INCLUDE
+
+#include <cstdint>
+#include <cstddef>
+
+namespace mpegts {
+
+/// The class @c PacketScan has the scans that run over the TS packets of
+/// every buffer. The SSE2/AVX2/NEON versions are selected at runtime for
+/// this CPU, the scalar versions are the reference for them.
+class PacketScan {
+		// =====================================================================
+		//  -- Static member functions -----------------------------------------
+		// =====================================================================
+	public:
+
+		/// Header flags of (max 64) TS packets, bit n is for packet n
+		struct HeaderMasks {
+			std::uint64_t scrambled; /// 'transport scrambling control' odd/even key set
+			std::uint64_t marked;    /// marked for purging (0xFF after the sync byte)
+		};
+
+		/// Find the first offset where three TS sync bytes are TS_PACKET_SIZE apart
+		/// @param data specifies the data to search
+		/// @param size specifies the size of data
+		/// @return the offset of the first sync byte or size when not found
+		static std::size_t findSync(const unsigned char *data, std::size_t size);
+
+		/// Get the scrambled and marked flags of all TS packets in one pass
+		/// @param data specifies the first TS packet
+		/// @param packets specifies the amount of TS packets (max 64)
+		static HeaderMasks getHeaderMasks(const unsigned char *data, std::size_t packets);
+
+		/// Get the name of the implementation selected for this CPU
+		static const char *getImplementationName();
+
+		/// Scalar reference of @see findSync
+		static std::size_t findSyncScalar(const unsigned char *data, std::size_t size);
+
+		/// Scalar reference of @see getHeaderMasks
+		static HeaderMasks getHeaderMasksScalar(const unsigned char *data, std::size_t packets);
+
+};
+
+}
+
+#endif // MPEGTS_PACKET_SCAN_H_INCLUDE
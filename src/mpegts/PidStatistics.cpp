@@ -0,0 +1,160 @@
+/* PidStatistics.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/PidStatistics.h>
+
+#include <StringConverter.h>
+#include <base/JSONSerializer.h>
+#include <mpegts/PacketBuffer.h>
+
+#include <algorithm>
+
+namespace mpegts {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+PidStatistics::PidStatistics() {
+	clear();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void PidStatistics::clear() {
+	base::MutexLock lock(_mutex);
+	_nextSample = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+	_head = 0;
+	_samples = 0;
+	_slot.fill(NO_SLOT);
+	for (Track &track : _track) {
+		track.pid = -1;
+	}
+}
+
+void PidStatistics::update(const PidTable &pidTable) {
+	const auto now = std::chrono::steady_clock::now();
+	if (now < _nextSample) {
+		return;
+	}
+	base::MutexLock lock(_mutex);
+	_nextSample += std::chrono::seconds(1);
+	// Missed some seconds (no data), so start again from now
+	if (_nextSample <= now) {
+		_nextSample = now + std::chrono::seconds(1);
+	}
+	sample_L(pidTable);
+}
+
+void PidStatistics::sample_L(const PidTable &pidTable) {
+	_head = (_head + 1) % MAX_SECONDS;
+	_samples = std::min(_samples + 1, MAX_SECONDS);
+
+	// Start tracking the PIDs that became active
+	std::size_t freeSlot = 0;
+	for (int pid = 0; pid < PidTable::ALL_PIDS; ++pid) {
+		if (_slot[pid] != NO_SLOT || !pidTable.isPIDOpened(pid) ||
+				pidTable.getPacketCounter(pid) == 0) {
+			continue;
+		}
+		while (freeSlot < MAX_TRACKED_PIDS && _track[freeSlot].pid != -1) {
+			++freeSlot;
+		}
+		if (freeSlot == MAX_TRACKED_PIDS) {
+			break;
+		}
+		Track &track = _track[freeSlot];
+		track.pid = pid;
+		track.lastPackets = pidTable.getPacketCounter(pid);
+		track.lastCCErrors = pidTable.getCCErrors(pid);
+		std::fill(std::begin(track.packets), std::end(track.packets), 0);
+		std::fill(std::begin(track.ccErrors), std::end(track.ccErrors), 0);
+		_slot[pid] = freeSlot;
+	}
+
+	// Put the counter deltas in the bucket, the counters restart from zero
+	// when the PID was closed in between
+	for (std::size_t i = 0; i < MAX_TRACKED_PIDS; ++i) {
+		Track &track = _track[i];
+		if (track.pid == -1) {
+			continue;
+		}
+		const uint32_t packets = pidTable.getPacketCounter(track.pid);
+		const uint32_t ccErrors = pidTable.getCCErrors(track.pid);
+		track.packets[_head] = (packets >= track.lastPackets) ? packets - track.lastPackets : packets;
+		track.ccErrors[_head] = (ccErrors >= track.lastCCErrors) ? ccErrors - track.lastCCErrors : ccErrors;
+		track.lastPackets = packets;
+		track.lastCCErrors = ccErrors;
+
+		// Stop tracking PIDs that are silent for the whole window
+		uint64_t sumPackets;
+		uint64_t sumCCErrors;
+		sum_L(i, MAX_SECONDS, sumPackets, sumCCErrors);
+		if (sumPackets == 0 && !pidTable.isPIDOpened(track.pid)) {
+			_slot[track.pid] = NO_SLOT;
+			track.pid = -1;
+		}
+	}
+}
+
+std::size_t PidStatistics::sum_L(const std::size_t slot, const std::size_t seconds,
+		uint64_t &packets, uint64_t &ccErrors) const {
+	const Track &track = _track[slot];
+	const std::size_t n = std::min(seconds, _samples);
+	packets = 0;
+	ccErrors = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		const std::size_t bucket = (_head + MAX_SECONDS - i) % MAX_SECONDS;
+		packets += track.packets[bucket];
+		ccErrors += track.ccErrors[bucket];
+	}
+	return n;
+}
+
+void PidStatistics::addToJSON(base::JSONSerializer &json) const {
+	static constexpr std::size_t WINDOW[] = { 1, 10, 60 };
+	base::MutexLock lock(_mutex);
+	json.startArrayWithName("pids");
+	for (int pid = 0; pid < PidTable::ALL_PIDS; ++pid) {
+		if (_slot[pid] == NO_SLOT) {
+			continue;
+		}
+		json.startObject();
+		json.addValueNumber("pid", StringConverter::stringFormat("@#1", pid));
+		for (const std::size_t window : WINDOW) {
+			uint64_t packets;
+			uint64_t ccErrors;
+			const std::size_t seconds = sum_L(_slot[pid], window, packets, ccErrors);
+			const double div = (seconds == 0) ? 1.0 : seconds;
+			const double bitrate = (packets * PacketBuffer::TS_PACKET_SIZE * 8.0) / div;
+			json.addValueNumber(StringConverter::stringFormat("bitrate@#1s", window),
+				StringConverter::stringFormat("@#1", bitrate));
+			json.addValueNumber(StringConverter::stringFormat("packetRate@#1s", window),
+				StringConverter::stringFormat("@#1", packets / div));
+			json.addValueNumber(StringConverter::stringFormat("ccErrorRate@#1s", window),
+				StringConverter::stringFormat("@#1", ccErrors / div));
+		}
+		json.endObject();
+	}
+	json.endArray();
+}
+
+}
@@ -0,0 +1,102 @@
+/* PidStatistics.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_PIDSTATISTICS_H_INCLUDE
+#define MPEGTS_PIDSTATISTICS_H_INCLUDE MPEGTS_PIDSTATISTICS_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Mutex.h>
+#include <mpegts/PidTable.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+FW_DECL_NS1(base, JSONSerializer);
+
+namespace mpegts {
+
+/// The class @c PidStatistics keeps the rolling 1s/10s/60s bitrate, packet
+/// rate and CC error rate per PID. Once a second it samples the counters of
+/// the @see PidTable into fixed-size rings of one second buckets, so nothing
+/// is done (or allocated) per packet.
+class PidStatistics {
+		// =========================================================================
+		//  -- Constructors and destructor -----------------------------------------
+		// =========================================================================
+	public:
+
+		PidStatistics();
+
+		virtual ~PidStatistics() = default;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Forget all PIDs and samples
+		void clear();
+
+		/// Take the one second sample of the PID table when it is due, this
+		/// should be called for every filtered buffer
+		void update(const PidTable &pidTable);
+
+		/// Add the statistics of all tracked PIDs as 'pids' array
+		void addToJSON(base::JSONSerializer &json) const;
+
+	private:
+
+		/// Take one sample of all PIDs into bucket _head
+		void sample_L(const PidTable &pidTable);
+
+		/// Sum the last seconds buckets of the track
+		/// @return the amount of seconds that are summed
+		std::size_t sum_L(std::size_t slot, std::size_t seconds,
+			uint64_t &packets, uint64_t &ccErrors) const;
+
+		// =========================================================================
+		//  -- Data members --------------------------------------------------------
+		// =========================================================================
+	private:
+
+		static constexpr std::size_t MAX_SECONDS = 60;
+		static constexpr std::size_t MAX_TRACKED_PIDS = 256;
+		static constexpr int16_t NO_SLOT = -1;
+
+		/// The one second buckets of one PID
+		struct Track {
+			int pid;
+			uint32_t lastPackets;  /// PID table counter at the previous sample
+			uint32_t lastCCErrors; /// PID table counter at the previous sample
+			uint32_t packets[MAX_SECONDS];
+			uint32_t ccErrors[MAX_SECONDS];
+		};
+
+		mutable base::Mutex _mutex;
+		std::chrono::steady_clock::time_point _nextSample;
+		std::size_t _head;    /// bucket of the last sample
+		std::size_t _samples; /// amount of valid buckets (max MAX_SECONDS)
+		std::array<int16_t, PidTable::ALL_PIDS> _slot;
+		std::array<Track, MAX_TRACKED_PIDS> _track;
+};
+
+}
+
+#endif // MPEGTS_PIDSTATISTICS_H_INCLUDE
@@ -46,7 +46,7 @@ void PidTable::clear() {
 	for (size_t i = 0; i < MAX_PIDS; ++i) {
 		// Check PID still open.
 		// Then set PID not used, to handle and close them later
-		if (_data[i].state != State::Closed && _data[i].state != State::ShouldOpen) {
+		if (_state[i] != State::Closed && _state[i] != State::ShouldOpen) {
 			setPID(i, false);
 		} else {
 			resetPidData(i);
@@ -55,31 +55,37 @@ void PidTable::clear() {
 }
 
 void PidTable::resetPidData(const int pid) {
-	_data[pid].state    = State::Closed;
-	_data[pid].cc       = 0x80;
-	_data[pid].cc_error = 0;
-	_data[pid].count    = 0;
+	setState(pid, State::Closed);
+	_cc[pid]      = 0x80;
+	_ccError[pid] = 0;
+	_count[pid]   = 0;
+}
+
+void PidTable::setState(const int pid, const State state) {
+	_state[pid] = state;
+	_opened[pid] = (state == State::Opened);
+	_shouldOpen[pid] = (state == State::ShouldOpen);
 }
 
 uint32_t PidTable::getPacketCounter(const int pid) const {
-	return _data[pid].count;
+	return _count[pid];
 }
 
 uint32_t PidTable::getCCErrors(const int pid) const {
-	return _data[pid].cc_error;
+	return _ccError[pid];
 }
 
 void PidTable::resetPIDTableChanged() {
 	_changed = false;
 }
 
-std::string PidTable::getPidCSV() const {
-	if (_data[ALL_PIDS].state == State::Opened) {
+std::string PidTable::getPidCSV(const int hiddenPID) const {
+	if (_opened[ALL_PIDS]) {
 		return "all";
 	}
 	std::string csv;
 	for (size_t i = 0; i < MAX_PIDS; ++i) {
-		if (_data[i].state == State::Opened) {
+		if (_opened[i] && static_cast<int>(i) != hiddenPID) {
 			csv += StringConverter::stringFormat("@#1,", i);
 		}
 	}
@@ -91,45 +97,45 @@ std::string PidTable::getPidCSV() const {
 }
 
 void PidTable::addPIDData(const int pid, const uint8_t cc) {
-	PidData &data = _data[pid];
-	++data.count;
-	if (data.cc == 0x80) {
-		data.cc = cc;
-	} else if (data.cc != cc) {
-		++data.cc;
-		data.cc %= 0x10;
-		if (data.cc != cc) {
+	++_count[pid];
+	uint8_t &pidCC = _cc[pid];
+	if (pidCC == 0x80) {
+		pidCC = cc;
+	} else if (pidCC != cc) {
+		++pidCC;
+		pidCC %= 0x10;
+		if (pidCC != cc) {
 			if (_totalCCErrorsBegin == 0) {
 				_totalCCErrorsBegin = _totalCCErrors;
 			}
-			int diff = cc - data.cc;
+			int diff = cc - pidCC;
 			if (diff < 0) {
 				diff += 0x10;
 			}
-			data.cc = cc;
-			data.cc_error += diff;
+			pidCC = cc;
+			_ccError[pid] += diff;
 			_totalCCErrors += diff;
 		}
 	}
 }
 
 void PidTable::setPID(const int pid, const bool use) {
-	switch (_data[pid].state) {
+	switch (_state[pid]) {
 		case State::Closed:
 			if (use) {
-				_data[pid].state = State::ShouldOpen;
+				setState(pid, State::ShouldOpen);
 				_changed = true;
 			}
 			break;
 		case State::ShouldClose:
 			if (use) {
-				_data[pid].state = State::ShouldCloseReopen;
+				setState(pid, State::ShouldCloseReopen);
 				_changed = true;
 			}
 			break;
 		case State::Opened:
 			if (!use) {
-				_data[pid].state = State::ShouldClose;
+				setState(pid, State::ShouldClose);
 				_changed = true;
 			}
 			break;
@@ -140,35 +146,47 @@ void PidTable::setPID(const int pid, const bool use) {
 }
 
 bool PidTable::shouldPIDClose(const int pid) const {
-	return _data[pid].state == State::ShouldClose ||
-		_data[pid].state == State::ShouldCloseReopen;
+	return _state[pid] == State::ShouldClose ||
+		_state[pid] == State::ShouldCloseReopen;
 }
 
 void PidTable::setPIDClosed(const int pid) {
-	switch (_data[pid].state) {
+	switch (_state[pid]) {
 		case State::ShouldCloseReopen:
-			_data[pid].state = State::ShouldOpen;
+			setState(pid, State::ShouldOpen);
 			_changed = true;
 			break;
 		default:
-			_data[pid].state = State::Closed;
+			setState(pid, State::Closed);
 			break;
 	}
-	_data[pid].cc       = 0x80;
-	_data[pid].cc_error = 0;
-	_data[pid].count    = 0;
+	_cc[pid]      = 0x80;
+	_ccError[pid] = 0;
+	_count[pid]   = 0;
 }
 
 bool PidTable::shouldPIDOpen(const int pid) const {
-	return _data[pid].state == State::ShouldOpen;
+	return _shouldOpen[pid];
 }
 
 void PidTable::setPIDOpened(const int pid) {
-	_data[pid].state = State::Opened;
+	setState(pid, State::Opened);
 }
 
 void PidTable::setAllPID(const bool use) {
 	setPID(ALL_PIDS, use);
 }
 
+void PidTable::reopenPIDs() {
+	for (int pid = 0; pid < MAX_PIDS; ++pid) {
+		if (_opened[pid]) {
+			setState(pid, State::ShouldOpen);
+			_changed = true;
+		} else if (_shouldOpen[pid]) {
+			// Failed to open on the old demux, try again
+			_changed = true;
+		}
+	}
+}
+
 }
@@ -20,6 +20,7 @@
 #ifndef MPEGTS_PIDTABLE_H_INCLUDE
 #define MPEGTS_PIDTABLE_H_INCLUDE MPEGTS_PIDTABLE_H_INCLUDE
 
+#include <bitset>
 #include <cstdint>
 #include <string>
 
@@ -64,7 +65,8 @@ class PidTable {
 		}
 
 		/// Get the CSV of all the requested PID
-		std::string getPidCSV() const;
+		/// @param hiddenPID specifies a PID to leave out, or -1 for none
+		std::string getPidCSV(int hiddenPID = -1) const;
 
 		/// Set the continuity counter for pid
 		void addPIDData(int pid, uint8_t cc);
@@ -74,7 +76,12 @@ class PidTable {
 
 		/// Check if this pid is opened
 		bool isPIDOpened(int pid) const {
-			return _data[pid].state == State::Opened;
+			return _opened[pid];
+		}
+
+		/// Check if this pid is opened or should be opened
+		bool isPIDRequested(int pid) const {
+			return _opened[pid] || _shouldOpen[pid];
 		}
 
 		/// Check if this pid should be closed
@@ -92,9 +99,18 @@ class PidTable {
 		/// Set all PID
 		void setAllPID(bool use);
 
+		/// Let all opened PIDs, and the ones that failed to open, be opened
+		/// again, for instance with a new demux
+		void reopenPIDs();
+
+		/// Get the number of PIDs that are opened or should be opened
+		std::size_t getNumberOfRequestedPIDs() const {
+			return _opened.count() + _shouldOpen.count();
+		}
+
 		/// Check if all PIDs (full Transport Stream) is on
 		bool isAllPID() const {
-			return _data[ALL_PIDS].state == State::Opened;
+			return _opened[ALL_PIDS];
 		}
 
 	protected:
@@ -102,6 +118,19 @@ class PidTable {
 		/// Reset the pid data like counters etc.
 		void resetPidData(int pid);
 
+	private:
+
+		enum class State : uint8_t {
+			ShouldOpen,
+			Opened,
+			ShouldClose,
+			ShouldCloseReopen,
+			Closed
+		};
+
+		/// Set the state of pid and keep the state bitsets up to date
+		void setState(int pid, State state);
+
 		// =========================================================================
 		//  -- Data members --------------------------------------------------------
 		// =========================================================================
@@ -114,25 +143,17 @@ class PidTable {
 
 	private:
 
-		enum class State {
-			ShouldOpen,
-			Opened,
-			ShouldClose,
-			ShouldCloseReopen,
-			Closed
-		};
-
-		// PID State
-		struct PidData {
-			State state;
-			uint8_t cc;        /// continuity counter (0 - 15) of this PID
-			uint32_t cc_error; /// cc error count
-			uint32_t count;    /// the number of times this pid occurred
-		};
+		// The hot state (opened and should open) is kept in dense bitsets that
+		// stay in cache, the state machine and the counters in separate arrays
+		std::bitset<MAX_PIDS> _opened;
+		std::bitset<MAX_PIDS> _shouldOpen;
+		State _state[MAX_PIDS];
+		uint8_t _cc[MAX_PIDS];        /// continuity counter (0 - 15) of this PID
+		uint32_t _ccError[MAX_PIDS];  /// cc error count
+		uint32_t _count[MAX_PIDS];    /// the number of times this pid occurred
 		uint32_t _totalCCErrors;
 		uint32_t _totalCCErrorsBegin;
 		bool _changed;
-		PidData _data[MAX_PIDS];
 };
 
 }
@@ -60,11 +60,11 @@ void SDT::parse(const FeID id) {
 	for (std::size_t secNr = 0; secNr < _numberOfSections; ++secNr) {
 		TableData::Data tableData;
 		if (getDataForSectionNumber(secNr, tableData)) {
-			const unsigned char *data = tableData.data.c_str();
+			const unsigned char *data = tableData.data;
 			_transportStreamID = (data[ 8u] << 8u) | data[ 9u];
 			_networkID         = (data[13u] << 8u) | data[14u];
 
-//				SI_LOG_BIN_DEBUG(data, tableData.data.size(), "Frontend: @#1, SDT data", id);
+//				SI_LOG_BIN_DEBUG(data, tableData.size, "Frontend: @#1, SDT data", id);
 
 			SI_LOG_INFO("Frontend: @#1, SDT - Section Length: @#2  Transport Stream ID: @#3  Version: @#4  secNr: @#5  lastSecNr: @#6  NetworkID: @#7  CRC: @#8",
 				id, DIGIT(tableData.sectionLength, 4), _transportStreamID, tableData.version, tableData.secNr, tableData.lastSecNr, DIGIT(_networkID, 4), HEX(tableData.crc, 4));
@@ -109,22 +109,6 @@ void SDT::parse(const FeID id) {
 	}
 }
 
-// UTF-8 U+0080 U+07FF      yyxx xxxx    yyyyy xxxxxx    110yyyyy 10xxxxxx => UTF-8
-// Ext ASCII - E2       =>  1110 0010 => 00011 100010 => 11000011 10100010 => C3 A2
-void SDT::copyToUTF8(std::string &str, const unsigned char *ptr, const std::size_t len) {
-	const std::size_t offset = (ptr[0] < 0x20) ? ((ptr[0] == 0x10) ? 2 : 1) : 0;
-	for (std::size_t i = offset; i < len; ++i) {
-		if ((ptr[i] & 0x80) == 0x80) {
-			const unsigned char b = 0x80 |  (ptr[i] & 0x3F);
-			const unsigned char c = 0xC0 | ((ptr[i] & 0xC0) >> 6);
-			str.append(1, c);
-			str.append(1, b);
-		} else {
-			str.append(1, ptr[i]);
-		}
-	}
-}
-
 SDT::Data SDT::getSDTDataFor(const int progID) const {
 	SDT::Data data;
 	auto s = _sdtTable.find(progID);
@@ -85,10 +85,6 @@ class SDT :
 
 		SDT::Data getSDTDataFor(int progID) const;
 
-	protected:
-
-		void copyToUTF8(std::string &str, const unsigned char *ptr, std::size_t len);
-
 		// =========================================================================
 		//  -- Data members --------------------------------------------------------
 		// =========================================================================
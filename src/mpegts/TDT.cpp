@@ -0,0 +1,152 @@
+/* TDT.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/TDT.h>
+
+#include <StringConverter.h>
+#include <mpegts/TableData.h>
+
+namespace mpegts {
+
+static constexpr int LOCAL_TIME_OFFSET_DESCRIPTOR = 0x58;
+
+/// Get the BCD coded HHMM offset in minutes
+static int getOffset(const unsigned char *ptr) {
+	return (TableData::fromBCD(ptr[0]) * 60) + TableData::fromBCD(ptr[1]);
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void TDT::collectData(const unsigned char *data) {
+	// The TDT and TOT always start in the packet and fit in it
+	if ((data[1] & 0x40) == 0 || (data[3] & 0x10) == 0) {
+		return;
+	}
+	std::size_t offset = 4;
+	if ((data[3] & 0x20) == 0x20) {
+		offset += 1 + data[4];
+	}
+	offset += 1;
+	if (offset >= 188) {
+		return;
+	}
+	offset += data[offset - 1];
+	if (offset + 8 > 188) {
+		return;
+	}
+	const unsigned char *ptr = data + offset;
+	const int tableID = ptr[0];
+	if (tableID != TableData::TDT_ID && tableID != TableData::TOT_ID) {
+		return;
+	}
+	const int64_t now = getMonotonicMS();
+	int64_t &lastParse = (tableID == TableData::TDT_ID) ? _lastTDTParse : _lastTOTParse;
+	if (lastParse != 0 && now - lastParse < PARSE_INTERVAL_MS) {
+		return;
+	}
+	lastParse = now;
+
+	const std::size_t sectionLength = (((ptr[1] & 0x0F) << 8) | ptr[2]) + 3;
+	if (offset + sectionLength > 188) {
+		return;
+	}
+	if (tableID == TableData::TOT_ID) {
+		if (sectionLength < 14 || TableData::calculateCRC32(ptr, sectionLength) != 0) {
+			return;
+		}
+		const std::size_t descLength = ((ptr[8] & 0x0F) << 8) | ptr[9];
+		if (10 + descLength + 4 <= sectionLength) {
+			parseLocalTimeOffsets(&ptr[10], descLength);
+		}
+	}
+	setUTCTime(TableData::getUTCTime(&ptr[3]), now);
+}
+
+void TDT::setUTCTime(const std::time_t utc, const int64_t monotonicMS) {
+	const int64_t systemMS = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	const int64_t utcMS = static_cast<int64_t>(utc) * 1000;
+	_offsetMS = utcMS - monotonicMS;
+	_driftMS = utcMS - systemMS;
+	_valid = true;
+	base::MutexLock lock(_mutex);
+	_lastUpdate = monotonicMS;
+}
+
+void TDT::parseLocalTimeOffsets(const unsigned char *ptr, const std::size_t len) {
+	std::vector<LocalTimeOffset> localTimeOffsets;
+	for (std::size_t i = 0; i + 2 <= len; ) {
+		const int tag = ptr[i];
+		const std::size_t descLength = ptr[i + 1];
+		const unsigned char *desc = &ptr[i + 2];
+		i += 2 + descLength;
+		if (i > len) {
+			break;
+		}
+		if (tag != LOCAL_TIME_OFFSET_DESCRIPTOR) {
+			continue;
+		}
+		for (std::size_t j = 0; j + 13 <= descLength; j += 13) {
+			const unsigned char *entry = &desc[j];
+			const int sign = ((entry[3] & 0x01) == 0x01) ? -1 : 1;
+			LocalTimeOffset localTimeOffset;
+			localTimeOffset.country.assign(reinterpret_cast<const char *>(entry), 3);
+			localTimeOffset.region = entry[3] >> 2;
+			localTimeOffset.offset = sign * getOffset(&entry[4]);
+			localTimeOffset.timeOfChange = TableData::getUTCTime(&entry[6]);
+			localTimeOffset.nextOffset = sign * getOffset(&entry[11]);
+			localTimeOffsets.push_back(localTimeOffset);
+		}
+	}
+	base::MutexLock lock(_mutex);
+	_localTimeOffsets.swap(localTimeOffsets);
+}
+
+std::time_t TDT::getUTCTime() const {
+	if (!_valid) {
+		return std::time(nullptr);
+	}
+	return (getMonotonicMS() + _offsetMS) / 1000;
+}
+
+void TDT::addToJSON(base::JSONSerializer &json) const {
+	base::MutexLock lock(_mutex);
+	json.startObjectWithName("clock");
+	json.addValueNumber("valid", _valid ? "1" : "0");
+	json.addValueNumber("utc", StringConverter::stringFormat("@#1", getUTCTime()));
+	json.addValueNumber("driftMS", StringConverter::stringFormat("@#1", getDriftMS()));
+	json.addValueNumber("lastUpdateAgeMS", StringConverter::stringFormat("@#1",
+		_valid ? getMonotonicMS() - _lastUpdate : -1));
+	json.startArrayWithName("localTimeOffsets");
+	for (const LocalTimeOffset &localTimeOffset : _localTimeOffsets) {
+		json.startObject();
+		json.addValueString("country", localTimeOffset.country);
+		json.addValueNumber("region", StringConverter::stringFormat("@#1", localTimeOffset.region));
+		json.addValueNumber("offset", StringConverter::stringFormat("@#1", localTimeOffset.offset));
+		json.addValueNumber("timeOfChange", StringConverter::stringFormat("@#1", localTimeOffset.timeOfChange));
+		json.addValueNumber("nextOffset", StringConverter::stringFormat("@#1", localTimeOffset.nextOffset));
+		json.endObject();
+	}
+	json.endArray();
+	json.endObject();
+}
+
+}
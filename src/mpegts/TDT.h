@@ -0,0 +1,120 @@
+/* TDT.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_TDT_H_INCLUDE
+#define MPEGTS_TDT_H_INCLUDE MPEGTS_TDT_H_INCLUDE
+
+#include <base/JSONSerializer.h>
+#include <base/Mutex.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace mpegts {
+
+/// The class @c TDT keeps the broadcast UTC clock of a frontend from the
+/// TDT and TOT of PID 20, as offset from the local monotonic clock. The TOT
+/// also gives the local time offsets of the countries/regions.
+/// Each table is parsed at most once per second.
+class TDT {
+		// =========================================================================
+		//  -- Constructors and destructor -----------------------------------------
+		// =========================================================================
+	public:
+
+		TDT() = default;
+
+		virtual ~TDT() = default;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Collect the TDT or TOT of this TS packet of PID 20
+		/// @param data specifies the TS packet
+		void collectData(const unsigned char *data);
+
+		/// Check if the broadcast clock is received
+		bool isValid() const {
+			return _valid;
+		}
+
+		/// Get the broadcast UTC time, or the system time when there is no
+		/// broadcast clock (yet)
+		std::time_t getUTCTime() const;
+
+		/// Get the difference between the broadcast and system clock in ms,
+		/// measured when the last TDT or TOT was received
+		int64_t getDriftMS() const {
+			return _driftMS;
+		}
+
+		/// Add the broadcast clock as 'clock' object
+		void addToJSON(base::JSONSerializer &json) const;
+
+	private:
+
+		/// Get the monotonic clock in ms
+		static int64_t getMonotonicMS() {
+			return std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		/// Set the broadcast clock to the received UTC time
+		void setUTCTime(std::time_t utc, int64_t monotonicMS);
+
+		/// Parse the local time offset descriptors of the TOT
+		void parseLocalTimeOffsets(const unsigned char *ptr, std::size_t len);
+
+		// =========================================================================
+		//  -- Data members --------------------------------------------------------
+		// =========================================================================
+	private:
+
+		static constexpr int64_t PARSE_INTERVAL_MS = 1000;
+
+		struct LocalTimeOffset {
+			std::string country;
+			int region;
+			/// Offset to UTC in minutes
+			int offset;
+			std::time_t timeOfChange;
+			/// Offset to UTC in minutes after the time of change
+			int nextOffset;
+		};
+
+		mutable base::Mutex _mutex;
+		std::atomic_bool _valid{false};
+		/// Broadcast UTC in ms minus the monotonic clock in ms
+		std::atomic<int64_t> _offsetMS{0};
+		std::atomic<int64_t> _driftMS{0};
+		int64_t _lastTDTParse = 0;
+		int64_t _lastTOTParse = 0;
+		int64_t _lastUpdate = 0;
+		std::vector<LocalTimeOffset> _localTimeOffsets;
+};
+
+}
+
+#endif // MPEGTS_TDT_H_INCLUDE
@@ -0,0 +1,356 @@
+/* TR101290.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/TR101290.h>
+
+#include <StringConverter.h>
+#include <base/JSONSerializer.h>
+#include <mpegts/PacketBuffer.h>
+#include <mpegts/PCR.h>
+#include <mpegts/TableData.h>
+
+#include <cmath>
+
+namespace mpegts {
+
+/// Names of the indicators, in the order of @see Indicator
+static constexpr const char *INDICATOR_NAME[] = {
+	"TS_sync_loss",
+	"Sync_byte_error",
+	"PAT_error",
+	"Continuity_count_error",
+	"PMT_error",
+	"Transport_error",
+	"CRC_error",
+	"PCR_repetition_error",
+	"PCR_discontinuity_indicator_error",
+	"PCR_accuracy_error"
+};
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+TR101290::TR101290() {
+	clear();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void TR101290::clear() {
+	base::MutexLock lock(_mutex);
+	_since = std::time(nullptr);
+	_lastCheck = Clock::now();
+	_error.fill(Error{0, 0});
+	_badSync = 0;
+	_goodSync = 0;
+	_syncLost = false;
+	_pat = false;
+	_patSeen = _lastCheck;
+	_packets = 0;
+	_fullTSBegin = 0;
+	_cc.fill(NO_CC);
+	_slot.fill(NO_SLOT);
+	_tracks = 0;
+}
+
+void TR101290::setReferencedPIDs(const bool pat, const std::vector<int> &pmtPIDs,
+		const std::vector<int> &pcrPIDs) {
+	base::MutexLock lock(_mutex);
+	const Clock::time_point now = Clock::now();
+	if (pat && !_pat) {
+		_patSeen = now;
+	}
+	_pat = pat;
+
+	// Build the new tracks, keep the state of the PIDs that stay
+	std::array<Track, MAX_TRACKS> track;
+	std::size_t tracks = 0;
+	const auto add = [&](const int pid, const bool pmt) {
+		if (pid < 0 || pid >= PidTable::ALL_PIDS) {
+			return;
+		}
+		std::size_t i = 0;
+		while (i < tracks && track[i].pid != pid) {
+			++i;
+		}
+		if (i == tracks) {
+			if (tracks == MAX_TRACKS) {
+				return;
+			}
+			++tracks;
+			if (_slot[pid] != NO_SLOT) {
+				track[i] = _track[_slot[pid]];
+			} else {
+				track[i] = Track{pid, false, false, now, false, 0, 0, 0.0};
+			}
+			track[i].pmt = false;
+			track[i].pcr = false;
+		}
+		if (pmt) {
+			const bool wasPMT = _slot[pid] != NO_SLOT && _track[_slot[pid]].pmt;
+			if (!wasPMT && !track[i].pmt) {
+				track[i].pmtSeen = now;
+			}
+			track[i].pmt = true;
+		} else {
+			track[i].pcr = true;
+		}
+	};
+	for (const int pid : pmtPIDs) {
+		add(pid, true);
+	}
+	for (const int pid : pcrPIDs) {
+		add(pid, false);
+	}
+	for (std::size_t i = 0; i < _tracks; ++i) {
+		_slot[_track[i].pid] = NO_SLOT;
+	}
+	for (std::size_t i = 0; i < tracks; ++i) {
+		_track[i] = track[i];
+		_slot[track[i].pid] = i;
+	}
+	_tracks = tracks;
+}
+
+void TR101290::checkPackets(const PacketBuffer &buffer, const std::size_t begin,
+		const std::size_t end, const bool fullTS) {
+	base::MutexLock lock(_mutex);
+	const Clock::time_point now = Clock::now();
+	if (now - _lastCheck > RESUME_INTERVAL) {
+		_patSeen = now;
+		for (std::size_t i = 0; i < _tracks; ++i) {
+			_track[i].pmtSeen = now;
+		}
+	}
+	_lastCheck = now;
+	if (!fullTS) {
+		_fullTSBegin = _packets + (end - begin);
+	}
+	for (std::size_t i = begin; i < end; ++i, ++_packets) {
+		const unsigned char *ptr = buffer.getTSPacketPtr(i);
+		// 1.1 and 1.2, lost with 2 bad sync bytes in a row, found again with 5 good ones
+		if (ptr[0] != 0x47) {
+			setError_L(SyncByte);
+			_goodSync = 0;
+			if (++_badSync >= 2 && !_syncLost) {
+				_syncLost = true;
+				setError_L(SyncLoss);
+			}
+			continue;
+		}
+		_badSync = 0;
+		if (_syncLost && ++_goodSync >= 5) {
+			_syncLost = false;
+		}
+		// 2.1
+		if ((ptr[1] & 0x80) == 0x80) {
+			setError_L(Transport);
+			continue;
+		}
+		const int pid = ((ptr[1] & 0x1f) << 8) | ptr[2];
+		if (pid == 0x1FFF) {
+			continue;
+		}
+		// 1.4
+		checkCC_L(ptr, pid);
+
+		const bool scrambled = (ptr[3] & 0xC0) != 0;
+		const uint8_t slot = _slot[pid];
+		switch (pid) {
+			case 0:
+				// 1.3 and 2.2
+				if (scrambled) {
+					setError_L(PAT);
+				} else if (const int tableID = checkSection_L(ptr, true); tableID == TableData::PAT_ID) {
+					_patSeen = now;
+				} else if (tableID != -1) {
+					setError_L(PAT);
+				}
+				break;
+			case 1:
+			case 16:
+			case 17:
+			case 18:
+			case 20:
+				// 2.2
+				checkSection_L(ptr, !scrambled);
+				break;
+			default:
+				if (slot != NO_SLOT && _track[slot].pmt) {
+					// 1.5 and 2.2
+					if (scrambled) {
+						setError_L(PMT);
+					} else if (checkSection_L(ptr, true) == TableData::PMT_ID) {
+						_track[slot].pmtSeen = now;
+					}
+				}
+				break;
+		}
+		// 2.3, 2.4 and 2.5
+		if (slot != NO_SLOT && _track[slot].pcr && PCR::isPCRTableData(ptr) && ptr[4] >= 7) {
+			checkPCR_L(ptr, slot, fullTS);
+		}
+	}
+	// 1.3 and 1.5, count one error for each interval that is missed
+	if (_pat && now - _patSeen > SECTION_INTERVAL) {
+		setError_L(PAT);
+		_patSeen = now;
+	}
+	for (std::size_t i = 0; i < _tracks; ++i) {
+		Track &track = _track[i];
+		if (track.pmt && now - track.pmtSeen > SECTION_INTERVAL) {
+			setError_L(PMT);
+			track.pmtSeen = now;
+		}
+	}
+}
+
+void TR101290::setError_L(const Indicator indicator) {
+	Error &error = _error[indicator];
+	++error.count;
+	error.lastError = std::time(nullptr);
+}
+
+void TR101290::checkCC_L(const unsigned char *data, const int pid) {
+	const uint8_t cc = data[3] & 0x0F;
+	const bool payload = (data[3] & 0x10) == 0x10;
+	uint8_t &last = _cc[pid];
+	if (last == NO_CC || PCR::isDiscontinuity(data)) {
+		last = cc;
+		return;
+	}
+	const uint8_t lastCC = last & 0x0F;
+	if (!payload) {
+		// Without payload the CC does not increment
+		if (cc != lastCC) {
+			setError_L(CC);
+		}
+		last = cc;
+	} else if (cc == lastCC) {
+		// One duplicate packet is allowed
+		if ((last & DUPLICATE_CC) == DUPLICATE_CC) {
+			setError_L(CC);
+		}
+		last = cc | DUPLICATE_CC;
+	} else {
+		if (cc != ((lastCC + 1) & 0x0F)) {
+			setError_L(CC);
+		}
+		last = cc;
+	}
+}
+
+int TR101290::checkSection_L(const unsigned char *data, const bool checkCRC) {
+	if ((data[1] & 0x40) == 0 || (data[3] & 0x10) == 0) {
+		return -1;
+	}
+	std::size_t offset = 4;
+	if ((data[3] & 0x20) == 0x20) {
+		offset += 1 + data[4];
+	}
+	if (offset >= PacketBuffer::TS_PACKET_SIZE) {
+		return -1;
+	}
+	offset += 1 + data[offset];
+	if (offset + 3 > PacketBuffer::TS_PACKET_SIZE) {
+		return -1;
+	}
+	const unsigned char *ptr = data + offset;
+	const int tableID = ptr[0];
+	if (tableID == 0xFF) {
+		return -1;
+	}
+	// Only the sections with a CRC that fit in this packet are checked
+	const std::size_t sectionLength = (((ptr[1] & 0x0F) << 8) | ptr[2]) + 3;
+	const bool hasCRC = (ptr[1] & 0x80) == 0x80 || tableID == TableData::TOT_ID;
+	if (checkCRC && hasCRC && tableID != TableData::TDT_ID &&
+			offset + sectionLength <= PacketBuffer::TS_PACKET_SIZE &&
+			TableData::calculateCRC32(ptr, sectionLength) != 0) {
+		setError_L(CRC);
+	}
+	return tableID;
+}
+
+void TR101290::checkPCR_L(const unsigned char *data, const std::size_t slot, const bool fullTS) {
+	Track &track = _track[slot];
+	const uint64_t pcr = PCR::getPCRValue(data);
+	if (track.pcrValid && !PCR::isDiscontinuity(data)) {
+		// A PCR going back wraps to a big difference
+		const uint64_t delta = (pcr + PCR::WRAP_AROUND - track.pcrValue) % PCR::WRAP_AROUND;
+		if (delta > PCR_DISCONTINUITY) {
+			setError_L(PCRDiscontinuity);
+		} else {
+			if (delta > PCR_REPETITION) {
+				setError_L(PCRRepetition);
+			} else if (fullTS && track.pcrPacket >= _fullTSBegin && _packets > track.pcrPacket) {
+				// Compare the PCR with the one expected from the packets in between,
+				// at the average rate of the previous PCRs
+				const double packets = static_cast<double>(_packets - track.pcrPacket);
+				if (track.ticksPerPacket > 0.0 &&
+						std::fabs(delta - (packets * track.ticksPerPacket)) > PCR_ACCURACY) {
+					setError_L(PCRAccuracy);
+				}
+				const double ticksPerPacket = delta / packets;
+				track.ticksPerPacket = (track.ticksPerPacket == 0.0) ? ticksPerPacket :
+					track.ticksPerPacket + ((ticksPerPacket - track.ticksPerPacket) / 16.0);
+			}
+		}
+	}
+	track.pcrValid = true;
+	track.pcrValue = pcr;
+	track.pcrPacket = _packets;
+}
+
+uint64_t TR101290::getErrors(const int priority) const {
+	base::MutexLock lock(_mutex);
+	const std::size_t begin = (priority == 1) ? SyncLoss : Transport;
+	const std::size_t end = (priority == 1) ? Transport : NumberOfIndicators;
+	uint64_t errors = 0;
+	for (std::size_t i = begin; i < end; ++i) {
+		errors += _error[i].count;
+	}
+	return errors;
+}
+
+void TR101290::addToJSON(base::JSONSerializer &json) const {
+	const uint64_t priority1 = getErrors(1);
+	const uint64_t priority2 = getErrors(2);
+	base::MutexLock lock(_mutex);
+	json.startObjectWithName("tr101290");
+	json.addValueNumber("since", StringConverter::stringFormat("@#1", _since));
+	json.addValueNumber("syncLost", _syncLost ? "1" : "0");
+	json.addValueNumber("priority1Errors", StringConverter::stringFormat("@#1", priority1));
+	json.addValueNumber("priority2Errors", StringConverter::stringFormat("@#1", priority2));
+	json.startArrayWithName("indicators");
+	for (std::size_t i = 0; i < NumberOfIndicators; ++i) {
+		json.startObject();
+		json.addValueString("name", INDICATOR_NAME[i]);
+		json.addValueNumber("priority", (i < Transport) ? "1" : "2");
+		json.addValueNumber("count", StringConverter::stringFormat("@#1", _error[i].count));
+		json.addValueNumber("lastError", StringConverter::stringFormat("@#1", _error[i].lastError));
+		json.endObject();
+	}
+	json.endArray();
+	json.endObject();
+}
+
+}
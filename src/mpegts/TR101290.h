@@ -0,0 +1,174 @@
+/* TR101290.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_TR101290_H_INCLUDE
+#define MPEGTS_TR101290_H_INCLUDE MPEGTS_TR101290_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Mutex.h>
+#include <mpegts/PidTable.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+FW_DECL_NS1(base, JSONSerializer);
+FW_DECL_NS1(mpegts, PacketBuffer);
+
+namespace mpegts {
+
+/// The class @c TR101290 monitors the TS packets of a frontend on the ETSI
+/// TR 101 290 priority 1 and 2 indicators. It keeps a count and the time of
+/// the last error of each indicator. The state is fixed, the CC of each PID
+/// and a few tracks for the PMT and PCR PIDs, so it can always be on.
+class TR101290 {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// =========================================================================
+		//  -- Constructors and destructor -----------------------------------------
+		// =========================================================================
+	public:
+
+		TR101290();
+
+		virtual ~TR101290() = default;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Forget all errors and the state of the PIDs
+		void clear();
+
+		/// Set the PIDs that should repeat on time
+		/// @param pat specifies if the PAT is in the stream
+		/// @param pmtPIDs specifies the PMT PIDs in the stream
+		/// @param pcrPIDs specifies the PCR PIDs of these PMTs in the stream
+		void setReferencedPIDs(bool pat, const std::vector<int> &pmtPIDs,
+			const std::vector<int> &pcrPIDs);
+
+		/// Check the new TS packets of this buffer, this should be done before
+		/// they are changed or purged
+		/// @param buffer specifies the buffer to check
+		/// @param begin specifies the first packet to check
+		/// @param end specifies the packet after the last one to check
+		/// @param fullTS specifies if the buffer has all packets of the transponder,
+		/// only then the PCR accuracy can be checked
+		void checkPackets(const PacketBuffer &buffer, std::size_t begin,
+			std::size_t end, bool fullTS);
+
+		/// Get the total amount of errors of the priority 1 or 2 indicators
+		uint64_t getErrors(int priority) const;
+
+		/// Add the indicators as 'tr101290' object
+		void addToJSON(base::JSONSerializer &json) const;
+
+	private:
+
+		enum Indicator : std::size_t {
+			SyncLoss,
+			SyncByte,
+			PAT,
+			CC,
+			PMT,
+			Transport,
+			CRC,
+			PCRRepetition,
+			PCRDiscontinuity,
+			PCRAccuracy,
+			NumberOfIndicators
+		};
+
+		/// Count an error of the indicator
+		void setError_L(Indicator indicator);
+
+		/// Check the continuity counter of this TS packet
+		void checkCC_L(const unsigned char *data, int pid);
+
+		/// Check the table ID and the CRC of the section starting in this TS
+		/// packet, when it fits in it
+		/// @return the table ID of the section or -1 if there is none
+		int checkSection_L(const unsigned char *data, bool checkCRC);
+
+		/// Check the PCR of this TS packet with the previous one of its PID
+		void checkPCR_L(const unsigned char *data, std::size_t slot, bool fullTS);
+
+		// =========================================================================
+		//  -- Data members --------------------------------------------------------
+		// =========================================================================
+	private:
+
+		static constexpr std::size_t MAX_TRACKS = 64;
+		static constexpr uint8_t NO_SLOT = 0xFF;
+		static constexpr uint8_t NO_CC = 0x80;
+		static constexpr uint8_t DUPLICATE_CC = 0x40;
+		/// The PAT and PMTs should repeat within this time
+		static constexpr Clock::duration SECTION_INTERVAL = std::chrono::milliseconds(500);
+		/// No data for this time (not streaming), so start the intervals again
+		static constexpr Clock::duration RESUME_INTERVAL = std::chrono::seconds(1);
+		/// PCR intervals in 27MHz ticks, repeated within 40ms and 100ms at most
+		static constexpr uint64_t PCR_REPETITION = 27000 * 40;
+		static constexpr uint64_t PCR_DISCONTINUITY = 27000 * 100;
+		/// PCR accuracy of 500ns in 27MHz ticks
+		static constexpr double PCR_ACCURACY = 13.5;
+
+		/// The state of a PMT and/or PCR PID
+		struct Track {
+			int pid;
+			bool pmt;
+			bool pcr;
+			Clock::time_point pmtSeen;
+			bool pcrValid;
+			uint64_t pcrValue;
+			uint64_t pcrPacket;    /// packet number of the last PCR
+			double ticksPerPacket; /// average 27MHz ticks between the packets
+		};
+
+		struct Error {
+			uint64_t count;
+			std::time_t lastError;
+		};
+
+		mutable base::Mutex _mutex;
+		std::time_t _since;
+		Clock::time_point _lastCheck;
+		std::array<Error, NumberOfIndicators> _error;
+		/// Sync byte state for the sync loss
+		unsigned int _badSync;
+		unsigned int _goodSync;
+		bool _syncLost;
+		bool _pat;
+		Clock::time_point _patSeen;
+		/// Packet number of all checked packets and of the first one of the
+		/// full TS buffers in a row
+		uint64_t _packets;
+		uint64_t _fullTSBegin;
+		std::array<uint8_t, PidTable::ALL_PIDS> _cc;
+		std::array<uint8_t, PidTable::ALL_PIDS> _slot;
+		std::array<Track, MAX_TRACKS> _track;
+		std::size_t _tracks;
+};
+
+}
+
+#endif // MPEGTS_TR101290_H_INCLUDE
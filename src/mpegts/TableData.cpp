@@ -20,6 +20,7 @@
 #include <mpegts/TableData.h>
 
 #include <Log.h>
+#include <mpegts/CRC32.h>
 
 #include <assert.h>
 
@@ -97,6 +98,10 @@ static uint32_t crc32Table[] = {
 // =============================================================================
 
 uint32_t TableData::calculateCRC32(const unsigned char *data, const std::size_t len) {
+	return CRC32::calculate(data, len);
+}
+
+uint32_t TableData::calculateCRC32Reference(const unsigned char *data, const std::size_t len) {
 	uint32_t crc = 0xffffffff;
 	for(size_t i = 0; i < len; ++i) {
 		crc = (crc << 8) ^ crc32Table[((crc >> 24) ^ (data[i] & 0xff)) & 0xff];
@@ -104,6 +109,33 @@ uint32_t TableData::calculateCRC32(const unsigned char *data, const std::size_t
 	return crc;
 }
 
+// UTF-8 U+0080 U+07FF      yyxx xxxx    yyyyy xxxxxx    110yyyyy 10xxxxxx => UTF-8
+// Ext ASCII - E2       =>  1110 0010 => 00011 100010 => 11000011 10100010 => C3 A2
+void TableData::copyToUTF8(std::string &str, const unsigned char *ptr, const std::size_t len) {
+	if (len == 0) {
+		return;
+	}
+	// Text that is already UTF-8 (0x15) can be copied as is
+	if (ptr[0] == 0x15) {
+		str.append(reinterpret_cast<const char *>(ptr + 1), len - 1);
+		return;
+	}
+	const std::size_t offset = (ptr[0] < 0x20) ? ((ptr[0] == 0x10) ? 3 : (ptr[0] == 0x1F) ? 2 : 1) : 0;
+	if (offset > len) {
+		return;
+	}
+	for (std::size_t i = offset; i < len; ++i) {
+		if ((ptr[i] & 0x80) == 0x80) {
+			const unsigned char b = 0x80 |  (ptr[i] & 0x3F);
+			const unsigned char c = 0xC0 | ((ptr[i] & 0xC0) >> 6);
+			str.append(1, c);
+			str.append(1, b);
+		} else {
+			str.append(1, ptr[i]);
+		}
+	}
+}
+
 // =============================================================================
 //  -- Other member functions --------------------------------------------------
 // =============================================================================
@@ -112,7 +144,8 @@ void TableData::clear() {
 	_numberOfSections = 0;
 	_currentSectionNumber = 0;
 	_collectingFinished = false;
-	_dataTable.clear();
+	_sections.clear();
+	_arena.clear();
 }
 
 const char* TableData::getTableTXT(const int tableID) const {
@@ -149,14 +182,14 @@ const char* TableData::getTableTXT(const int tableID) const {
 
 void TableData::collectData(const FeID id, const int tableID,
 		const unsigned char *data, const bool trace, const bool raw) {
-	Data &currentTableData = _dataTable[_currentSectionNumber];
-	const std::size_t tableSize = currentTableData.data.size();
+	Data &currentTableData = getCurrentSection();
+	const std::size_t tableSize = currentTableData.size;
 	const bool payloadStart = (data[1] & 0x40) == 0x40;
 	if (payloadStart && data[4] == 0x00 && data[5] == tableID && tableSize == 0) {
 		const int pid                   = ((data[1] & 0x1F) << 8) | data[2];
 		const int cc                    =   data[3] & 0x0F;
 		const std::size_t sectionLength = ((data[6] & 0x0F) << 8) | data[7];
-		const int         version       =  (data[10] & 0x1F) >> 1;
+		const int         version       =  (data[10] & 0x3E) >> 1;
 		const int         nextIndicator =   data[10] & 0x1;
 		const std::size_t secNr         =   data[11];
 		const std::size_t lastSecNr     =   data[12];
@@ -177,14 +210,14 @@ void TableData::collectData(const FeID id, const int tableID,
 			if (addData(tableID, data, 188, pid, cc)) {
 				if (trace) {
 					SI_LOG_INFO("Frontend: @#1, @#2 - PID @#3: sectionLength: @#4  tableDataSize: @#5  secNr: @#6  lastSecNr: @#7  currSecNr: @#8",
-						id, getTableTXT(tableID), DIGIT(pid, 4), sectionLength, currentTableData.data.size(), secNr, lastSecNr, _currentSectionNumber);
+						id, getTableTXT(tableID), DIGIT(pid, 4), sectionLength, currentTableData.size, secNr, lastSecNr, _currentSectionNumber);
 				}
 				// Check did we finish collecting Table Data
 				if (sectionLength <= (188 - 4 - 4)) { // 4 = TS Header  4 = CRC
 					if (raw) {
 						setCollected();
 					} else {
-						const unsigned char *crcData = currentTableData.data.c_str();
+						const unsigned char *crcData = &_arena[currentTableData.offset];
 						const uint32_t crc     = CRC(crcData, sectionLength);
 						const uint32_t calccrc = calculateCRC32(&crcData[5], sectionLength - 4 + 3);
 						if (calccrc == crc) {
@@ -193,12 +226,12 @@ void TableData::collectData(const FeID id, const int tableID,
 						} else {
 							SI_LOG_ERROR("Frontend: @#1, @#2 - CRC Error! Calc CRC32: @#3 - TS CRC32: @#4  Retrying to collect data...",
 								id, getTableTXT(tableID), HEX(calccrc, 4), HEX(crc, 4));
-							_dataTable.erase(_dataTable.find(_currentSectionNumber));
+							resetCurrentSection();
 						}
 					}
 				}
 			} else {
-				_dataTable.erase(_dataTable.find(_currentSectionNumber));
+				resetCurrentSection();
 			}
 		}
 	} else if (tableSize > 0) {
@@ -210,14 +243,14 @@ void TableData::collectData(const FeID id, const int tableID,
 
 		// Add Table Data without TS Header
 		if (addData(tableID, &data[4], 188 - 4, pid, cc)) { // 4 = TS Header
-			const std::size_t tableDataSize = currentTableData.data.size();
+			const std::size_t tableDataSize = currentTableData.size;
 			if (trace) {
 				SI_LOG_INFO("Frontend: @#1, @#2 - PID @#3: sectionLength: @#4  tableDataSize: @#5  secNr: @#6  lastSecNr: @#7  currSecNr: @#8",
 					id, getTableTXT(tableID), DIGIT(pid, 4), sectionLength, tableDataSize, currentTableData.secNr, currentTableData.lastSecNr, _currentSectionNumber);
 			}
 			// Check did we finish collecting Table Data
 			if (sectionLength <= (tableDataSize - 9)) { // 9 = Untill Table Section Length
-				const unsigned char *crcData = currentTableData.data.c_str();
+				const unsigned char *crcData = &_arena[currentTableData.offset];
 				const uint32_t crc     = CRC(crcData, sectionLength);
 				const uint32_t calccrc = calculateCRC32(&crcData[5], sectionLength - 4 + 3);
 				if (calccrc == crc) {
@@ -226,28 +259,32 @@ void TableData::collectData(const FeID id, const int tableID,
 				} else {
 					SI_LOG_ERROR("Frontend: @#1, @#2 - CRC Error! Calc CRC32: @#3 - TS CRC32: @#4  Retrying to collect data...",
 						id, getTableTXT(tableID), HEX(calccrc, 4), HEX(crc, 4));
-					_dataTable.erase(_dataTable.find(_currentSectionNumber));
+					resetCurrentSection();
 				}
 			}
 		} else {
 			SI_LOG_ERROR("Frontend: @#1, @#2 - PID @#3: Unable to add data! Retrying to collect data",
 				id, getTableTXT(tableID), DIGIT(pid, 4));
-			_dataTable.erase(_dataTable.find(_currentSectionNumber));
+			resetCurrentSection();
 		}
 	} else {
 //			SI_LOG_ERROR("Frontend: @#1, @#2 - PID @#3: Unable to add data! Retrying to collect data", id, getTableTXT(0), DIGIT(pid, 4));
-		_dataTable.erase(_dataTable.find(_currentSectionNumber));
+		resetCurrentSection();
 	}
 }
 
 bool TableData::addData(const int tableID, const unsigned char *data,
 		const int length, const int pid, const int cc) {
-	Data &currentTableData = _dataTable[_currentSectionNumber];
+	Data &currentTableData = getCurrentSection();
 	currentTableData.tableID = tableID;
 	// Is this the first try or a follow-up then check cc
-	if (currentTableData.data.size() == 0 ||
+	if (currentTableData.size == 0 ||
 		(cc == (currentTableData.cc + 1) % 0x10 && pid == currentTableData.pid)) {
-		currentTableData.data.append(data, length);
+		if (currentTableData.size == 0) {
+			currentTableData.offset = _arena.size();
+		}
+		_arena.insert(_arena.end(), data, data + length);
+		currentTableData.size += length;
 		currentTableData.cc   = cc;
 		currentTableData.pid  = pid;
 		return true;
@@ -255,10 +292,25 @@ bool TableData::addData(const int tableID, const unsigned char *data,
 	return false;
 }
 
+TableData::Data &TableData::getCurrentSection() {
+	if (_currentSectionNumber >= _sections.size()) {
+		_sections.resize(_currentSectionNumber + 1, Data());
+	}
+	return _sections[_currentSectionNumber];
+}
+
+void TableData::resetCurrentSection() {
+	Data &currentTableData = getCurrentSection();
+	if (currentTableData.size > 0) {
+		_arena.resize(currentTableData.offset);
+	}
+	currentTableData = Data();
+}
+
 bool TableData::getDataForSectionNumber(const size_t secNr, TableData::Data &data) const {
-	auto s = _dataTable.find(secNr);
-	if (s != _dataTable.end()) {
-		data = s->second;
+	if (secNr < _sections.size() && _sections[secNr].size > 0) {
+		data = _sections[secNr];
+		data.data = &_arena[data.offset];
 		return true;
 	}
 	return false;
@@ -267,11 +319,33 @@ bool TableData::getDataForSectionNumber(const size_t secNr, TableData::Data &dat
 TSData TableData::getData(const size_t secNr) const {
 	TableData::Data tableData;
 	if (getDataForSectionNumber(secNr, tableData)) {
-		return tableData.data;
+		return TSData(tableData.data, tableData.size);
 	}
 	return TSData();
 }
 
+TSData TableData::getTSPackets() const {
+	TSData packets;
+	for (const Data &section : _sections) {
+		if (!section.collected) {
+			continue;
+		}
+		// The first packet is kept complete, the others without TS Header
+		const unsigned char *data = &_arena[section.offset];
+		packets.append(data, 188);
+		int cc = data[3] & 0x0F;
+		for (std::size_t i = 188; i + 184 <= section.size; i += 184) {
+			cc = (cc + 1) % 0x10;
+			const unsigned char header[4] = { 0x47,
+				static_cast<unsigned char>(data[1] & 0x1F), data[2],
+				static_cast<unsigned char>(0x10 | cc) };
+			packets.append(header, 4);
+			packets.append(&data[i], 184);
+		}
+	}
+	return packets;
+}
+
 int TableData::getAssociatedPID() const {
 	TableData::Data tableData;
 	if (getDataForSectionNumber(0, tableData)) {
@@ -285,8 +359,7 @@ bool TableData::isCollected() const {
 		return true;
 	}
 	for (std::size_t i = 0; i < _numberOfSections; ++i) {
-		TableData::Data tableData;
-		if (getDataForSectionNumber(i, tableData) && tableData.collected) {
+		if (i < _sections.size() && _sections[i].collected) {
 			_collectingFinished = true;
 		} else {
 			_collectingFinished = false;
@@ -296,8 +369,38 @@ bool TableData::isCollected() const {
 	return _collectingFinished;
 }
 
+bool TableData::isVersionChanged(const int tableID, const unsigned char *data) const {
+	// Only check a new section that starts directly after the pointer field
+	const bool payloadStart = (data[1] & 0x40) == 0x40;
+	if (!payloadStart || data[4] != 0x00 || data[5] != tableID || !isCollected()) {
+		return false;
+	}
+	const int nextIndicator = data[10] & 0x1;
+	if (nextIndicator == 0) {
+		// Not applicable yet
+		return false;
+	}
+	const std::size_t secNr = data[11];
+	const std::size_t lastSecNr = data[12];
+	if (secNr >= _sections.size() || lastSecNr + 1u != _numberOfSections) {
+		return true;
+	}
+	const Data &section = _sections[secNr];
+	const int version = (data[10] & 0x3E) >> 1;
+	if (version != section.version) {
+		return true;
+	}
+	// When the section fits in this packet, compare the CRC as it is sent
+	const std::size_t sectionLength = ((data[6] & 0x0F) << 8) | data[7];
+	if (sectionLength <= (188 - 4 - 4)) { // 4 = TS Header  4 = CRC
+		const uint32_t crc = CRC(data, sectionLength);
+		return crc != section.crc;
+	}
+	return false;
+}
+
 void TableData::setCollected() {
-	_dataTable[_currentSectionNumber].collected = true;
+	getCurrentSection().collected = true;
 	// Do we need to read more sections, then increment
 	if (_currentSectionNumber < (_numberOfSections - 1)) {
 		++_currentSectionNumber;
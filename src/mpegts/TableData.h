@@ -23,8 +23,9 @@
 #include <Defs.h>
 
 #include <cstdint>
+#include <ctime>
 #include <string>
-#include <map>
+#include <vector>
 
 namespace mpegts {
 
@@ -55,18 +56,25 @@ class TableData {
 		static constexpr int SDT_ID       = 0x42;
 		static constexpr int EIT1_ID      = 0x4E;
 		static constexpr int EIT2_ID      = 0x4F;
+		static constexpr int TDT_ID       = 0x70;
+		static constexpr int TOT_ID       = 0x73;
 		static constexpr int ECM0_ID      = 0x80;
 		static constexpr int ECM1_ID      = 0x81;
 		static constexpr int EMM1_ID      = 0x82;
 		static constexpr int EMM2_ID      = 0x83;
 		static constexpr int EMM3_ID      = 0x84;
 
+		/// Initial arena size, enough for one maximum sized PSI section
+		static constexpr std::size_t ARENA_SIZE = 4096 + 188;
+
 		// =========================================================================
 		// -- Constructors and destructor ------------------------------------------
 		// =========================================================================
 	public:
 
-		TableData() = default;
+		TableData() {
+			_arena.reserve(ARENA_SIZE);
+		}
 
 		virtual ~TableData() = default;
 
@@ -75,8 +83,31 @@ class TableData {
 		// =========================================================================
 	public:
 
+		/// Calculate the CRC32 of the section data, @see CRC32
 		static uint32_t calculateCRC32(const unsigned char *data, std::size_t len);
 
+		/// Reference byte by byte version of @see calculateCRC32
+		static uint32_t calculateCRC32Reference(const unsigned char *data, std::size_t len);
+
+		/// Append the DVB text (ETSI EN 300 468 Annex A) to str as UTF-8
+		/// @param str specifies the string to append the text to
+		/// @param ptr specifies the text, including the character table bytes
+		/// @param len specifies the length of the text
+		static void copyToUTF8(std::string &str, const unsigned char *ptr, std::size_t len);
+
+		/// Get the value of the BCD coded byte
+		static int fromBCD(const unsigned char bcd) {
+			return ((bcd >> 4) * 10) + (bcd & 0x0F);
+		}
+
+		/// Get the UTC time of the 40 bit MJD and BCD coded time, as used by
+		/// the TDT, TOT and EIT
+		static std::time_t getUTCTime(const unsigned char *ptr) {
+			const std::time_t mjd = (ptr[0] << 8) | ptr[1];
+			return ((mjd - 40587) * 86400) +
+				(fromBCD(ptr[2]) * 3600) + (fromBCD(ptr[3]) * 60) + fromBCD(ptr[4]);
+		}
+
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
@@ -85,7 +116,8 @@ class TableData {
 		/// Clear the collected table and data
 		virtual void clear();
 
-		/// Get an copy of the requested table data
+		/// Get a view on the requested section, the data pointer stays valid
+		/// until the table is collected again or cleared
 		/// @param secNr
 		/// @param data
 		bool getDataForSectionNumber(size_t secNr, TableData::Data &data) const;
@@ -103,9 +135,20 @@ class TableData {
 		/// Get the collected Table Data
 		TSData getData(size_t secNr) const;
 
+		/// Get all collected sections again as TS packets, so they can be
+		/// collected later with @see collectData
+		TSData getTSPackets() const;
+
 		/// Check if Table is collected
 		bool isCollected() const;
 
+		/// Check if the section starting in this TS packet has an other version
+		/// or CRC than the collected one. Only the section header is compared,
+		/// so this is cheap enough to call for every packet of a collected table
+		/// @param tableID specifies the table ID the data should belong to
+		/// @param data specifies the TS packet to check
+		bool isVersionChanged(int tableID, const unsigned char *data) const;
+
 		/// Get the associated PID of this table
 		int getAssociatedPID() const;
 
@@ -151,6 +194,12 @@ class TableData {
 		/// Collect Table data for tableID
 		void collectData(FeID id, int tableID, const unsigned char *data, bool trace, bool raw);
 
+		/// Get the section that is being collected now
+		Data &getCurrentSection();
+
+		/// Drop the section that is being collected, so it can be retried
+		void resetCurrentSection();
+
 		// =========================================================================
 		//  -- Data members --------------------------------------------------------
 		// =========================================================================
@@ -164,10 +213,15 @@ class TableData {
 			int secNr;
 			int lastSecNr;
 			uint32_t crc;
-			TSData data;
 			int cc;
 			int pid;
 			bool collected;
+			/// Begin of the section in the arena
+			std::size_t offset;
+			/// Collected size of the section in the arena
+			std::size_t size;
+			/// View on the section, only set by @see getDataForSectionNumber
+			const unsigned char *data;
 		};
 
 	protected:
@@ -178,7 +232,10 @@ class TableData {
 
 		std::size_t _currentSectionNumber = 0;
 		mutable bool _collectingFinished = false;
-		std::map<int, Data> _dataTable;
+		/// Sections indexed by section number, their data is in @see _arena
+		std::vector<Data> _sections;
+		/// Sections are collected in order, so the current one is always last
+		std::vector<unsigned char> _arena;
 
 };
 
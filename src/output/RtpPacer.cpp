@@ -0,0 +1,118 @@
+/* RtpPacer.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <output/RtpPacer.h>
+
+#include <mpegts/PacketBuffer.h>
+#include <mpegts/PCR.h>
+
+#include <algorithm>
+
+namespace output {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+RtpPacer::RtpPacer() {
+	reset();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void RtpPacer::reset() {
+	_pcrTracker.reset();
+	_pcrBytes = 0;
+	_bitrate = 0.0;
+	_nextLaunch = Clock::now();
+	_periodStart = _nextLaunch;
+	_window = 0;
+	_windowBytes = 0;
+	_peakBytes = 0;
+	_periodBytes = 0;
+	_burstiness = 0.0;
+}
+
+RtpPacer::Clock::time_point RtpPacer::schedule(
+		const mpegts::PacketBuffer &buffer, const Clock::time_point now) {
+	const std::size_t packets = buffer.getNumberOfCompletedPackets();
+	for (std::size_t i = 0; i < packets; ++i) {
+		const unsigned char *ts = buffer.getTSPacketPtr(i);
+		_pcrBytes += mpegts::PacketBuffer::TS_PACKET_SIZE;
+		// A PCR needs an adaptation field of at least 7 bytes
+		if (ts[4] < 7 || !mpegts::PCR::isPCRTableData(ts)) {
+			continue;
+		}
+		const int pid = ((ts[1] & 0x1f) << 8) | ts[2];
+		const mpegts::PCRTracker::Result result = _pcrTracker.addPCR(pid,
+			mpegts::PCR::getPCRValue(ts), mpegts::PCR::isDiscontinuity(ts), now);
+		if (result == mpegts::PCRTracker::Result::Ignored) {
+			continue;
+		}
+		const std::uint64_t delta = _pcrTracker.getDelta();
+		if (result == mpegts::PCRTracker::Result::Continuous && delta > 0) {
+			const double bitrate = (_pcrBytes * 8.0 * mpegts::PCR::CLOCK_FREQUENCY) / delta;
+			_bitrate = (_bitrate == 0.0) ? bitrate : _bitrate + ((bitrate - _bitrate) / 16.0);
+		}
+		_pcrBytes = 0;
+	}
+	if (_pcrTracker.checkTimeout(now)) {
+		_bitrate = 0.0;
+	}
+	if (_bitrate == 0.0) {
+		_nextLaunch = now;
+		return now;
+	}
+	// Packets that arrive late go out right away, the following ones are spread
+	const Clock::time_point launch = std::max(_nextLaunch, now);
+	const double bits = buffer.getCurrentBufferSize() * 8.0;
+	_nextLaunch = launch + std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<double>(bits / (_bitrate * HEADROOM)));
+	_nextLaunch = std::min(_nextLaunch, now + MAX_LEAD);
+	return launch;
+}
+
+bool RtpPacer::addSend(const std::size_t bytes, const Clock::time_point time) {
+	const std::int64_t window = std::chrono::duration_cast<std::chrono::milliseconds>(
+		time.time_since_epoch()).count();
+	if (window != _window) {
+		_peakBytes = std::max(_peakBytes, _windowBytes);
+		_windowBytes = 0;
+		_window = window;
+	}
+	_windowBytes += bytes;
+	_periodBytes += bytes;
+
+	const Clock::duration period = time - _periodStart;
+	if (period < std::chrono::seconds(1)) {
+		return false;
+	}
+	_peakBytes = std::max(_peakBytes, _windowBytes);
+	const double periodMS = std::chrono::duration<double, std::milli>(period).count();
+	_burstiness = (_peakBytes * periodMS) / _periodBytes;
+	_periodStart = time;
+	_peakBytes = 0;
+	_periodBytes = 0;
+	_windowBytes = 0;
+	return true;
+}
+
+} // namespace output
@@ -0,0 +1,108 @@
+/* RtpPacer.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef OUTPUT_RTPPACER_H_INCLUDE
+#define OUTPUT_RTPPACER_H_INCLUDE OUTPUT_RTPPACER_H_INCLUDE
+
+#include <FwDecl.h>
+#include <mpegts/PCRTracker.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+FW_DECL_NS1(mpegts, PacketBuffer);
+
+namespace output {
+
+/// The class @c RtpPacer spreads the RTP packets of a stream evenly in time.
+/// It locks onto the first PID carrying a PCR with @c mpegts::PCRTracker, derives the bitrate from the
+/// amount of bytes between two PCRs and gives each packet a launch time at
+/// that bitrate. It also measures how bursty the packets are really send.
+class RtpPacer {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	public:
+
+		RtpPacer();
+
+		virtual ~RtpPacer() = default;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Forget the PCR lock, bitrate and statistics
+		void reset();
+
+		/// Learn the bitrate from the PCRs in this buffer and get the time
+		/// it should be send. Call this once for each buffer, in stream order
+		/// @param buffer specifies the buffer to schedule
+		/// @param now specifies the current time
+		/// @return the launch time, which is @c now while the bitrate is unknown
+		Clock::time_point schedule(const mpegts::PacketBuffer &buffer, Clock::time_point now);
+
+		/// Account the send packet for the burstiness measurement
+		/// @param bytes specifies the size of the send packet
+		/// @param time specifies the time it was (or will be) send
+		/// @return true if a new measurement period of one second finished
+		bool addSend(std::size_t bytes, Clock::time_point time);
+
+		/// Get the bitrate in bits/s or 0 when not known (yet)
+		double getBitrate() const {
+			return _bitrate;
+		}
+
+		/// Get the peak 1ms send rate divided by the mean send rate of the
+		/// last measurement period, 1.0 means perfectly smooth
+		double getBurstiness() const {
+			return _burstiness;
+		}
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		/// Send a little faster then the PCR bitrate, so no backlog builds up
+		static constexpr double HEADROOM = 1.02;
+		/// Maximum time the launch time may run ahead of the current time
+		static constexpr Clock::duration MAX_LEAD = std::chrono::milliseconds(100);
+
+		mpegts::PCRTracker _pcrTracker;
+		std::uint64_t _pcrBytes;
+		double _bitrate;
+		Clock::time_point _nextLaunch;
+
+		Clock::time_point _periodStart;
+		std::int64_t _window;
+		std::size_t _windowBytes;
+		std::size_t _peakBytes;
+		std::size_t _periodBytes;
+		double _burstiness;
+};
+
+} // namespace output
+
+#endif // OUTPUT_RTPPACER_H_INCLUDE
@@ -0,0 +1,118 @@
+/* RtpTimestamp.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <output/RtpTimestamp.h>
+
+#include <mpegts/PacketBuffer.h>
+#include <mpegts/PCR.h>
+
+namespace output {
+
+/// The RTP timestamp runs at 90KHz, the PCR at 27MHz
+static constexpr std::uint64_t PCR_TICKS_PER_RTP_TICK = 300;
+static constexpr double RTP_CLOCK_FREQUENCY = 90000.0;
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+RtpTimestamp::RtpTimestamp() {
+	reset();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void RtpTimestamp::reset() {
+	_pcrTracker.reset();
+	_pcrMedia = 0;
+	_pcrBytes = 0;
+	_time = Clock::now();
+	_bytesPerTick = 0.0;
+	_offset = 0;
+	_synced = false;
+	_timestamp = static_cast<uint32_t>(
+		std::chrono::duration<double>(_time.time_since_epoch()).count() * RTP_CLOCK_FREQUENCY);
+}
+
+uint32_t RtpTimestamp::getClockTimestamp(const Clock::time_point now) const {
+	return _timestamp + static_cast<uint32_t>(
+		std::chrono::duration<double>(now - _time).count() * RTP_CLOCK_FREQUENCY);
+}
+
+uint32_t RtpTimestamp::getTimestamp(const mpegts::PacketBuffer &buffer, const Clock::time_point now) {
+	if (_pcrTracker.checkTimeout(now)) {
+		_bytesPerTick = 0.0;
+		_synced = false;
+	}
+	if (_bytesPerTick > 0.0) {
+		// Media time of the first packet, from its distance to the last PCR
+		const uint32_t media = static_cast<uint32_t>((_pcrMedia +
+			static_cast<std::uint64_t>(_pcrBytes / _bytesPerTick)) / PCR_TICKS_PER_RTP_TICK);
+		if (!_synced) {
+			_offset = getClockTimestamp(now) - media;
+			_synced = true;
+		}
+		_timestamp = media + _offset;
+	} else {
+		_timestamp = getClockTimestamp(now);
+	}
+	_time = now;
+
+	// Learn the PCRs of this buffer for the next one
+	const std::size_t packets = buffer.getNumberOfCompletedPackets();
+	for (std::size_t i = 0; i < packets; ++i) {
+		const unsigned char *ts = buffer.getTSPacketPtr(i);
+		// A PCR needs an adaptation field of at least 7 bytes
+		if (ts[4] >= 7 && mpegts::PCR::isPCRTableData(ts)) {
+			const int pid = ((ts[1] & 0x1f) << 8) | ts[2];
+			const std::uint64_t pcr = mpegts::PCR::getPCRValue(ts);
+			switch (_pcrTracker.addPCR(pid, pcr, mpegts::PCR::isDiscontinuity(ts), now)) {
+				case mpegts::PCRTracker::Result::Ignored:
+					break;
+				case mpegts::PCRTracker::Result::Locked:
+					_pcrBytes = 0;
+					break;
+				case mpegts::PCRTracker::Result::Continuous: {
+					const std::uint64_t delta = _pcrTracker.getDelta();
+					if (delta > 0) {
+						const double bytesPerTick = _pcrBytes / static_cast<double>(delta);
+						_bytesPerTick = (_bytesPerTick == 0.0) ? bytesPerTick :
+							_bytesPerTick + ((bytesPerTick - _bytesPerTick) / 16.0);
+					}
+					_pcrMedia += delta;
+					_pcrBytes = 0;
+					}
+					break;
+				case mpegts::PCRTracker::Result::Discontinuous:
+					if (_bytesPerTick > 0.0) {
+						// Continue the media time over the discontinuity at the bitrate
+						_pcrMedia += static_cast<std::uint64_t>(_pcrBytes / _bytesPerTick);
+					}
+					_pcrBytes = 0;
+					break;
+			}
+		}
+		_pcrBytes += mpegts::PacketBuffer::TS_PACKET_SIZE;
+	}
+	return _timestamp;
+}
+
+} // namespace output
@@ -0,0 +1,91 @@
+/* RtpTimestamp.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef OUTPUT_RTPTIMESTAMP_H_INCLUDE
+#define OUTPUT_RTPTIMESTAMP_H_INCLUDE OUTPUT_RTPTIMESTAMP_H_INCLUDE
+
+#include <FwDecl.h>
+#include <mpegts/PCRTracker.h>
+
+#include <chrono>
+#include <cstdint>
+
+FW_DECL_NS1(mpegts, PacketBuffer);
+
+namespace output {
+
+/// The class @c RtpTimestamp gives the 90KHz RTP timestamp of the first TS
+/// packet of each RTP packet in media time. It locks onto the first PID
+/// carrying a PCR with @c mpegts::PCRTracker and interpolates between the PCRs on the byte position in
+/// the stream. Without PCR it continues on the monotonic clock, the switch
+/// between both keeps the timestamps continuous.
+class RtpTimestamp {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	public:
+
+		RtpTimestamp();
+
+		virtual ~RtpTimestamp() = default;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Forget the PCR lock and start again from the monotonic clock
+		void reset();
+
+		/// Get the timestamp of the first TS packet in this buffer and learn
+		/// the PCRs in it. Call this once for each buffer, in stream order
+		/// @param buffer specifies the buffer to get the timestamp for
+		/// @param now specifies the current time
+		uint32_t getTimestamp(const mpegts::PacketBuffer &buffer, Clock::time_point now);
+
+	private:
+
+		/// Get the timestamp continued from the last one on the monotonic clock
+		uint32_t getClockTimestamp(Clock::time_point now) const;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		mpegts::PCRTracker _pcrTracker;
+		/// Media time of the last PCR in 27MHz ticks, continuous over wraps
+		std::uint64_t _pcrMedia;
+		/// Bytes from the last PCR to the begin of the next buffer
+		std::uint64_t _pcrBytes;
+		double _bytesPerTick;
+		/// Added to the media time to continue from the monotonic clock
+		uint32_t _offset;
+		bool _synced;
+
+		uint32_t _timestamp;
+		Clock::time_point _time;
+};
+
+} // namespace output
+
+#endif // OUTPUT_RTPTIMESTAMP_H_INCLUDE
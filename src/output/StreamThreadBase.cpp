@@ -29,8 +29,10 @@
 	#include <decrypt/dvbapi/Client.h>
 #endif
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstring>
 #include <thread>
 
 namespace output {
@@ -52,7 +54,28 @@ StreamThreadBase::StreamThreadBase(const std::string &protocol, StreamInterface
 		std::bind(&StreamThreadBase::threadExecuteDeviceMonitor, this)),
 	_writeIndex(0),
 	_readIndex(0),
-	_sendInterval(100) {
+	_sendInterval(100),
+	_pollDeviceFD(-1),
+	_pollDeviceGeneration(0),
+	_pollDeviceArmed(false),
+	_pollDeviceHangUp(false),
+	_pollClientFD(-1),
+	_dataSend(false),
+	_batchPending(false),
+	_consumer(false),
+	_sharedCount(0),
+	_consumerFlush(false),
+	_pipelined(false),
+	_decryptIndex(0),
+	_readyIndex(0),
+	_decryptIdle(true),
+	_sendIdle(true),
+	_threadDecrypt(
+		StringConverter::stringFormat("Decrypt@#1", stream.getFeID()),
+		std::bind(&StreamThreadBase::threadExecuteDecrypt, this)),
+	_threadSend(
+		StringConverter::stringFormat("Send@#1", stream.getFeID()),
+		std::bind(&StreamThreadBase::threadExecuteSend, this)) {
 	// Initialize all TS packets
 	uint32_t ssrc = _stream.getSSRC();
 	long timestamp = _stream.getTimestamp();
@@ -63,13 +86,18 @@ StreamThreadBase::StreamThreadBase(const std::string &protocol, StreamInterface
 	_tsEmpty.initialize(ssrc, timestamp);
 	std::memcpy(_tsEmpty.getWriteBufferPtr(), nullPacked.data(), 188);
 	_tsEmpty.addAmountOfBytesWritten(188);
+	// Without epoll we fall back to polling with isDataAvailable()
+	if (_poll.open()) {
+		_poll.setTimerInterval(SEND_DEADLINE);
+	}
 }
 
 StreamThreadBase::~StreamThreadBase() {
 	_threadDeviceMonitor.terminateThread();
 #ifdef LIBDVBCSA
+	// A consumer does not own the decrypt of this frontend
 	decrypt::dvbapi::SpClient decrypt = _stream.getDecryptDevice();
-	if (decrypt != nullptr) {
+	if (decrypt != nullptr && !_consumer) {
 		decrypt->stopDecrypt(_stream.getFeIndex(), _stream.getFeID());
 	}
 #endif
@@ -84,14 +112,31 @@ void StreamThreadBase::threadEntry() {
 	while (running()) {
 		switch (_state) {
 			case State::Pause:
-				_state = State::Paused;
+				// The pipeline stages should leave the ring alone before it is paused
+				if (!_pipelined || (_decryptIdle && _sendIdle)) {
+					_state = State::Paused;
+				} else {
+					_decryptEvent.notify();
+					_sendEvent.notify();
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
 				break;
 			case State::Paused:
 				// Do nothing here, just wait
 				std::this_thread::sleep_for(std::chrono::milliseconds(50));
 				break;
-			case State::Running:
-				readDataFromInputDevice(client);
+			case State::Running: {
+					if (_consumer) {
+						sendConsumerData(client);
+						break;
+					}
+					const int fd = _stream.getInputDevice()->getPollFD();
+					if (fd != -1 && _poll.isOpen()) {
+						pollDataFromInputDevice(client, fd);
+					} else {
+						readDataFromInputDevice(client);
+					}
+				}
 				break;
 			default:
 				SI_LOG_PERROR("Wrong State");
@@ -99,6 +144,11 @@ void StreamThreadBase::threadEntry() {
 				break;
 		}
 	}
+	// Stop the pipeline stages before the output is destroyed
+	if (_pipelined) {
+		_threadDecrypt.terminateThread();
+		_threadSend.terminateThread();
+	}
 }
 
 // =============================================================================
@@ -118,17 +168,26 @@ bool StreamThreadBase::startStreaming(const int clientID) {
 	doStartStreaming(clientID);
 
 	_cseq = 0x0000;
-	_writeIndex = 0;
-	_readIndex = 0;
-	_tsBuffer[_writeIndex].reset();
+	_rtpTimestamp.reset();
+	resetBuffers(clientID);
+	registerStreamSocketFD();
+
+	_pipelined = _stream.isPipelineEnabled() && startPipeline();
 
 	if (!startThread()) {
 		SI_LOG_ERROR("Frontend: @#1, Start @#2 Start stream to @#3:@#4 ERROR", id, _protocol,
 			client.getIPAddressOfStream(), getStreamSocketPort(clientID));
+		if (_pipelined) {
+			_threadDecrypt.terminateThread();
+			_threadSend.terminateThread();
+		}
 		return false;
 	}
 	// Set priority above normal for this Thread
 	setPriority(Priority::AboveNormal);
+	if (_pipelined) {
+		setAffinity(_stream.getPipelineCPU(StreamInterface::PipelineStage::Read));
+	}
 
 	// set begin timestamp
 	_t1 = std::chrono::steady_clock::now();
@@ -183,9 +242,15 @@ bool StreamThreadBase::restartStreaming(const int clientID) {
 	if (running()) {
 		_threadDeviceMonitor.restartThread();
 		doRestartStreaming(clientID);
-		_writeIndex = 0;
-		_readIndex  = 0;
-		_tsBuffer[_writeIndex].reset();
+		resetBuffers(clientID);
+		// Input device could be reopened, so register it again
+		if (_pollDeviceArmed) {
+			_poll.removeFD(_pollDeviceFD);
+		}
+		_pollDeviceFD = -1;
+		_pollDeviceArmed = false;
+		_pollDeviceHangUp = false;
+		registerStreamSocketFD();
 		_state = State::Running;
 		SI_LOG_INFO("Frontend: @#1, Restart @#2 stream to @#3:@#4", _stream.getFeID(),
 			_protocol, _stream.getStreamClient(clientID).getIPAddressOfStream(),
@@ -194,6 +259,199 @@ bool StreamThreadBase::restartStreaming(const int clientID) {
 	return true;
 }
 
+bool StreamThreadBase::startConsumer(const int clientID) {
+	_clientID = clientID;
+	_consumer = true;
+	const StreamClient &client = _stream.getStreamClient(clientID);
+
+	doStartStreaming(clientID);
+
+	_cseq = 0x0000;
+	_rtpTimestamp.reset();
+	resetBuffers(clientID);
+
+	if (!startThread()) {
+		SI_LOG_ERROR("Frontend: @#1, Start @#2 Start stream to @#3:@#4 ERROR (Sharing transponder)",
+			_stream.getFeID(), _protocol, client.getIPAddressOfStream(), getStreamSocketPort(clientID));
+		return false;
+	}
+	setPriority(Priority::AboveNormal);
+
+	_state = State::Running;
+	SI_LOG_INFO("Frontend: @#1, Start @#2 stream to @#3:@#4 (Sharing transponder)", _stream.getFeID(),
+		_protocol, client.getIPAddressOfStream(), getStreamSocketPort(clientID));
+	return true;
+}
+
+void StreamThreadBase::writeConsumerData(const mpegts::PacketBuffer &buffer) {
+	const StreamClient &client = _stream.getStreamClient(_clientID);
+	bool published = false;
+	const std::size_t size = buffer.getNumberOfCompletedPackets();
+	for (std::size_t i = 0; i < size; ++i) {
+		const unsigned char *ts = buffer.getTSPacketPtr(i);
+		const int pid = ((ts[1] & 0x1f) << 8) | ts[2];
+		if (!client.isPIDSelected(pid)) {
+			continue;
+		}
+		mpegts::PacketBuffer &tsBuffer = _tsBuffer[_writeIndex];
+		std::memcpy(tsBuffer.getWriteBufferPtr(), ts, mpegts::PacketBuffer::TS_PACKET_SIZE);
+		tsBuffer.addAmountOfBytesWritten(mpegts::PacketBuffer::TS_PACKET_SIZE);
+		if (tsBuffer.full()) {
+			if (getAvailableBufferSize() >= 1) {
+				// reset next, then goto next so the consumer thread can take this one
+				const size_t next = (_writeIndex + 1) % MAX_BUF;
+				_tsBuffer[next].reset();
+				_writeIndex = next;
+				published = true;
+			} else {
+				// Consumer can not keep up, drop it instead of blocking the owner
+				tsBuffer.reset();
+			}
+		}
+	}
+	if (published) {
+		_sendEvent.notify();
+	}
+}
+
+void StreamThreadBase::flushConsumerData() {
+	mpegts::PacketBuffer &tsBuffer = _tsBuffer[_writeIndex];
+	if (!tsBuffer.empty() && getAvailableBufferSize() >= 1) {
+		while (!tsBuffer.full()) {
+			std::memcpy(tsBuffer.getWriteBufferPtr(), _tsEmpty.getTSReadBufferPtr(),
+				mpegts::PacketBuffer::TS_PACKET_SIZE);
+			tsBuffer.addAmountOfBytesWritten(mpegts::PacketBuffer::TS_PACKET_SIZE);
+		}
+		const size_t next = (_writeIndex + 1) % MAX_BUF;
+		_tsBuffer[next].reset();
+		_writeIndex = next;
+	}
+	_consumerFlush = true;
+	_sendEvent.notify();
+}
+
+size_t StreamThreadBase::writeBatchToOutputDevice(
+		mpegts::PacketBuffer **buffers, const size_t count, StreamClient &client) {
+	size_t i = 0;
+	for (; i < count; ++i) {
+		if (!writeDataToOutputDevice(*buffers[i], client)) {
+			break;
+		}
+	}
+	return i;
+}
+
+void StreamThreadBase::wakeUpAt(const std::chrono::steady_clock::time_point time) {
+	if (_consumer || _pipelined) {
+		_sendWakeUp = std::min(_sendWakeUp, time);
+	} else if (_poll.isOpen()) {
+		_poll.setWakeUpTime(time);
+	}
+}
+
+long StreamThreadBase::getRtpTimestamp(const mpegts::PacketBuffer &buffer) {
+	if (_stream.isRtpPCRTimestampEnabled()) {
+		return _rtpTimestamp.getTimestamp(buffer, RtpTimestamp::Clock::now());
+	}
+	return base::TimeCounter::getTicks() * 90;
+}
+
+void StreamThreadBase::registerStreamSocketFD() {
+	if (!_poll.isOpen()) {
+		return;
+	}
+	if (_pollClientFD != -1) {
+		_poll.removeFD(_pollClientFD);
+	}
+	// Only watch for a hangup/error, the requests are handled by the server
+	const int fd = getStreamSocketFD(_clientID);
+	_pollClientFD = (fd != -1 && _poll.addFD(fd, EPOLLRDHUP)) ? fd : -1;
+}
+
+bool StreamThreadBase::startPipeline() {
+	if (!_threadDecrypt.startThread()) {
+		SI_LOG_ERROR("Frontend: @#1, Error Starting decrypt stage, not pipelining", _stream.getFeID());
+		return false;
+	}
+	if (!_threadSend.startThread()) {
+		SI_LOG_ERROR("Frontend: @#1, Error Starting send stage, not pipelining", _stream.getFeID());
+		_threadDecrypt.terminateThread();
+		return false;
+	}
+	_threadSend.setPriority(base::Thread::Priority::AboveNormal);
+	_threadDecrypt.setAffinity(_stream.getPipelineCPU(StreamInterface::PipelineStage::Decrypt));
+	_threadSend.setAffinity(_stream.getPipelineCPU(StreamInterface::PipelineStage::Send));
+	SI_LOG_INFO("Frontend: @#1, Pipelined @#2 stream (read, decrypt and send stage)",
+		_stream.getFeID(), _protocol);
+	return true;
+}
+
+void StreamThreadBase::resetBuffers(const int clientID) {
+	const size_t packets = _stream.getTSPacketsPerDatagram(clientID);
+	for (size_t i = 0; i < MAX_BUF; ++i) {
+		_tsBuffer[i].reset();
+		_tsBuffer[i].setNumberOfTSPackets(packets);
+	}
+	_writeIndex = 0;
+	_readIndex = 0;
+	_decryptIndex = 0;
+	_readyIndex = 0;
+	_batchPending = false;
+	_sharedCount = 0;
+	_consumerFlush = false;
+	_sendWakeUp = std::chrono::steady_clock::time_point::max();
+	_sendDeadline = std::chrono::steady_clock::now();
+}
+
+size_t StreamThreadBase::getAvailableBufferSize() const {
+	// Keep one buffer free, else a full ring looks the same as an empty one
+	return (MAX_BUF + _readIndex - _writeIndex - 1) % MAX_BUF;
+}
+
+void StreamThreadBase::decryptBuffer(mpegts::PacketBuffer &buffer) {
+#ifdef LIBDVBCSA
+	decrypt::dvbapi::SpClient decrypt = _stream.getDecryptDevice();
+	if (decrypt != nullptr) {
+		decrypt->decrypt(_stream.getFeIndex(), _stream.getFeID(), buffer);
+	}
+#else
+	(void)buffer;
+#endif
+}
+
+void StreamThreadBase::readTSPacketsIntoBuffer(input::Device &inputDevice, const bool finalCall) {
+	const bool ready = inputDevice.readTSPackets(_tsBuffer[_writeIndex], finalCall);
+	// The PAT or PMT of a selected service did change its PIDs
+	if (inputDevice.getFilter().hasServicePIDsChanged()) {
+		inputDevice.updatePIDFilters();
+	}
+	if (ready) {
+		// The decrypt stage will handle it when pipelined
+		if (!_pipelined) {
+			decryptBuffer(_tsBuffer[_writeIndex]);
+		}
+		// reset next, then goto next so the next stage can take this one
+		const size_t next = (_writeIndex + 1) % MAX_BUF;
+		_tsBuffer[next].reset();
+		_writeIndex = next;
+		if (_pipelined) {
+			_decryptEvent.notify();
+		}
+	}
+}
+
+bool StreamThreadBase::isBufferReadyToSend(const size_t offset) const {
+	if (_pipelined) {
+		return offset < (MAX_BUF + _readyIndex - _readIndex) % MAX_BUF;
+	}
+	// The owner only publishes complete buffers to the consumer
+	if (_consumer) {
+		return offset < (MAX_BUF + _writeIndex - _readIndex) % MAX_BUF;
+	}
+	// Shared buffers may be purged for the owner already, but they are ready
+	return offset < _sharedCount || _tsBuffer[(_readIndex + offset) % MAX_BUF].isReadyToSend();
+}
+
 void StreamThreadBase::readDataFromInputDevice(StreamClient &client) {
 	const input::SpDevice inputDevice = _stream.getInputDevice();
 
@@ -202,43 +460,265 @@ void StreamThreadBase::readDataFromInputDevice(StreamClient &client) {
 	const unsigned long interval = std::chrono::duration_cast<std::chrono::microseconds>(_t2 - _t1).count();
 	const bool intervalExeeded = interval > _sendInterval;
 
-	size_t availableSize = (MAX_BUF - (_writeIndex - _readIndex));
-	if (availableSize > MAX_BUF) {
-		availableSize %= MAX_BUF;
+//	SI_LOG_DEBUG("Frontend: @#1, PacketBuffer MAX @#2 W @#3 R @#4  S @#5", _stream.getFeID(), MAX_BUF, _writeIndex, _readIndex, getAvailableBufferSize());
+	if (inputDevice->isDataAvailable() && getAvailableBufferSize() >= 1) {
+		readTSPacketsIntoBuffer(*inputDevice, intervalExeeded);
 	}
-//	SI_LOG_DEBUG("Frontend: @#1, PacketBuffer MAX @#2 W @#3 R @#4  S @#5", _stream.getFeID(), MAX_BUF, _writeIndex, _readIndex, availableSize);
-	if (inputDevice->isDataAvailable() && availableSize >= 1) {
-		if (inputDevice->readTSPackets(_tsBuffer[_writeIndex], intervalExeeded)) {
-#ifdef LIBDVBCSA
-			decrypt::dvbapi::SpClient decrypt = _stream.getDecryptDevice();
-			if (decrypt != nullptr) {
-				decrypt->decrypt(_stream.getFeIndex(), _stream.getFeID(), _tsBuffer[_writeIndex]);
-			}
-#endif
-			// goto next, so inc write index
-			++_writeIndex;
-			_writeIndex %= MAX_BUF;
-			// reset next
-			_tsBuffer[_writeIndex].reset();
+	// The send stage takes it from here
+	if (_pipelined) {
+		if (intervalExeeded) {
+			_t1 = _t2;
 		}
+		return;
 	}
 
-	const bool readyToSend = _tsBuffer[_readIndex].isReadyToSend();
+	// Shared buffers may be purged for the owner already, but they are ready
+	const bool readyToSend = _sharedCount != 0 || _tsBuffer[_readIndex].isReadyToSend();
 	if (intervalExeeded || readyToSend) {
 		_t1 = _t2;
 		// Send the packet full or not, else send null packet
 		if (readyToSend) {
+			if (_sharedCount == 0 && _stream.hasConsumers()) {
+				_stream.shareWithConsumers(_tsBuffer[_readIndex]);
+				_sharedCount = 1;
+			}
 			if (writeDataToOutputDevice(_tsBuffer[_readIndex], client)) {
 				// inc read index only when send is successful
-				++_readIndex;
-				_readIndex %= MAX_BUF;
+				_readIndex = (_readIndex + 1) % MAX_BUF;
+				_sharedCount = 0;
 			}
 		} else if (_signalLock) {
 			writeDataToOutputDevice(_tsEmpty, client);
 		}
+		if (intervalExeeded && _stream.hasConsumers()) {
+			_stream.flushConsumers();
+		}
+	}
+}
+
+void StreamThreadBase::pollDataFromInputDevice(StreamClient &client, const int fd) {
+	// Register the input device again when it has an other fd, or when it
+	// was closed and opened again, which may give the same fd back
+	const input::SpDevice inputDevice = _stream.getInputDevice();
+	const uint32_t generation = inputDevice->getPollFDGeneration();
+	if (fd != _pollDeviceFD || generation != _pollDeviceGeneration) {
+		if (_pollDeviceArmed) {
+			_poll.removeFD(_pollDeviceFD);
+		}
+		_pollDeviceFD = fd;
+		_pollDeviceGeneration = generation;
+		_pollDeviceArmed = false;
+		_pollDeviceHangUp = false;
+	}
+
+	// Sleep until the device has data, the client hangs up, the pending batch
+	// should go or the deadline expired
+	int timeout = (_batchPending && !_pipelined) ?
+		sendReadyBuffers(client, false) : 2 * SEND_DEADLINE.count();
+	if (timeout < 0) {
+		timeout = 2 * SEND_DEADLINE.count();
+	}
+	// Only poll the device while there is a buffer to read into. The fd is
+	// level triggered, so with all buffers full it would wake up epoll_wait
+	// without anything being read
+	const bool arm = getAvailableBufferSize() >= 1 && !_pollDeviceHangUp;
+	if (arm && !_pollDeviceArmed) {
+		_pollDeviceArmed = _poll.addFD(fd, EPOLLIN);
+	} else if (!arm && _pollDeviceArmed) {
+		_poll.removeFD(fd);
+		_pollDeviceArmed = false;
+	}
+	// Do not sleep when the device still has data read ahead
+	if (inputDevice->hasBufferedData() && getAvailableBufferSize() >= 1) {
+		timeout = 0;
+	}
+	if (_poll.wait(timeout) < 0) {
+		return;
+	}
+
+	if (_pollClientFD != -1 && (_poll.getEvents(_pollClientFD) & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0) {
+		_poll.removeFD(_pollClientFD);
+		_pollClientFD = -1;
+		if (!client.isSelfDestructing()) {
+			SI_LOG_INFO("Frontend: @#1, @#2 connection of @#3 closed by peer", _stream.getFeID(),
+				_protocol, client.getIPAddressOfStream());
+			client.selfDestruct();
+		}
+		return;
+	}
+
+	const bool deadlineExpired = _poll.hasTimerExpired();
+	if (deadlineExpired) {
+		// Poll the device again after a hang up
+		_pollDeviceHangUp = false;
+	}
+
+	// Also read on an error, so the device can report/clear it (ex. DVR overflow)
+	const uint32_t events = _pollDeviceArmed ? _poll.getEvents(fd) : 0;
+	if ((events & (EPOLLIN | EPOLLERR)) != 0 || inputDevice->hasBufferedData()) {
+		if (getAvailableBufferSize() >= 1) {
+			readTSPacketsIntoBuffer(*inputDevice, deadlineExpired);
+		}
+		// Hand out the data the device did read ahead
+		while (inputDevice->hasBufferedData() && getAvailableBufferSize() >= 1) {
+			readTSPacketsIntoBuffer(*inputDevice, deadlineExpired);
+		}
+	} else if ((events & EPOLLHUP) != 0) {
+		// Writer is gone (ex. child pipe), so stop spinning on it and let
+		// the deadline add it again
+		_poll.removeFD(fd);
+		_pollDeviceArmed = false;
+		_pollDeviceHangUp = true;
+	}
+
+	// The send stage takes it from here
+	if (_pipelined) {
+		return;
+	}
+
+	sendReadyBuffers(client, deadlineExpired);
+
+	// Nothing send since the last deadline, so send null packet
+	if (deadlineExpired) {
+		if (_stream.hasConsumers()) {
+			_stream.flushConsumers();
+		}
+		if (!_dataSend && _signalLock) {
+			writeDataToOutputDevice(_tsEmpty, client);
+		}
+		_dataSend = false;
 	}
 }
 
+void StreamThreadBase::sendConsumerData(StreamClient &client) {
+	_sendWakeUp = std::chrono::steady_clock::time_point::max();
+	const int pending = sendReadyBuffers(client, _consumerFlush.exchange(false));
+	waitForReadyBuffers(pending, SEND_DEADLINE);
+}
+
+void StreamThreadBase::waitForReadyBuffers(const int pending, std::chrono::microseconds timeout) {
+	if (pending >= 0) {
+		timeout = std::min<std::chrono::microseconds>(timeout, std::chrono::milliseconds(pending));
+	}
+	// A paced output did not send all buffers yet, so come back in time
+	if (_sendWakeUp != std::chrono::steady_clock::time_point::max()) {
+		const auto wakeUp = std::chrono::duration_cast<std::chrono::microseconds>(
+			_sendWakeUp - std::chrono::steady_clock::now());
+		timeout = std::clamp(wakeUp, std::chrono::microseconds(0), timeout);
+	}
+	_sendEvent.wait(timeout);
+}
+
+int StreamThreadBase::sendReadyBuffers(StreamClient &client, const bool flush) {
+	const size_t batchSize = std::clamp<size_t>(_stream.getRtpBatchSize(), 1, MAX_BATCH_SIZE);
+	mpegts::PacketBuffer *batch[MAX_BATCH_SIZE];
+	for (;;) {
+		// Collect the buffers that are ready, but not more then one batch
+		size_t ready = 0;
+		while (ready < batchSize && isBufferReadyToSend(ready)) {
+			batch[ready] = &_tsBuffer[(_readIndex + ready) % MAX_BUF];
+			++ready;
+		}
+		if (ready == 0) {
+			_batchPending = false;
+			return -1;
+		}
+		// Hand every ready buffer once to the sessions sharing this transponder
+		if (!_consumer && _stream.hasConsumers()) {
+			for (; _sharedCount < ready; ++_sharedCount) {
+				_stream.shareWithConsumers(*batch[_sharedCount]);
+			}
+		}
+		const auto now = std::chrono::steady_clock::now();
+		if (!_batchPending) {
+			_batchPending = true;
+			_batchStart = now;
+		}
+		const long age = std::chrono::duration_cast<std::chrono::milliseconds>(now - _batchStart).count();
+		const long maxAge = _stream.getRtpBatchAge();
+		if (!flush && !isOutputPaced() && ready < batchSize && age < maxAge) {
+			return maxAge - age;
+		}
+		const size_t send = writeBatchToOutputDevice(batch, ready, client);
+		// inc read index only with the buffers that are send
+		_readIndex = (_readIndex + send) % MAX_BUF;
+		_sharedCount = (_sharedCount > send) ? _sharedCount - send : 0;
+		_batchPending = false;
+		if (send != 0) {
+			_dataSend = true;
+		}
+		if (send != ready) {
+			return -1;
+		}
+	}
+}
+
+bool StreamThreadBase::threadExecuteDecrypt() {
+	// Signal idle when not running, so the ring may be reset
+	_decryptIdle = false;
+	if (_state != State::Running) {
+		_decryptIdle = true;
+		_decryptEvent.wait(SEND_DEADLINE);
+		return true;
+	}
+	bool progress = false;
+	const size_t writeIndex = _writeIndex;
+	for (; _decryptIndex != writeIndex; _decryptIndex = (_decryptIndex + 1) % MAX_BUF) {
+		decryptBuffer(_tsBuffer[_decryptIndex]);
+		progress = true;
+	}
+	// Publish the buffers that are completely decrypted (batches may still be pending)
+	size_t readyIndex = _readyIndex;
+	while (readyIndex != _decryptIndex && _tsBuffer[readyIndex].isReadyToSend()) {
+		readyIndex = (readyIndex + 1) % MAX_BUF;
+	}
+	if (readyIndex != _readyIndex) {
+		_readyIndex = readyIndex;
+		_sendEvent.notify();
+	}
+	// Sleep until the read stage filled the next buffer
+	if (!progress) {
+		_decryptEvent.wait(SEND_DEADLINE);
+	}
+	return true;
+}
+
+bool StreamThreadBase::threadExecuteSend() {
+	// Signal idle when not running, so the ring may be reset
+	_sendIdle = false;
+	if (_state != State::Running) {
+		_sendIdle = true;
+		_sendEvent.wait(SEND_DEADLINE);
+		return true;
+	}
+	StreamClient &client = _stream.getStreamClient(_clientID);
+	const size_t readIndex = _readIndex;
+	const auto now = std::chrono::steady_clock::now();
+	const bool deadlineExpired = (now - _sendDeadline) >= SEND_DEADLINE;
+
+	_sendWakeUp = std::chrono::steady_clock::time_point::max();
+	const int pending = sendReadyBuffers(client, deadlineExpired);
+
+	// Nothing send since the last deadline, so send null packet
+	if (deadlineExpired) {
+		_sendDeadline = now;
+		if (_stream.hasConsumers()) {
+			_stream.flushConsumers();
+		}
+		if (!_dataSend && _signalLock) {
+			writeDataToOutputDevice(_tsEmpty, client);
+		}
+		_dataSend = false;
+	}
+	// Sleep until the decrypt stage published buffers or the next deadline
+	if (readIndex == _readIndex) {
+		const auto deadline = std::chrono::duration_cast<std::chrono::microseconds>(
+			_sendDeadline + SEND_DEADLINE - std::chrono::steady_clock::now());
+		waitForReadyBuffers(pending, std::max(deadline, std::chrono::microseconds(0)));
+	}
+	return true;
+}
+
 bool StreamThreadBase::threadExecuteDeviceMonitor() {
 	// check do we need to update Device monitor signals
 	_signalLock = _stream.getInputDevice()->monitorSignal(false);
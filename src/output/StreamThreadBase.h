@@ -22,14 +22,18 @@
 
 #include <FwDecl.h>
 #include <Unused.h>
+#include <base/Event.h>
+#include <base/EventPoll.h>
 #include <base/Thread.h>
 #include <base/ThreadBase.h>
 #include <mpegts/PacketBuffer.h>
+#include <output/RtpTimestamp.h>
 
 #include <atomic>
 #include <chrono>
 
 FW_DECL_NS0(StreamClient);
+FW_DECL_NS1(input, Device);
 FW_DECL_NS0(StreamInterface);
 
 FW_DECL_UP_NS1(output, StreamThreadBase);
@@ -63,6 +67,9 @@ class StreamThreadBase :
 		// =====================================================================
 	public:
 
+		/// The maximum amount of buffers that can be send as one batch
+		static constexpr size_t MAX_BATCH_SIZE = 64;
+
 		/// Start streaming
 		/// @param clientID specifies which client should start
 		/// @return true if stream is started else false on error
@@ -78,6 +85,21 @@ class StreamThreadBase :
 		/// @return true if stream is restarted else false on error
 		bool restartStreaming(int clientID);
 
+		/// Start streaming as consumer of a shared transponder, the owner of the
+		/// stream will hand over the data and this thread only sends it
+		/// @param clientID specifies which client should start
+		/// @return true if stream is started else false on error
+		bool startConsumer(int clientID);
+
+		/// Copy the TS packets this consumer selected, the consumer thread will
+		/// send them. So a slow consumer does not block the owner
+		/// @param buffer specifies the ready TS buffer of the owner
+		void writeConsumerData(const mpegts::PacketBuffer &buffer);
+
+		/// Let the consumer thread send the pending TS packets, the last buffer
+		/// is filled up with NULL packets
+		void flushConsumerData();
+
 	protected:
 
 		/// Send the TS packets to an output device
@@ -85,11 +107,39 @@ class StreamThreadBase :
 			mpegts::PacketBuffer &UNUSED(buffer),
 			StreamClient &UNUSED(client)) { return false; };
 
+		/// Send multiple TS packet buffers to an output device, the default
+		/// will send them one by one with @see writeDataToOutputDevice
+		/// @param buffers specifies the buffers to send
+		/// @param count specifies the amount of buffers (max MAX_BATCH_SIZE)
+		/// @return the amount of buffers that are handled
+		virtual size_t writeBatchToOutputDevice(
+			mpegts::PacketBuffer **buffers,
+			size_t count,
+			StreamClient &client);
+
+		/// Check if the output paces the buffers by itself, then the ready
+		/// buffers are handed over right away instead of after 'RTP Batch Age'
+		virtual bool isOutputPaced() const { return false; }
+
+		/// Let the poll loop wake up at this time, so a paced output that did
+		/// not send all buffers yet gets them again
+		void wakeUpAt(std::chrono::steady_clock::time_point time);
+
+		/// Get the RTP timestamp of this buffer, call it once for each buffer
+		/// in stream order. @see RtpTimestamp
+		long getRtpTimestamp(const mpegts::PacketBuffer &buffer);
+
 		/// Returns the socket port for the specified client
 		/// @param clientID specifies which client the port id requested
 		/// @return the socket port for ex. to data send to
 		virtual int getStreamSocketPort(int UNUSED(clientID)) const { return 0; }
 
+		/// Returns the connected socket of the specified client that should be
+		/// watched for a hangup, for ex. the HTTP or RTSP/TCP connection
+		/// @param clientID specifies which client the fd id requested
+		/// @return the socket fd or -1 if there is nothing to watch
+		virtual int getStreamSocketFD(int UNUSED(clientID)) const { return -1; }
+
 	private:
 
 		/// Specialization for @see startStreaming
@@ -105,10 +155,67 @@ class StreamThreadBase :
 		/// @param client specifies were it should be sended to
 		void readDataFromInputDevice(StreamClient &client);
 
+		/// This function will wait (epoll) until the input device has data or
+		/// the send deadline expired and then read and send the data
+		/// @param client specifies were it should be sended to
+		/// @param fd specifies the poll fd of the input device
+		void pollDataFromInputDevice(StreamClient &client, int fd);
+
+		/// This function will wait until the owner of the shared transponder
+		/// handed over buffers or the pending batch should go and then send them
+		/// @param client specifies were it should be sended to
+		void sendConsumerData(StreamClient &client);
+
+		/// Read the TS packets from the input device into the next free buffer
+		/// @param finalCall see @see input::Device::readTSPackets
+		void readTSPacketsIntoBuffer(input::Device &inputDevice, bool finalCall);
+
+		/// Get the amount of free buffers in the TS buffer ring
+		size_t getAvailableBufferSize() const;
+
+		/// Reset the TS buffer ring and size the buffers for the client
+		void resetBuffers(int clientID);
+
+		/// Decrypt the TS buffer when there is a decrypt device
+		void decryptBuffer(mpegts::PacketBuffer &buffer);
+
+		/// Check if the buffer at offset from the read index is ready to send
+		bool isBufferReadyToSend(size_t offset) const;
+
+		/// Send the buffers that are ready in batches of 'RTP Batch Size', or
+		/// all when they waited 'RTP Batch Age' or when flush is requested
+		/// @param client specifies were it should be sended to
+		/// @param flush specifies to send all ready buffers now
+		/// @return the time in ms until the pending batch should be send or
+		/// -1 if nothing is pending
+		int sendReadyBuffers(StreamClient &client, bool flush);
+
+		/// Sleep until the previous stage signals new buffers, the pending batch
+		/// should go, a paced output wants to send again or the timeout elapsed
+		/// @param pending specifies the time in ms until the pending batch
+		/// should be send or -1 if nothing is pending
+		/// @param timeout specifies the maximum time to sleep
+		void waitForReadyBuffers(int pending, std::chrono::microseconds timeout);
+
+		/// Register the client socket that should be watched for a hangup
+		void registerStreamSocketFD();
+
 		/// Thread execute function @see base::Thread should @return true to
 		/// keep thread running and @return false will stop and then terminate this thread
 		bool threadExecuteDeviceMonitor();
 
+		/// Start the decrypt and send stage of the pipelined streaming mode
+		/// @return true if the stages are started else false
+		bool startPipeline();
+
+		/// Thread execute function of the pipeline decrypt stage, it decrypts
+		/// the buffers the read stage filled and publishes the ready ones
+		bool threadExecuteDecrypt();
+
+		/// Thread execute function of the pipeline send stage, it sends the
+		/// buffers the decrypt stage published
+		bool threadExecuteSend();
+
 		// =====================================================================
 		// -- Data members -----------------------------------------------------
 		// =====================================================================
@@ -126,6 +233,7 @@ class StreamThreadBase :
 		std::atomic_bool _signalLock;
 		int _clientID;
 		uint16_t _cseq;
+		RtpTimestamp _rtpTimestamp;
 
 	private:
 
@@ -134,11 +242,40 @@ class StreamThreadBase :
 		static constexpr size_t MAX_BUF = 100;
 		mpegts::PacketBuffer _tsBuffer[MAX_BUF];
 		mpegts::PacketBuffer _tsEmpty;
-		size_t _writeIndex;
-		size_t _readIndex;
+		std::atomic<size_t> _writeIndex; /// read stage, buffer that is filled
+		std::atomic<size_t> _readIndex;  /// send stage, buffer to send next
 		unsigned long _sendInterval;
 		std::chrono::steady_clock::time_point _t1;
 		std::chrono::steady_clock::time_point _t2;
+
+		static constexpr std::chrono::milliseconds SEND_DEADLINE{50};
+		base::EventPoll _poll;
+		int _pollDeviceFD;
+		uint32_t _pollDeviceGeneration;
+		bool _pollDeviceArmed;   /// device fd is in the interest list of the poll
+		bool _pollDeviceHangUp;  /// device fd hung up, poll it again at the deadline
+		int _pollClientFD;
+		bool _dataSend;
+		bool _batchPending;
+		std::chrono::steady_clock::time_point _batchStart;
+		bool _consumer;
+		size_t _sharedCount;
+		std::atomic_bool _consumerFlush;
+
+		// Pipelined mode, the stages (read -> decrypt -> send) pass the buffers
+		// of the ring on by publishing their index, each index has one writer.
+		// The next stage is signaled, so an idle stage sleeps until there is work
+		bool _pipelined;
+		size_t _decryptIndex;            /// decrypt stage, buffer to decrypt next
+		std::atomic<size_t> _readyIndex; /// decrypt stage, buffers before it are ready
+		std::atomic_bool _decryptIdle;
+		std::atomic_bool _sendIdle;
+		base::Event _decryptEvent;
+		base::Event _sendEvent;           /// also signals the consumer thread
+		std::chrono::steady_clock::time_point _sendWakeUp;
+		std::chrono::steady_clock::time_point _sendDeadline;
+		base::Thread _threadDecrypt;
+		base::Thread _threadSend;
 };
 
 } // namespace output
@@ -67,6 +67,10 @@ void StreamThreadHttp::doStartStreaming(const int clientID) {
 //		client.setSocketTimeoutInSec(2);
 }
 
+int StreamThreadHttp::getStreamSocketFD(const int clientID) const {
+	return _stream.getStreamClient(clientID).getHttpSocketFD();
+}
+
 int StreamThreadHttp::getStreamSocketPort(const int clientID) const {
 	return _stream.getStreamClient(clientID).getHttpSocketPort();
 }
@@ -93,4 +97,28 @@ bool StreamThreadHttp::writeDataToOutputDevice(mpegts::PacketBuffer &buffer, Str
 	return true;
 }
 
+size_t StreamThreadHttp::writeBatchToOutputDevice(
+		mpegts::PacketBuffer **buffers, const size_t count, StreamClient &client) {
+	const long timestamp = base::TimeCounter::getTicks() * 90;
+	for (size_t i = 0; i < count; ++i) {
+		const size_t dataSize = buffers[i]->getCurrentBufferSize();
+
+		// RTP packet octet count (Bytes)
+		_stream.addRtpData(dataSize, timestamp);
+
+		_iov[i].iov_base = buffers[i]->getTSReadBufferPtr();
+		_iov[i].iov_len = dataSize;
+	}
+
+	// send all HTTP packets with one call
+	if (!client.writeHttpData(_iov, count)) {
+		if (!client.isSelfDestructing()) {
+			SI_LOG_ERROR("Frontend: @#1, Error sending HTTP Stream Data to @#2", _stream.getFeID(),
+				client.getIPAddressOfStream());
+			client.selfDestruct();
+		}
+	}
+	return count;
+}
+
 } // namespace output
@@ -23,6 +23,8 @@
 #include <FwDecl.h>
 #include <output/StreamThreadBase.h>
 
+#include <sys/uio.h>
+
 FW_DECL_NS0(StreamClient);
 FW_DECL_NS0(StreamInterface);
 
@@ -51,9 +53,18 @@ class StreamThreadHttp :
 			mpegts::PacketBuffer &buffer,
 			StreamClient &client) final;
 
+		/// @see StreamThreadBase
+		virtual size_t writeBatchToOutputDevice(
+			mpegts::PacketBuffer **buffers,
+			size_t count,
+			StreamClient &client) final;
+
 		/// @see StreamThreadBase
 		virtual int getStreamSocketPort(int clientID) const final;
 
+		/// @see StreamThreadBase
+		virtual int getStreamSocketFD(int clientID) const final;
+
 	private:
 
 		/// @see StreamThreadBase
@@ -64,6 +75,7 @@ class StreamThreadHttp :
 		// =====================================================================
 	private:
 
+		iovec _iov[MAX_BATCH_SIZE];
 };
 
 } // namespace output
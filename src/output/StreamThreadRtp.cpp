@@ -23,7 +23,10 @@
 #include <Log.h>
 #include <StreamInterface.h>
 #include <InterfaceAttr.h>
-#include <base/TimeCounter.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
 
 #include <sys/socket.h>
 
@@ -35,7 +38,10 @@ namespace output {
 
 StreamThreadRtp::StreamThreadRtp(StreamInterface &stream) :
 	StreamThreadBase("RTP/UDP", stream),
-	_rtcp(stream) {}
+	_rtcp(stream),
+	_gso(false),
+	_pacing(false),
+	_txTime(false) {}
 
 StreamThreadRtp::~StreamThreadRtp() {
 	terminateThread();
@@ -65,6 +71,23 @@ void StreamThreadRtp::doStartStreaming(const int clientID) {
 	SI_LOG_INFO("Frontend: @#1, @#2 set network buffer size: @#3 KBytes", id,
 		_protocol, bufferSize / 1024);
 
+	// UDP GSO, check the kernel knows UDP_SEGMENT
+	_gso = _stream.isRtpGSOEnabled();
+	if (_gso && !rtp.isUDPSegmentationSupported()) {
+		SI_LOG_INFO("Frontend: @#1, @#2 UDP GSO not supported by kernel, using sendmmsg", id, _protocol);
+		_gso = false;
+	}
+
+	// PCR pacing, with SO_TXTIME the kernel (ETF qdisc) sends at the launch time
+	_pacing = _stream.isRtpPacingEnabled();
+	_txTime = _pacing && _stream.isRtpTxTimeEnabled() && rtp.enableTxTime();
+	if (_pacing) {
+		SI_LOG_INFO("Frontend: @#1, @#2 pacing at the PCR bitrate using @#3", id, _protocol,
+			_txTime ? "SO_TXTIME" : "timer");
+	}
+	_pacer.reset();
+	_launchTime.clear();
+
 	// RTCP
 	_rtcp.startStreaming(clientID);
 }
@@ -75,17 +98,23 @@ void StreamThreadRtp::doPauseStreaming(const int clientID) {
 }
 
 void StreamThreadRtp::doRestartStreaming(const int clientID) {
+	_pacer.reset();
+	_launchTime.clear();
 	// RTCP
 	_rtcp.restartStreaming(clientID);
 }
 
+bool StreamThreadRtp::isOutputPaced() const {
+	return _pacing && !_txTime;
+}
+
 int StreamThreadRtp::getStreamSocketPort(const int clientID) const {
 	return  _stream.getStreamClient(clientID).getRtpSocketAttr().getSocketPort();
 }
 
 bool StreamThreadRtp::writeDataToOutputDevice(mpegts::PacketBuffer &buffer, StreamClient &client) {
 	// update sequence number and timestamp
-	const long timestamp = base::TimeCounter::getTicks() * 90;
+	const long timestamp = getRtpTimestamp(buffer);
 	++_cseq;
 	buffer.tagRTPHeaderWith(_cseq, timestamp);
 
@@ -98,6 +127,8 @@ bool StreamThreadRtp::writeDataToOutputDevice(mpegts::PacketBuffer &buffer, Stre
 	// send the RTP/UDP packet
 	const unsigned char *rtpBuffer = buffer.getReadBufferPtr();
 	SocketAttr &rtp = client.getRtpSocketAttr();
+	_stream.addRtpSendCall(1);
+	addSendStatistics(len, RtpPacer::Clock::now());
 	if (!rtp.sendDataTo(rtpBuffer, len, MSG_DONTWAIT)) {
 		if (!client.isSelfDestructing()) {
 			SI_LOG_ERROR("Frontend: @#1, Error sending RTP/UDP data to @#2:@#3",
@@ -108,4 +139,143 @@ bool StreamThreadRtp::writeDataToOutputDevice(mpegts::PacketBuffer &buffer, Stre
 	return true;
 }
 
+size_t StreamThreadRtp::writeBatchToOutputDevice(
+		mpegts::PacketBuffer **buffers, size_t count, StreamClient &client) {
+	const RtpPacer::Clock::time_point now = RtpPacer::Clock::now();
+	if (_pacing) {
+		// Schedule the buffers that are new, the others are already
+		for (size_t i = _launchTime.size(); i < count; ++i) {
+			_launchTime.push_back(_pacer.schedule(*buffers[i], now));
+		}
+		if (!_txTime) {
+			// Only send the buffers that are due and wake up for the next one
+			size_t due = 0;
+			while (due < count && _launchTime[due] <= now) {
+				++due;
+			}
+			if (due < count) {
+				wakeUpAt(_launchTime[due]);
+			}
+			count = due;
+			if (count == 0) {
+				return 0;
+			}
+		}
+	}
+	// With SO_TXTIME the launch time is on CLOCK_TAI
+	int64_t taiOffset = 0;
+	if (_txTime) {
+		timespec tai;
+		::clock_gettime(CLOCK_TAI, &tai);
+		taiOffset = (tai.tv_sec * INT64_C(1000000000)) + tai.tv_nsec -
+			std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+	}
+
+	// update sequence number and timestamp
+	for (size_t i = 0; i < count; ++i) {
+		mpegts::PacketBuffer &buffer = *buffers[i];
+		const long timestamp = getRtpTimestamp(buffer);
+		++_cseq;
+		buffer.tagRTPHeaderWith(_cseq, timestamp);
+
+		const size_t dataSize = buffer.getCurrentBufferSize();
+
+		// RTP packet octet count (Bytes)
+		_stream.addRtpData(dataSize, timestamp);
+
+		_iov[i].iov_base = buffer.getReadBufferPtr();
+		_iov[i].iov_len = dataSize + mpegts::PacketBuffer::RTP_HEADER_LEN;
+		std::memset(&_msgs[i], 0, sizeof(_msgs[i]));
+		_msgs[i].msg_hdr.msg_iov = &_iov[i];
+		_msgs[i].msg_hdr.msg_iovlen = 1;
+		if (_txTime) {
+			addLaunchTime(i, std::chrono::duration_cast<std::chrono::nanoseconds>(
+				(_launchTime[i] + TXTIME_LEAD).time_since_epoch()).count() + taiOffset);
+		}
+	}
+
+	// send the RTP/UDP packets
+	SocketAttr &rtp = client.getRtpSocketAttr();
+	size_t send = 0;
+	bool error = _gso && !_pacing && !sendSegmentedData(rtp, send, count);
+	while (!error && send < count) {
+		const int n = rtp.sendMessagesTo(&_msgs[send], count - send, MSG_DONTWAIT);
+		if (n <= 0) {
+			if (_txTime && errno == EINVAL) {
+				SI_LOG_INFO("Frontend: @#1, @#2 SO_TXTIME not accepted, pacing with timer",
+					_stream.getFeID(), _protocol);
+				_txTime = false;
+				for (size_t i = send; i < count; ++i) {
+					_msgs[i].msg_hdr.msg_control = nullptr;
+					_msgs[i].msg_hdr.msg_controllen = 0;
+				}
+				continue;
+			}
+			error = true;
+			break;
+		}
+		_stream.addRtpSendCall(n);
+		send += n;
+	}
+	if (error && !client.isSelfDestructing()) {
+		SI_LOG_ERROR("Frontend: @#1, Error sending RTP/UDP data to @#2:@#3",
+			_stream.getFeID(), rtp.getIPAddressOfSocket(), rtp.getSocketPort());
+		client.selfDestruct();
+	}
+	// With SO_TXTIME the packets leave at their launch time
+	for (size_t i = 0; i < count; ++i) {
+		addSendStatistics(_iov[i].iov_len,
+			(_pacing && _msgs[i].msg_hdr.msg_control != nullptr) ? _launchTime[i] : now);
+	}
+	if (_pacing) {
+		_launchTime.erase(_launchTime.begin(), _launchTime.begin() + count);
+	}
+	// Same as for one packet, the batch is handled also when the send failed
+	return count;
+}
+
+void StreamThreadRtp::addLaunchTime(const size_t i, const uint64_t txtime) {
+	msghdr &msg = _msgs[i].msg_hdr;
+	std::memset(_control[i], 0, sizeof(_control[i]));
+	msg.msg_control = _control[i];
+	msg.msg_controllen = sizeof(_control[i]);
+	cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_TXTIME;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(txtime));
+	std::memcpy(CMSG_DATA(cmsg), &txtime, sizeof(txtime));
+}
+
+void StreamThreadRtp::addSendStatistics(const size_t bytes, const RtpPacer::Clock::time_point time) {
+	if (_pacer.addSend(bytes, time)) {
+		_stream.setRtpPacingStats(_pacer.getBitrate(), _pacer.getBurstiness());
+	}
+}
+
+bool StreamThreadRtp::sendSegmentedData(SocketAttr &rtp, size_t &send, const size_t count) {
+	while (send < count) {
+		// All segments should have the same size, only the last one may be smaller
+		const size_t segmentSize = _iov[send].iov_len;
+		size_t n = 1;
+		while (send + n < count && n < MAX_GSO_SEGMENTS &&
+				(n + 1) * segmentSize <= MAX_GSO_SIZE &&
+				_iov[send + n - 1].iov_len == segmentSize &&
+				_iov[send + n].iov_len <= segmentSize) {
+			++n;
+		}
+		if (!rtp.sendSegmentedDataTo(&_iov[send], n, segmentSize, MSG_DONTWAIT)) {
+			if (errno == EIO || errno == ENOPROTOOPT) {
+				SI_LOG_INFO("Frontend: @#1, @#2 UDP GSO not supported by device, using sendmmsg",
+					_stream.getFeID(), _protocol);
+				_gso = false;
+				return true;
+			}
+			return false;
+		}
+		_stream.addRtpSendCall(n);
+		send += n;
+	}
+	return true;
+}
+
 } // namespace output
@@ -21,9 +21,17 @@
 #define OUTPUT_STREAMTHREADRTP_H_INCLUDE OUTPUT_STREAMTHREADRTP_H_INCLUDE
 
 #include <FwDecl.h>
+#include <output/RtpPacer.h>
 #include <output/StreamThreadBase.h>
 #include <output/StreamThreadRtcp.h>
 
+#include <cstdint>
+#include <deque>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+FW_DECL_NS0(SocketAttr);
 FW_DECL_NS0(StreamClient);
 FW_DECL_NS0(StreamInterface);
 
@@ -54,6 +62,15 @@ class StreamThreadRtp :
 			mpegts::PacketBuffer &buffer,
 			StreamClient &client) final;
 
+		/// @see StreamThreadBase
+		virtual size_t writeBatchToOutputDevice(
+			mpegts::PacketBuffer **buffers,
+			size_t count,
+			StreamClient &client) final;
+
+		/// @see StreamThreadBase
+		virtual bool isOutputPaced() const final;
+
 		/// @see StreamThreadBase
 		virtual int getStreamSocketPort(int clientID) const final;
 
@@ -68,12 +85,50 @@ class StreamThreadRtp :
 		/// @see StreamThreadBase
 		virtual void doRestartStreaming(int clientID) final;
 
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	private:
+
+		/// Send the iovecs as UDP GSO messages, stops when GSO is not
+		/// supported, so the remaining can be send otherwise
+		/// @param send specifies the amount of iovecs send, will be updated
+		/// @return false on an send error
+		bool sendSegmentedData(SocketAttr &rtp, size_t &send, size_t count);
+
+		/// Add the SO_TXTIME launch time to the message
+		/// @param i specifies the message to add it to
+		/// @param txtime specifies the launch time in ns of CLOCK_TAI
+		void addLaunchTime(size_t i, uint64_t txtime);
+
+		/// Account the send packet for the burstiness statistics
+		void addSendStatistics(size_t bytes, RtpPacer::Clock::time_point time);
+
 		// =====================================================================
 		// -- Data members -----------------------------------------------------
 		// =====================================================================
 	private:
 
+		/// UDP_MAX_SEGMENTS is 64 but 48 x 1328 still fits in one UDP message
+		static constexpr size_t MAX_GSO_SEGMENTS = 48;
+		/// Bigger (jumbo) RTP packets should also fit in one UDP message
+		static constexpr size_t MAX_GSO_SIZE = 65507;
+
+		/// The ETF qdisc drops packets with a launch time in the past, so
+		/// give the kernel some time to get it there
+		static constexpr std::chrono::microseconds TXTIME_LEAD{1000};
+
 		StreamThreadRtcp _rtcp;
+		bool _gso;
+		mmsghdr _msgs[MAX_BATCH_SIZE];
+		iovec _iov[MAX_BATCH_SIZE];
+		alignas(cmsghdr) char _control[MAX_BATCH_SIZE][CMSG_SPACE(sizeof(uint64_t))];
+
+		// PCR pacing, GSO is not used then as every packet has its own launch time
+		RtpPacer _pacer;
+		bool _pacing;
+		bool _txTime; /// SO_TXTIME, else the poll loop wakes up at the launch time
+		std::deque<RtpPacer::Clock::time_point> _launchTime; /// of the scheduled buffers
 
 };
 
@@ -23,7 +23,6 @@
 #include <Log.h>
 #include <StreamInterface.h>
 #include <InterfaceAttr.h>
-#include <base/TimeCounter.h>
 
 #include <sys/types.h>
 #include <sys/uio.h>
@@ -76,13 +75,17 @@ void StreamThreadRtpTcp::doRestartStreaming(const int clientID) {
 	_rtcp.restartStreaming(clientID);
 }
 
+int StreamThreadRtpTcp::getStreamSocketFD(const int clientID) const {
+	return _stream.getStreamClient(clientID).getHttpSocketFD();
+}
+
 int StreamThreadRtpTcp::getStreamSocketPort(const int clientID) const {
 	return  _stream.getStreamClient(clientID).getHttpSocketPort();
 }
 
 bool StreamThreadRtpTcp::writeDataToOutputDevice(mpegts::PacketBuffer &buffer, StreamClient &client) {
 	// update sequence number and timestamp
-	const long timestamp = base::TimeCounter::getTicks() * 90;
+	const long timestamp = getRtpTimestamp(buffer);
 	++_cseq;
 	buffer.tagRTPHeaderWith(_cseq, timestamp);
 
@@ -115,4 +118,41 @@ bool StreamThreadRtpTcp::writeDataToOutputDevice(mpegts::PacketBuffer &buffer, S
 	return true;
 }
 
+size_t StreamThreadRtpTcp::writeBatchToOutputDevice(
+		mpegts::PacketBuffer **buffers, const size_t count, StreamClient &client) {
+	// update sequence number and timestamp
+	for (size_t i = 0; i < count; ++i) {
+		mpegts::PacketBuffer &buffer = *buffers[i];
+		const long timestamp = getRtpTimestamp(buffer);
+		++_cseq;
+		buffer.tagRTPHeaderWith(_cseq, timestamp);
+
+		const size_t dataSize = buffer.getCurrentBufferSize();
+		const size_t len = dataSize + mpegts::PacketBuffer::RTP_HEADER_LEN;
+
+		// RTP packet octet count (Bytes)
+		_stream.addRtpData(dataSize, timestamp);
+
+		// Interleaved header and RTP packet
+		_header[i][0] = 0x24;
+		_header[i][1] = 0x00;
+		_header[i][2] = (len >> 8) & 0xFF;
+		_header[i][3] = (len >> 0) & 0xFF;
+		_iov[(i * 2) + 0].iov_base = _header[i];
+		_iov[(i * 2) + 0].iov_len = 4;
+		_iov[(i * 2) + 1].iov_base = buffer.getReadBufferPtr();
+		_iov[(i * 2) + 1].iov_len = len;
+	}
+
+	// send all RTP/TCP packets with one call
+	if (!client.writeHttpData(_iov, count * 2)) {
+		if (!client.isSelfDestructing()) {
+			SI_LOG_ERROR("Frontend: @#1, Error sending RTP/TCP Stream Data to @#2",
+				_stream.getFeID(), client.getIPAddressOfStream());
+			client.selfDestruct();
+		}
+	}
+	return count;
+}
+
 } // namespace output
@@ -24,6 +24,8 @@
 #include <output/StreamThreadBase.h>
 #include <output/StreamThreadRtcpTcp.h>
 
+#include <sys/uio.h>
+
 FW_DECL_NS0(StreamClient);
 FW_DECL_NS0(StreamInterface);
 
@@ -53,9 +55,18 @@ class StreamThreadRtpTcp :
 			mpegts::PacketBuffer &buffer,
 			StreamClient &client) final;
 
+		/// @see StreamThreadBase
+		virtual size_t writeBatchToOutputDevice(
+			mpegts::PacketBuffer **buffers,
+			size_t count,
+			StreamClient &client) final;
+
 		/// @see StreamThreadBase
 		virtual int getStreamSocketPort(int clientID) const final;
 
+		/// @see StreamThreadBase
+		virtual int getStreamSocketFD(int clientID) const final;
+
 	private:
 
 		/// @see StreamThreadBase
@@ -73,6 +84,8 @@ class StreamThreadRtpTcp :
 	private:
 
 		StreamThreadRtcpTcp _rtcp;
+		unsigned char _header[MAX_BATCH_SIZE][4];
+		iovec _iov[MAX_BATCH_SIZE * 2];
 };
 
 } // namespace output
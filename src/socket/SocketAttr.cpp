@@ -23,10 +23,16 @@
 #include <StringConverter.h>
 #include <socket/SocketClient.h>
 
+#include <algorithm>
 #include <string>
 #include <cstring>
+#include <ctime>
+
+#include <limits.h>
 
 #include <arpa/inet.h>
+#include <linux/net_tstamp.h>
+#include <netinet/udp.h>
 #include <sys/uio.h>
 #include <sys/socket.h>
 
@@ -169,12 +175,46 @@
 		return true;
 	}
 
-	bool SocketAttr::writeData(const iovec *iov, const int iovcnt) {
-		if (::writev(_fd, iov, iovcnt) == -1) {
-			if (errno != EBADF) {
-				SI_LOG_PERROR("writev");
+	bool SocketAttr::writeData(const iovec *iov, int iovcnt) {
+		while (iovcnt > 0) {
+			const ssize_t written = ::writev(_fd, iov, std::min(iovcnt, IOV_MAX));
+			if (written == -1) {
+				if (errno == EINTR) {
+					continue;
+				}
+				if (errno != EBADF) {
+					SI_LOG_PERROR("writev");
+				}
+				return false;
+			}
+			// Skip the iovecs that are written completely
+			std::size_t left = written;
+			while (iovcnt > 0 && left >= iov->iov_len) {
+				left -= iov->iov_len;
+				++iov;
+				--iovcnt;
+			}
+			// Partial write, so first finish this iovec before going on with the rest
+			if (left > 0) {
+				const char *ptr = static_cast<const char *>(iov->iov_base) + left;
+				std::size_t size = iov->iov_len - left;
+				while (size > 0) {
+					const ssize_t n = ::write(_fd, ptr, size);
+					if (n == -1) {
+						if (errno == EINTR) {
+							continue;
+						}
+						if (errno != EBADF) {
+							SI_LOG_PERROR("write");
+						}
+						return false;
+					}
+					ptr += n;
+					size -= n;
+				}
+				++iov;
+				--iovcnt;
 			}
-			return false;
 		}
 		return true;
 	}
@@ -188,6 +228,66 @@
 		return true;
 	}
 
+	int SocketAttr::sendMessagesTo(mmsghdr *msgs, const unsigned int vlen, const int flags) {
+		for (unsigned int i = 0; i < vlen; ++i) {
+			msgs[i].msg_hdr.msg_name = &_addr;
+			msgs[i].msg_hdr.msg_namelen = sizeof(_addr);
+		}
+		const int send = ::sendmmsg(_fd, msgs, vlen, flags);
+		if (send == -1) {
+			SI_LOG_PERROR("sendmmsg");
+		}
+		return send;
+	}
+
+	bool SocketAttr::sendSegmentedDataTo(const iovec *iov, const int iovcnt,
+			const uint16_t segmentSize, const int flags) {
+		char control[CMSG_SPACE(sizeof(segmentSize))];
+		std::memset(control, 0, sizeof(control));
+		msghdr msg;
+		std::memset(&msg, 0, sizeof(msg));
+		msg.msg_name = &_addr;
+		msg.msg_namelen = sizeof(_addr);
+		msg.msg_iov = const_cast<iovec *>(iov);
+		msg.msg_iovlen = iovcnt;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_UDP;
+		cmsg->cmsg_type = UDP_SEGMENT;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(segmentSize));
+		std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+
+		if (::sendmsg(_fd, &msg, flags) == -1) {
+			const int err = errno;
+			if (err != EIO && err != ENOPROTOOPT) {
+				SI_LOG_PERROR("sendmsg: UDP_SEGMENT");
+			}
+			errno = err;
+			return false;
+		}
+		return true;
+	}
+
+	bool SocketAttr::isUDPSegmentationSupported() const {
+		int val = 0;
+		socklen_t len = sizeof(val);
+		return ::getsockopt(_fd, SOL_UDP, UDP_SEGMENT, &val, &len) == 0;
+	}
+
+	bool SocketAttr::enableTxTime() {
+		sock_txtime txtime;
+		std::memset(&txtime, 0, sizeof(txtime));
+		txtime.clockid = CLOCK_TAI;
+		txtime.flags = 0;
+		if (::setsockopt(_fd, SOL_SOCKET, SO_TXTIME, &txtime, sizeof(txtime)) == -1) {
+			SI_LOG_PERROR("setsockopt: SO_TXTIME");
+			return false;
+		}
+		return true;
+	}
+
 	ssize_t SocketAttr::recvDatafrom(void *buf, std::size_t len, int flags) {
 		struct sockaddr_in si_other;
 		socklen_t addrlen = sizeof(si_other);
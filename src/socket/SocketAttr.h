@@ -25,6 +25,8 @@
 #include <string>
 #include <string_view>
 
+#include <cstdint>
+
 #include <netinet/in.h>
 
 FW_DECL_NS0(SocketClient);
@@ -73,7 +75,7 @@ class SocketAttr {
 			return _ipAddr;
 		}
 
-		///
+		/// Write all data of the iovecs, partial writes will be resumed
 		bool writeData(const struct iovec* iov, int iovcnt);
 
 		/// Use this function when the socket is in connected state
@@ -83,6 +85,29 @@ class SocketAttr {
 		/// connection-mode (SOCK_STREAM)
 		bool sendDataTo(const void* buf, std::size_t len, int flags);
 
+		/// Send multiple messages with one system call (sendmmsg) to the
+		/// address of this socket
+		/// @param msgs specifies the messages, msg_name will be set here
+		/// @param vlen specifies the amount of messages
+		/// @return the amount of messages send or -1 on error
+		int sendMessagesTo(struct mmsghdr *msgs, unsigned int vlen, int flags);
+
+		/// Send the data as one message that the kernel will split up in
+		/// datagrams of segmentSize (UDP GSO / UDP_SEGMENT)
+		/// @param iov specifies the data, all of segmentSize except the last one
+		/// @param segmentSize specifies the size of each datagram
+		/// @return true if send, else false with errno set. EIO or ENOPROTOOPT
+		/// means that the device or kernel has no support for it
+		bool sendSegmentedDataTo(const struct iovec *iov, int iovcnt, uint16_t segmentSize, int flags);
+
+		/// Check if the kernel supports UDP GSO (UDP_SEGMENT) for this Socket
+		bool isUDPSegmentationSupported() const;
+
+		/// Enable SO_TXTIME on this Socket, so each message can carry its
+		/// launch time as SCM_TXTIME (CLOCK_TAI) for the ETF qdisc
+		/// @return true if the kernel accepted it
+		bool enableTxTime();
+
 		/// Get the port of this Socket
 		int getSocketPort() const;
 